@@ -5,8 +5,19 @@
 #include "loader.h"
 #include "ui.h"
 #include "renderer.h"
+#include "silhouette.h"
+#include "debugview.h"
+#include "pointsplat.h"
+#include "viewports.h"
+#include "geomkernels.h"
+#include "embeddedmodel.h"
+#include "threadpool.h"
 #include "globals.h"
 #include "usersettings.h"
+#include "texturecache.h"
+#include "inspector.h"
+#include "inputsession.h"
+#include "glcapture.h"
 
 #include "imgui.h"
 
@@ -24,6 +35,9 @@
 #include <unordered_set>
 #include <algorithm>
 #include <cstddef>
+#include <cstdlib>
+#include <chrono>
+#include <iomanip>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -32,8 +46,13 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+// S3TC enums (EXT_texture_compression_s3tc), in case the GL loader was generated without it
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
 
 #ifdef _WIN32
   #ifndef NOMINMAX
@@ -51,48 +70,31 @@
   #include <GLFW/glfw3native.h>
 #endif
 
-static std::vector<unsigned int> build_edge_list(const std::vector<unsigned int>& triIndices) {
-    struct Edge { unsigned int a, b; };
-    struct EdgeHash {
-        size_t operator()(Edge const& e) const noexcept {
-            return (static_cast<size_t>(e.a) << 32) ^ static_cast<size_t>(e.b);
-        }
-    };
-    struct EdgeEq { bool operator()(Edge const& x, Edge const& y) const noexcept { return x.a == y.a && x.b == y.b; } };
-
-    auto make_key = [](unsigned int i1, unsigned int i2) -> Edge {
-        if (i1 < i2) return Edge{ i1, i2 };
-        return Edge{ i2, i1 };
-    };
-
-    std::unordered_set<Edge, EdgeHash, EdgeEq> edges;
-    edges.reserve(triIndices.size() / 2);
-
-    for (size_t i = 0; i + 2 < triIndices.size(); i += 3) {
-        unsigned int i0 = triIndices[i + 0];
-        unsigned int i1 = triIndices[i + 1];
-        unsigned int i2 = triIndices[i + 2];
-        edges.insert(make_key(i0, i1));
-        edges.insert(make_key(i1, i2));
-        edges.insert(make_key(i2, i0));
-    }
-
-    std::vector<unsigned int> lineIdx;
-    lineIdx.reserve(edges.size() * 2);
-    for (const auto &e : edges) {
-        lineIdx.push_back(e.a);
-        lineIdx.push_back(e.b);
-    }
-    return lineIdx;
-}
-
 // -------------------- Impl (PIMPL styule) -------------
 struct App::Impl {
     int argc;
     char** argv;
     GLFWwindow* window = nullptr;
 
+    // command line: [model] [--record <file>] [--replay <file> [--fixed-step <ms>] [--replay-stats <csv>]]
+    //               [--gl-capture <file> [--gl-capture-frames <first>[:<count>]]]
+    std::string modelPath;
+    std::string recordPath, replayPath, replayStatsPath;
+    double fixedStepMs = 0.0;
+    InputSession input;
+    std::string glCapturePath;
+    uint32_t glCaptureFirst = 0, glCaptureCount = 0; // none: F12 captures the next frame
+    GlCapture glCapture;
+    std::string exeDir; // icon, settings and cache location; empty = working directory
+
     Renderer renderer;
+    SilhouetteRenderer silhouettes;
+    DebugViewRenderer debugViews;
+    PointCloudRenderer pointClouds;
+    SceneTarget sceneTarget; // MSAA, resolved before the UI draws
+    ViewLayout views;        // single or quad view, cached copies of the quad views not redrawn
+    uint64_t sceneVersion = 0; // bumped whenever model GPU data changes, part of the views' key
+    uint64_t frameCount = 0;
 
     // model GPU handles
     GLuint model_vao = 0;
@@ -105,6 +107,15 @@ struct App::Impl {
     // line overlay handles (explicit edge
     GLuint model_lines_ebo = 0;
     size_t model_lines_count = 0;
+    size_t model_feature_lines_count = 0; // leading part of the line EBO
+
+    // material textures and per-material draw ranges of model_ebo
+    std::vector<GLuint> model_textures;
+    std::vector<DrawBatch> model_batches;
+    std::vector<TextureImage> modelTextureImages; // CPU copies, re-uploaded when the VRAM budget changes
+    ModelStats modelStats;
+    bool modelFlatShaded = false;
+    std::future<MeshInspection> pendingInspection; // mesh metrics of the current model, on the pool
 
     // lighting & view state (owned by app)
     glm::vec3 lightDir = glm::normalize(glm::vec3(1.0f, 1.0f, 0.5f));
@@ -119,34 +130,65 @@ struct App::Impl {
     glm::vec3 target = glm::vec3(0.0f);
     CameraState camState;
 
-    Loader loader;
+    MainExecutor mainExecutor;     // coroutines resumed by the frame loop
+    Loader loader{ mainExecutor };  // declared after the executor it drains on shutdown
 
     UserSettings userSettings;
 
-    std::future<void> importLoaderFuture;
-    std::shared_ptr<std::vector<glm::vec3>> import_positions_ptr;
-    std::shared_ptr<std::vector<glm::vec3>> import_normals_ptr;
-    std::shared_ptr<std::vector<unsigned int>> import_indices_ptr;
-    std::shared_ptr<std::atomic<bool>> import_ready;
-    std::shared_ptr<std::atomic<bool>> import_failed;
-    std::shared_ptr<std::atomic<float>> import_progress;
+    // loader QoS: smoothed main-thread time per frame (swap excluded) drives the throttle
+    double frameStart = 0.0;
+    double frameWorkMs = 0.0;
+    int overBudgetFrames = 0, underBudgetFrames = 0;
+
+    // performance settings as last applied, see applyPerformanceSettings
+    bool s3tcSupported = false;
+    int appliedSwapInterval = -1;
+    int appliedVramBudgetMB = 0;
+    float appliedLodBias = 0.0f;
+    int appliedCacheMaxMB = -1;
+    GLsync frameFence = nullptr; // low latency mode: end of the previous frame
+    int idleFrames = 0;          // render on demand: frames drawn since the last input
+
+    // startup profile: ms per step since the previous mark, first mark measured from Impl creation
+    std::chrono::steady_clock::time_point startupLast = std::chrono::steady_clock::now();
+    std::vector<std::pair<const char*, double>> startupSteps;
 
     // state flags
     bool modelUploaded = false;
     bool showWireframe = false;
+    DebugView debugView = DebugView::Off;
     bool prevEPressed = false;
-
-    Impl(int a, char** v): argc(a), argv(v) {}
+    bool prevF12Pressed = false;
+
+    Impl(int a, char** v): argc(a), argv(v) {
+        loader.setHandler([this](LoadResult& result) { onLoadResult(result); });
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (arg == "--record" && hasValue) recordPath = argv[++i];
+            else if (arg == "--replay" && hasValue) replayPath = argv[++i];
+            else if (arg == "--replay-stats" && hasValue) replayStatsPath = argv[++i];
+            else if (arg == "--fixed-step" && hasValue) fixedStepMs = std::atof(argv[++i]);
+            else if (arg == "--gl-capture" && hasValue) glCapturePath = argv[++i];
+            else if (arg == "--gl-capture-frames" && hasValue) {
+                const std::string frames = argv[++i];
+                const size_t colon = frames.find(':');
+                glCaptureFirst = (uint32_t)std::strtoul(frames.c_str(), nullptr, 10);
+                glCaptureCount = colon == std::string::npos ? 1u : (uint32_t)std::strtoul(frames.c_str() + colon + 1, nullptr, 10);
+            }
+            else if (modelPath.empty() && arg.rfind("--", 0) != 0) modelPath = arg;
+            else std::cerr << "ignoring argument " << arg << "\n";
+        }
+    }
     ~Impl() {}
 
     bool initWindowAndGL() {
         if (!glfwInit()) return false;
         glfwWindowHint(GLFW_MAXIMIZED, GLFW_TRUE);
-        glfwWindowHint(GLFW_SAMPLES, 16);
+        glfwWindowHint(GLFW_SAMPLES, 0); // MSAA lives in the SceneTarget so it can change at runtime
         window = glfwCreateWindow(1280, 720, "Splender 0.4.7", nullptr, nullptr);
         if (!window) { glfwTerminate(); return false; }
 
-        std::string exeDir;
 #if defined(_WIN32)
         // Try to load a Windows .ico file named "splender_logo.ico" in the exe directory.
         {
@@ -168,28 +210,17 @@ struct App::Impl {
         // non-windows png
 #endif
 
-        // NEW: user settings file near exe
-        std::filesystem::path settingsPath = std::filesystem::path(exeDir) / "usersettings.json";
-        userSettings.filePath = settingsPath.string();
-        userSettings.load(); // if missing, defaults remain
-
         glfwMaximizeWindow(window);
         glfwMakeContextCurrent(window);
-        glfwSwapInterval(1);
 
         if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) { std::cerr << "glad init failed\n"; return false; }
+        if (!glCapturePath.empty()) startGlCapture();
         glEnable(GL_MULTISAMPLE);
         glEnable(GL_SAMPLE_ALPHA_TO_COVERAGE);
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         glEnable(GL_DEPTH_TEST);
 
-        const char* glsl_version = "#version 330";
-        if (!Ui_Init(window, glsl_version)) {
-            std::cerr << "Ui_Init failed\n";
-            return false;
-        }
-
         // camera state
         camState.distance = &distance;
         camState.minDistance = 0.5f;
@@ -209,182 +240,519 @@ struct App::Impl {
         return true;
     }
 
+    // from the first GL call on, so the capture holds every object its frames use
+    void startGlCapture() {
+        int w = 0, h = 0;
+        glfwGetFramebufferSize(window, &w, &h);
+        if (!glCapture.start(glCapturePath, w, h)) return;
+        if (glCaptureCount > 0) glCapture.captureFrames(glCaptureFirst, glCaptureCount);
+        else std::cout << "gl-capture: press F12 to capture a frame\n";
+    }
+
+    // user settings file near exe; startup runs this on a worker while the window comes up
+    void loadSettings() {
+        std::filesystem::path settingsPath = std::filesystem::path(exeDir) / "usersettings.json";
+        userSettings.filePath = settingsPath.string();
+        userSettings.load(); // if missing, defaults remain
+    }
+
+    // cache location, needs the GL context (BC textures only help with S3TC)
+    void initTextureCacheDir() {
+        s3tcSupported = hasS3TC();
+        updateTextureCacheDir();
+    }
+
+    void updateTextureCacheDir() {
+        if (!s3tcSupported) userSettings.textureCacheDir.clear();
+        else if (!userSettings.textureCacheOverride.empty()) userSettings.textureCacheDir = userSettings.textureCacheOverride;
+        else userSettings.textureCacheDir = (std::filesystem::path(exeDir) / "cache" / "textures").string();
+    }
+
+    void trimTextureCache() {
+        appliedCacheMaxMB = userSettings.textureCacheMaxMB;
+        if (appliedCacheMaxMB > 0) texture_cache_trim_async(userSettings.textureCacheDir, (uint64_t)appliedCacheMaxMB << 20);
+    }
+
+    // time-to-first-frame breakdown, shown in the stats panel after the first swap
+    void markStartup(const char* step) {
+        const auto now = std::chrono::steady_clock::now();
+        startupSteps.emplace_back(step, std::chrono::duration<double, std::milli>(now - startupLast).count());
+        startupLast = now;
+    }
+
+    void reportStartup() {
+        double total = 0.0;
+        std::ostringstream steps;
+        for (size_t i = 0; i < startupSteps.size(); ++i) {
+            total += startupSteps[i].second;
+            steps << (i ? ", " : "") << startupSteps[i].first << " " << std::fixed << std::setprecision(1) << startupSteps[i].second;
+        }
+        std::ostringstream report;
+        report << "first frame after " << std::fixed << std::setprecision(1) << total << " ms (" << steps.str() << ")";
+        modelStats.startup = report.str();
+        startupSteps.clear();
+    }
+
+    // BC textures from the cache are only usable when the driver exposes S3TC
+    static bool hasS3TC() {
+        GLint n = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &n);
+        for (GLint i = 0; i < n; ++i) {
+            const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+            if (ext && std::string(ext) == "GL_EXT_texture_compression_s3tc") return true;
+        }
+        return false;
+    }
+
     bool compileBuiltinPrograms() {
         if (!renderer.createBuiltinPrograms()) return false;
+        if (!silhouettes.init()) std::cerr << "silhouette pass unavailable\n";
+        if (!debugViews.init()) std::cerr << "debug views unavailable\n";
+        if (!pointClouds.init()) std::cerr << "point cloud splats unavailable\n";
         return true;
     }
 
-    void startInitialLoad(const std::string& model_path) {
+    // startup load and imports (menu or App::requestImport) all go through the loader service
+    void requestLoad(const std::string& path) {
         isLoading.store(true);
-        loader.startInitialLoad(model_path);
+        loader.request(path, userSettings.loadOptions());
     }
 
-    void requestImportAsync(const std::string& path) {
-        loader.requestImportAsync(path);
-        isLoading.store(true);
+    // user imports (File > Import, App::requestImport) are recorded as UI actions
+    void importModel(const std::string& path) {
+        input.recordImport(path);
+        requestLoad(path);
     }
 
-    // Called each frame on main thread to swap in import when ready
-    void maybeFinishImport() {
-        // First prefer the Loader-managed completion path
-        if (loader.maybeFinishImport()) {
-            // delete old GL buffers
-            if (model_ebo) { glDeleteBuffers(1, &model_ebo); model_ebo = 0; }
-            if (model_vbo) { glDeleteBuffers(1, &model_vbo); model_vbo = 0; }
-            if (model_vao) { glDeleteVertexArrays(1, &model_vao); model_vao = 0; }
-            if (model_lines_ebo) { glDeleteBuffers(1, &model_lines_ebo); model_lines_ebo = 0; model_lines_count = 0; }
+    void releaseModelGpu() {
+        if (model_ebo) { glDeleteBuffers(1, &model_ebo); model_ebo = 0; }
+        if (model_vbo) { glDeleteBuffers(1, &model_vbo); model_vbo = 0; }
+        if (model_vao) { glDeleteVertexArrays(1, &model_vao); model_vao = 0; }
+        if (model_lines_ebo) { glDeleteBuffers(1, &model_lines_ebo); model_lines_ebo = 0; model_lines_count = 0; model_feature_lines_count = 0; }
+        if (!model_textures.empty()) {
+            glDeleteTextures((GLsizei)model_textures.size(), model_textures.data());
+            model_textures.clear();
+        }
+        model_batches.clear();
+        ++sceneVersion;
+        silhouettes.release();
+        debugViews.release();
+        pointClouds.release();
+    }
 
-            modelUploaded = false;
-            // loader will populate its positions()/normals()/indices(), upload happens in uploadModelIfReady()
-            return;
+    // VAO over one interleaved VBO (pos/normal/uv with stride 8, pos/uv with stride 5) and the
+    // triangle EBO, plus the GL_LINES EBO for the wireframe with feature edges first
+    void uploadGeometry(const float* verts, size_t vertexCount, size_t stride,
+                        const unsigned int* indices, size_t indexCount,
+                        const unsigned int* lineIndices, size_t lineCount, size_t featureLineCount) {
+        const bool hasNormals = stride == 8;
+        glGenVertexArrays(1, &model_vao);
+        glGenBuffers(1, &model_vbo);
+        glGenBuffers(1, &model_ebo);
+
+        glBindVertexArray(model_vao);
+        glBindBuffer(GL_ARRAY_BUFFER, model_vbo);
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * stride * sizeof(float), verts, GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+        const GLsizei strideBytes = (GLsizei)(stride * sizeof(float));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, strideBytes, (void*)0);
+        if (hasNormals) {
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, strideBytes, (void*)(3 * sizeof(float)));
+        } else {
+            glDisableVertexAttribArray(1);
         }
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, strideBytes, (void*)((stride - 2) * sizeof(float)));
+        glBindVertexArray(0);
+
+        model_index_count = indexCount;
+        currentVertexCount = vertexCount;
+        modelFlatShaded = !hasNormals;
+
+        // line EBO for the wireframe overlay
+        if (lineCount > 0) {
+            glBindVertexArray(model_vao); // element array binds to VAO
+            glGenBuffers(1, &model_lines_ebo);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_lines_ebo);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, lineCount * sizeof(unsigned int), lineIndices, GL_STATIC_DRAW);
+            model_lines_count = lineCount;
+            model_feature_lines_count = featureLineCount;
+            // restore triangle EBO as VAO element array
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_ebo);
+            glBindVertexArray(0);
+        } else {
+            model_lines_count = 0;
+            model_feature_lines_count = 0;
+        }
+        debugViews.setModel(model_vbo, model_ebo, model_lines_ebo, stride, indexCount, model_lines_count);
+    }
+
+    // upload a finished load: interleaved pos/normal/uv VBO (pos/uv for flat meshes),
+    // material-sorted EBO, textures (moved out of the mesh), edge EBO
+    void uploadMesh(MeshData& mesh) {
+        releaseModelGpu();
 
-        if (import_ready && import_ready->load()) {
-            // If import failed, log and clear state
-            if (import_failed && import_failed->load()) {
-                std::cerr << "Import (UI-initiated) failed to parse\n";
-                // clear import state
-                import_ready.reset(); import_failed.reset(); import_progress.reset();
-                import_positions_ptr.reset(); import_normals_ptr.reset(); import_indices_ptr.reset();
-                isLoading.store(false);
-                return;
+        const bool hasUV = mesh.texcoords.size() == mesh.positions.size();
+        const bool hasNormals = !mesh.flatShaded && mesh.normals.size() == mesh.positions.size();
+        const size_t stride = hasNormals ? 8 : 5;
+        std::vector<float> verts(mesh.positions.size() * stride);
+        {
+            std::vector<VertexStream> streams;
+            streams.push_back(VertexStream{ mesh.positions.empty() ? nullptr : &mesh.positions[0].x, 3 });
+            if (hasNormals) streams.push_back(VertexStream{ &mesh.normals[0].x, 3 });
+            streams.push_back(VertexStream{ hasUV && !mesh.texcoords.empty() ? &mesh.texcoords[0].x : nullptr, 2 });
+            geom_interleave(streams.data(), streams.size(), mesh.positions.size(), verts.data());
+        }
+
+        uploadGeometry(verts.data(), mesh.positions.size(), stride, mesh.indices.data(), mesh.indices.size(),
+                       mesh.edgeLines.data(), mesh.edgeLines.size(), mesh.featureLineCount);
+
+        std::string startup = std::move(modelStats.startup); // per run, not per model
+        modelStats = ModelStats{};
+        modelStats.startup = std::move(startup);
+        modelStats.vertexCount = mesh.positions.size();
+        modelStats.triCount = mesh.indices.size() / 3;
+        modelStats.batchCount = mesh.batches.size();
+        modelStats.textureCount = mesh.textures.size();
+        for (const auto& t : mesh.textures) modelStats.textureBytes += t.byteSize();
+        modelStats.atlas = mesh.atlasReport;
+        modelStats.textureCache = mesh.cacheReport;
+        modelStats.flat = mesh.flatReport;
+        modelStats.weld = mesh.weldReport;
+        modelStats.cleanup = mesh.cleanupReport;
+        modelStats.orient = mesh.orientReport;
+        modelStats.topology = mesh.topologyReport;
+        modelStats.timings = mesh.timings;
+        modelStats.vertexBytes = verts.size() * sizeof(float);
+
+        modelTextureImages = std::move(mesh.textures);
+        uploadTextures();
+
+        for (const MaterialBatch& b : mesh.batches) {
+            DrawBatch db;
+            if (b.materialIndex < mesh.materials.size()) {
+                const Material& m = mesh.materials[b.materialIndex];
+                db.baseColor = m.diffuse;
+                db.opacity = m.opacity;
+                if (m.textureIndex >= 0 && (size_t)m.textureIndex < model_textures.size()) db.texture = model_textures[m.textureIndex];
             }
+            db.firstIndex = b.firstIndex;
+            db.indexCount = (GLsizei)b.indexCount;
+            db.cullBackfaces = b.cullBackfaces;
+            model_batches.push_back(db);
+        }
+        if (model_batches.empty() && model_index_count > 0) {
+            DrawBatch db;
+            db.indexCount = (GLsizei)model_index_count;
+            model_batches.push_back(db);
+        }
+        compute_batch_bounds(verts.data(), stride, mesh.indices.data(), model_batches);
 
-            // Ensure we have imported buffers
-            if (!import_positions_ptr || !import_normals_ptr || !import_indices_ptr) {
-                std::cerr << "Import (UI-initiated) signalled ready but buffers are missing\n";
-                import_ready.reset(); import_failed.reset(); import_progress.reset();
-                import_positions_ptr.reset(); import_normals_ptr.reset(); import_indices_ptr.reset();
-                isLoading.store(false);
-                return;
+        silhouettes.upload(model_vbo, stride, mesh.silhouetteEdges);
+        modelStats.silhouetteEdges = silhouettes.edgeCount();
+    }
+
+    // Number of top mip levels every texture drops so the set fits in budget bytes: the smallest
+    // count that fits, a texture never drops its last level.
+    static size_t mipsToSkip(const std::vector<TextureImage>& textures, uint64_t budget) {
+        size_t maxLevels = 0;
+        for (const TextureImage& img : textures) maxLevels = std::max(maxLevels, img.mips.size());
+        for (size_t skip = 0; skip < maxLevels; ++skip) {
+            uint64_t total = 0;
+            for (const TextureImage& img : textures) {
+                for (size_t level = std::min(skip, img.mips.size() - 1); level < img.mips.size(); ++level) total += img.mips[level].size();
             }
+            if (total <= budget) return skip;
+        }
+        return maxLevels ? maxLevels - 1 : 0;
+    }
 
-            // Delete old GL buffers
-            if (model_ebo) { glDeleteBuffers(1, &model_ebo); model_ebo = 0; }
-            if (model_vbo) { glDeleteBuffers(1, &model_vbo); model_vbo = 0; }
-            if (model_vao) { glDeleteVertexArrays(1, &model_vao); model_vao = 0; }
-            if (model_lines_ebo) { glDeleteBuffers(1, &model_lines_ebo); model_lines_ebo = 0; model_lines_count = 0; }
-
-            // Build interleaved vertex array from import_ pointers
-            std::vector<float> verts; verts.reserve(import_positions_ptr->size() * 6);
-            for (size_t i = 0; i < import_positions_ptr->size(); ++i) {
-                verts.push_back((*import_positions_ptr)[i].x);
-                verts.push_back((*import_positions_ptr)[i].y);
-                verts.push_back((*import_positions_ptr)[i].z);
-                verts.push_back((*import_normals_ptr)[i].x);
-                verts.push_back((*import_normals_ptr)[i].y);
-                verts.push_back((*import_normals_ptr)[i].z);
+    // (re)create the GL textures from modelTextureImages; mips come prebuilt from the loader
+    // threads. Batches sampling the previous textures are pointed at the new ones.
+    void uploadTextures() {
+        std::vector<GLuint> old = std::move(model_textures);
+        model_textures.assign(modelTextureImages.size(), 0);
+        if (!model_textures.empty()) glGenTextures((GLsizei)model_textures.size(), model_textures.data());
+
+        const size_t skip = userSettings.vramBudgetMB > 0 ? mipsToSkip(modelTextureImages, (uint64_t)userSettings.vramBudgetMB << 20) : 0;
+        size_t gpuBytes = 0;
+        for (size_t t = 0; t < modelTextureImages.size(); ++t) {
+            const TextureImage& img = modelTextureImages[t];
+            glBindTexture(GL_TEXTURE_2D, model_textures[t]);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            const size_t first = img.mips.empty() ? 0 : std::min(skip, img.mips.size() - 1);
+            int w = std::max(1, img.width >> first), h = std::max(1, img.height >> first);
+            for (size_t level = first; level < img.mips.size(); ++level) {
+                const GLint glLevel = (GLint)(level - first);
+                if (img.format == TextureFormat::RGBA8) {
+                    glTexImage2D(GL_TEXTURE_2D, glLevel, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, img.mips[level].data());
+                } else {
+                    GLenum fmt = (img.format == TextureFormat::BC3) ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+                    glCompressedTexImage2D(GL_TEXTURE_2D, glLevel, fmt, w, h, 0, (GLsizei)img.mips[level].size(), img.mips[level].data());
+                }
+                gpuBytes += img.mips[level].size();
+                w = std::max(1, w / 2); h = std::max(1, h / 2);
             }
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)(img.mips.empty() ? 0 : img.mips.size() - 1 - first));
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_LOD_BIAS, userSettings.textureLodBias);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
 
-            // Create GL objects and upload
-            glGenVertexArrays(1, &model_vao);
-            glGenBuffers(1, &model_vbo);
-            glGenBuffers(1, &model_ebo);
+        for (DrawBatch& b : model_batches) {
+            for (size_t t = 0; t < old.size(); ++t) {
+                if (b.texture == old[t]) { b.texture = model_textures[t]; break; }
+            }
+        }
+        if (!old.empty()) glDeleteTextures((GLsizei)old.size(), old.data());
+        ++sceneVersion;
 
-            glBindVertexArray(model_vao);
-            glBindBuffer(GL_ARRAY_BUFFER, model_vbo);
-            glBufferData(GL_ARRAY_BUFFER, verts.size() * sizeof(float), verts.data(), GL_STATIC_DRAW);
+        modelStats.textureGpuBytes = gpuBytes;
+        modelStats.textureMipsSkipped = modelTextureImages.empty() ? 0 : skip;
+        appliedVramBudgetMB = userSettings.vramBudgetMB;
+        appliedLodBias = userSettings.textureLodBias;
+    }
 
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_ebo);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, import_indices_ptr->size() * sizeof(unsigned int), import_indices_ptr->data(), GL_STATIC_DRAW);
+    // the baked default model: no file I/O or parsing, so it is on screen from the first frame
+    void uploadEmbedded(const EmbeddedModel& m) {
+        releaseModelGpu();
+        modelTextureImages.clear();
+        if (m.vertexCount == 0) return;
+        uploadGeometry(m.vertices, m.vertexCount, m.stride, m.indices, m.indexCount,
+                       m.edgeLines, m.edgeLineCount, m.featureLineCount);
+
+        modelStats = ModelStats{};
+        pendingInspection = {}; // the baked model has no MeshData to inspect
+        modelStats.vertexCount = m.vertexCount;
+        modelStats.triCount = m.indexCount / 3;
+        modelStats.batchCount = m.batchCount;
+        modelStats.vertexBytes = m.vertexCount * m.stride * sizeof(float);
+
+        for (size_t i = 0; i < m.batchCount; ++i) {
+            const EmbeddedBatch& b = m.batches[i];
+            DrawBatch db;
+            db.baseColor = glm::vec3(b.r, b.g, b.b);
+            db.opacity = b.opacity;
+            db.firstIndex = b.firstIndex;
+            db.indexCount = (GLsizei)b.indexCount;
+            db.cullBackfaces = b.cullBackfaces;
+            model_batches.push_back(db);
+        }
+        if (model_batches.empty() && model_index_count > 0) {
+            DrawBatch db;
+            db.indexCount = (GLsizei)model_index_count;
+            model_batches.push_back(db);
+        }
+        compute_batch_bounds(m.vertices, m.stride, m.indices, model_batches);
 
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-            glEnableVertexAttribArray(1);
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-            glBindVertexArray(0);
+        silhouettes.upload(model_vbo, m.stride, std::vector<unsigned int>(m.silhouetteEdges, m.silhouetteEdges + m.silhouetteEdgeCount));
+        modelStats.silhouetteEdges = silhouettes.edgeCount();
+        modelUploaded = true;
+    }
 
-            model_index_count = import_indices_ptr->size();
-            currentVertexCount = import_positions_ptr->size();
-
-
-            // build explicit line EBO for wireframe overlay
-            std::vector<unsigned int> lineIndices = build_edge_list(*import_indices_ptr);
-            if (!lineIndices.empty()) {
-                glBindVertexArray(model_vao); // element array binds to VAO
-                glGenBuffers(1, &model_lines_ebo);
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_lines_ebo);
-                glBufferData(GL_ELEMENT_ARRAY_BUFFER, lineIndices.size() * sizeof(unsigned int), lineIndices.data(), GL_STATIC_DRAW);
-                model_lines_count = lineIndices.size();
-                // restore triangle EBO as VAO element array
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_ebo);
-                glBindVertexArray(0);
-            } else {
-                model_lines_count = 0;
-            }
+    // the loader pipeline's last step, on the main thread (failures were already logged)
+    void onLoadResult(LoadResult& result) {
+        input.noteLoadApplied();
+        if (!result.ok || !result.mesh) return;
+        if (!result.mesh->points.empty()) {
+            // the renderer uploads octree nodes as the view needs them, no inspection (no triangles)
+            releaseModelGpu();
+            modelUploaded = false;
+            pendingInspection = {};
+            modelStats = ModelStats{};
+            modelStats.timings = result.mesh->timings;
+            pointClouds.setCloud(std::make_shared<const PointCloud>(std::move(result.mesh->points)));
+            return;
+        }
+        uploadMesh(*result.mesh);
+        modelUploaded = true;
+        // the job keeps the mesh alive; a result for a replaced model is simply dropped
+        std::shared_ptr<const MeshData> mesh(std::move(result.mesh));
+        pendingInspection = globalThreadPool().submit([mesh]() { return inspect_mesh(*mesh); });
+        modelStats.inspecting = true;
+        trimTextureCache(); // the load may have added cache entries
+    }
 
-            modelUploaded = true;
+    // Called each frame on the main thread: resume whatever came back from the pool (finished
+    // loads among it). The budget only matters when several continuations queue up.
+    void runMainThreadTasks() {
+        const double budgetMs = 4.0;
+        // replay: a load lands in the frame it landed in when recorded, however long it takes now
+        while (input.loadDue()) {
+            if (!loader.busy()) { input.noteLoadApplied(); break; } // never requested, skip it
+            if (mainExecutor.run(budgetMs) == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (!(input.holdLoads() && loader.busy())) mainExecutor.run(budgetMs);
+        if (isLoading.load() && !loader.busy()) isLoading.store(false);
+        if (pendingInspection.valid() && pendingInspection.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            modelStats.inspection = pendingInspection.get();
+            modelStats.inspecting = false;
+            modelStats.inspected = true;
+        }
+    }
 
-            // Clear import state
-            import_ready.reset(); import_failed.reset(); import_progress.reset();
-            import_positions_ptr.reset(); import_normals_ptr.reset(); import_indices_ptr.reset();
-            if (importLoaderFuture.valid()) importLoaderFuture = std::future<void>();
+    // Worker priority and the reserved core follow the settings. While a load runs and frames
+    // stay over budget, one more worker is parked every few frames; they come back one at a time
+    // once frames are well under budget.
+    void updateLoaderQos() {
+        ThreadPool& pool = globalThreadPool();
+        if (pool.workerPriority() != userSettings.loaderPriority) pool.setWorkerPriority(userSettings.loaderPriority);
+
+        // the pool size is fixed at startup, the worker thread setting caps how many take jobs
+        unsigned cap = pool.size();
+        if (userSettings.workerThreads > 0) cap = std::min(cap, (unsigned)userSettings.workerThreads);
+        if (userSettings.reserveRenderCore && cap > 1) cap -= 1;
+        const double budget = userSettings.frameBudgetMs;
+        unsigned target = std::min(pool.concurrency(), cap);
+        if (!userSettings.throttleLoads || !loader.busy()) {
+            target = cap;
+            overBudgetFrames = underBudgetFrames = 0;
+        } else if (frameWorkMs > budget) {
+            underBudgetFrames = 0;
+            if (++overBudgetFrames >= 3) { target = std::max(1u, target - 1); overBudgetFrames = 0; }
+        } else {
+            overBudgetFrames = 0;
+            if (frameWorkMs < 0.75 * budget && ++underBudgetFrames >= 30) { target = std::min(cap, target + 1); underBudgetFrames = 0; }
+        }
+        if (target != pool.concurrency()) pool.setConcurrency(target);
+
+        LoaderQosStats& q = modelStats.loaderQos;
+        q.workers = pool.size();
+        q.activeWorkers = pool.concurrency();
+        q.priority = pool.workerPriority();
+        q.priorityApplied = pool.workerPriorityApplied();
+        q.throttled = q.activeWorkers < cap;
+        q.frameMs = frameWorkMs;
+    }
 
-            // Mark loading finished
-            isLoading.store(false);
+    // Performance preferences apply on the next frame: each one is compared with what was last
+    // applied. Worker threads go through updateLoaderQos, MSAA through sceneTarget.ensure.
+    void applyPerformanceSettings() {
+        const int swapInterval = userSettings.vsync ? 1 : 0;
+        if (swapInterval != appliedSwapInterval) {
+            glfwSwapInterval(swapInterval);
+            appliedSwapInterval = swapInterval;
         }
+
+        if (userSettings.vramBudgetMB != appliedVramBudgetMB) {
+            uploadTextures();
+        } else if (userSettings.textureLodBias != appliedLodBias) {
+            for (GLuint tex : model_textures) {
+                glBindTexture(GL_TEXTURE_2D, tex);
+                glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_LOD_BIAS, userSettings.textureLodBias);
+            }
+            glBindTexture(GL_TEXTURE_2D, 0);
+            appliedLodBias = userSettings.textureLodBias;
+        }
+
+        // the next load uses the new directory; trimming waits until the size field is left
+        updateTextureCacheDir();
+        if (userSettings.textureCacheMaxMB != appliedCacheMaxMB && !ImGui::IsAnyItemActive()) trimTextureCache();
     }
 
+    // Everything besides its camera a cached view depends on. sceneVersion covers GPU data, the
+    // rest is read every frame; a point cloud still streaming (as of the previous frame, call after
+    // PointCloudRenderer::beginFrame) changes with every frame.
+    uint64_t sceneKey() const {
+        uint64_t key = kViewKeySeed;
+        const auto mix = [&key](const auto& value) { key = view_key_mix(key, &value, sizeof(value)); };
+        mix(sceneVersion);
+        mix(showWireframe);
+        mix(userSettings.wireframeFeatureEdges);
+        mix(userSettings.showSilhouettes);
+        mix(userSettings.backfaceCulling);
+        mix(userSettings.pointBudgetM);
+        mix(userSettings.pointSize);
+        mix(lightDir);
+        mix(lightIntensity);
+        mix(lightColor);
+        mix(staticShadows);
+        mix(modelStats.msaaSamples);
+        if (pointClouds.streamingLastFrame()) mix(frameCount);
+        return key;
+    }
 
-    void uploadModelIfReady() {
-        if (!modelUploaded && loader.modelReady.load()) {
-            auto positions_ptr = loader.positions();
-            loader.loadProgress.store(0.0f);
-            auto normals_ptr = loader.normals();
-            auto indices_ptr = loader.indices();
-            if (!positions_ptr || !normals_ptr || !indices_ptr) return;
+    // one view into the bound scene target, its viewport (and scissor in the quad layout) set
+    void drawView(const ViewCamera& cam, const std::vector<DrawBatch>& batches, int fbW, int fbH) {
+        renderer.drawBackground();
+        glClear(GL_DEPTH_BUFFER_BIT);
 
-            std::vector<float> verts; verts.reserve(positions_ptr->size()*6);
-            for (size_t i = 0; i < positions_ptr->size(); ++i) {
-                verts.push_back((*positions_ptr)[i].x);
-                verts.push_back((*positions_ptr)[i].y);
-                verts.push_back((*positions_ptr)[i].z);
-                verts.push_back((*normals_ptr)[i].x);
-                verts.push_back((*normals_ptr)[i].y);
-                verts.push_back((*normals_ptr)[i].z);
+        // model matrix is identity, so the view-projection is the MVP
+        const glm::mat4& mvp = cam.viewProj;
+        if (renderer.modelProgram()) {
+            renderer.setModelMVP(mvp);
+            renderer.setLightDirection(staticShadows ? lightDir : glm::normalize(cam.eye - target));
+            if (modelUploaded && debugView != DebugView::Off) {
+                debugViews.draw(debugView, model_vao, batches, mvp, fbW, fbH,
+                                userSettings.backfaceCulling, sceneTarget.fbo());
+            } else if (modelUploaded) {
+                renderer.drawModelBatches(model_vao, batches);
             }
+        }
 
-            glGenVertexArrays(1, &model_vao);
-            glGenBuffers(1, &model_vbo);
-            glGenBuffers(1, &model_ebo);
+        // Wireframe overlay passes
+        const size_t wireLineCount = userSettings.wireframeFeatureEdges ? model_feature_lines_count : model_lines_count;
+        if (showWireframe && modelUploaded && wireLineCount > 0) {
+            renderer.setForceWire(true);
+            renderer.setWireColor(glm::vec3(0.45f,0.83f,0.28f));
 
+            glUseProgram(renderer.modelProgram());
             glBindVertexArray(model_vao);
-            glBindBuffer(GL_ARRAY_BUFFER, model_vbo);
-            glBufferData(GL_ARRAY_BUFFER, verts.size()*sizeof(float), verts.data(), GL_STATIC_DRAW);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_lines_ebo);
+
+            glEnable(GL_DEPTH_TEST);
+            glLineWidth(2.0f);
+            glDrawElements(GL_LINES, (GLsizei)wireLineCount, GL_UNSIGNED_INT, 0);
+
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_ebo);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices_ptr->size()*sizeof(unsigned int), indices_ptr->data(), GL_STATIC_DRAW);
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,6*sizeof(float),(void*)0);
-            glEnableVertexAttribArray(1);
-            glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,6*sizeof(float),(void*)(3*sizeof(float)));
             glBindVertexArray(0);
+            glUseProgram(0);
 
-            model_index_count = indices_ptr->size();
-            currentVertexCount = positions_ptr->size();
-
-            if (model_lines_ebo) { glDeleteBuffers(1, &model_lines_ebo); model_lines_ebo = 0; model_lines_count = 0; }
-            std::vector<unsigned int> lineIndices = build_edge_list(*indices_ptr);
-            if (!lineIndices.empty()) {
-                glBindVertexArray(model_vao);
-                glGenBuffers(1, &model_lines_ebo);
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_lines_ebo);
-                glBufferData(GL_ELEMENT_ARRAY_BUFFER, lineIndices.size() * sizeof(unsigned int), lineIndices.data(), GL_STATIC_DRAW);
-                model_lines_count = lineIndices.size();
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_ebo);
-                glBindVertexArray(0);
-            }
+            renderer.setForceWire(false);
+
+            // second pass
+            glUseProgram(renderer.modelProgram());
+            glBindVertexArray(model_vao);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_lines_ebo);
+
+            glLineWidth(1.0f);
+            glEnable(GL_DEPTH_TEST);
+            glDrawElements(GL_LINES, (GLsizei)wireLineCount, GL_UNSIGNED_INT, 0);
+
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_ebo);
+            glBindVertexArray(0);
+            glUseProgram(0);
+        }
+
+        if (pointClouds.hasCloud()) {
+            pointClouds.draw(mvp, cam.eye, cam.pixelsPerUnit, cam.orthographic,
+                             size_t(userSettings.pointBudgetM * 1e6f), userSettings.pointSize);
+        }
 
-            modelUploaded = true;
-            isLoading.store(false);
+        // View-dependent outline, extracted on the GPU every frame
+        if (userSettings.showSilhouettes && modelUploaded) {
+            silhouettes.draw(model_vao, model_ebo, mvp, cam.eye, glm::vec3(0.05f, 0.05f, 0.05f));
         }
+
+        // Grid
+        if (renderer.gridProgram()) renderer.drawGrid(mvp);
     }
 
     void shutdownCleanup() {
-        if (model_ebo) { glDeleteBuffers(1, &model_ebo); model_ebo = 0; }
-        if (model_vbo) { glDeleteBuffers(1, &model_vbo); model_vbo = 0; }
-        if (model_vao) { glDeleteVertexArrays(1, &model_vao); model_vao = 0; }
-        if (model_lines_ebo) { glDeleteBuffers(1, &model_lines_ebo); model_lines_ebo = 0; model_lines_count = 0; }
-
+        if (frameFence) { glDeleteSync(frameFence); frameFence = nullptr; }
+        sceneTarget.release();
+        views.release();
+        releaseModelGpu();
+
+        silhouettes.shutdownCleanup();
+        debugViews.shutdownCleanup();
+        pointClouds.shutdownCleanup();
         renderer.shutdownCleanup();
     }
 };
@@ -412,39 +780,71 @@ App::~App() {
 int App::run() {
     Impl& I = *impl_;
 
-    if (!I.initWindowAndGL()) return -1;
+    // Startup critical path: window + GL context on this thread, meanwhile settings, the UI font
+    // file and the argv model's bytes are read on pool workers. Nothing GL-side waits on them
+    // until Ui_Init / the load request.
+    std::future<void> settingsReady = globalThreadPool().submit([&I]() { I.loadSettings(); });
+    std::future<std::vector<unsigned char>> fontData = globalThreadPool().submit([]() { return Ui_ReadFontFile(); });
+    if (!I.replayPath.empty()) {
+        if (!I.input.startReplay(I.replayPath, I.fixedStepMs)) return -1;
+        if (I.modelPath.empty()) I.modelPath = I.input.recordedModel();
+    } else if (!I.recordPath.empty() && !I.input.startRecording(I.recordPath, I.modelPath)) {
+        return -1;
+    }
+    if (!I.modelPath.empty()) Loader::prefetch(I.modelPath);
+
+    const bool windowOk = I.initWindowAndGL();
+    settingsReady.get(); // initWindowAndGL leaves userSettings alone
+    if (!windowOk) return -1;
+    I.markStartup("window+GL");
+    I.initTextureCacheDir();
+    const char* glsl_version = "#version 330";
+    if (!Ui_Init(I.window, glsl_version, fontData.get())) {
+        std::cerr << "Ui_Init failed\n";
+        return -1;
+    }
+    I.input.install(I.window); // on top of the ImGui backend's callbacks
+    Ui_SetReplayMode(I.input.replaying(), I.input.fixedDeltaTime());
+    I.markStartup("UI");
     if (!I.renderer.init()) return -1;
     if (!I.compileBuiltinPrograms()) return -1;
-
-    std::string model_path = std::filesystem::path(std::filesystem::current_path() / "assets" / "splender.obj").string();
-    if (I.argc > 1) model_path = std::string(I.argv[1]);
-    std::cout << "Model path: " << model_path << "\n";
-
-    I.startInitialLoad(model_path);
-
-    // UI import refs wired to app loader state (if UI starts imports it places data here)
-    ImportStateRefs importRefs;
-    importRefs.importLoaderFuture = &I.importLoaderFuture;
-    importRefs.import_positions_ptr = &I.import_positions_ptr;
-    importRefs.import_normals_ptr = &I.import_normals_ptr;
-    importRefs.import_indices_ptr = &I.import_indices_ptr;
-    importRefs.import_ready = &I.import_ready;
-    importRefs.import_failed = &I.import_failed;
-    importRefs.import_progress = &I.import_progress;
+    I.markStartup("shaders");
+
+    // the baked default model is on screen for the first frame; a model from argv replaces it
+    // once its background load finishes
+    I.uploadEmbedded(embedded_default_model());
+    I.updateLoaderQos(); // workers take the configured priority before the first load
+    if (!I.modelPath.empty()) {
+        std::cout << "Model path: " << I.modelPath << "\n";
+        I.requestLoad(I.modelPath);
+    }
+    I.markStartup("model");
 
     while (!glfwWindowShouldClose(I.window)) {
-        // Input: cursor and mouse
-        double mx, my; glfwGetCursorPos(I.window, &mx, &my);
-        int middleState = glfwGetMouseButton(I.window, GLFW_MOUSE_BUTTON_MIDDLE);
-        bool altState = (glfwGetKey(I.window, GLFW_KEY_LEFT_ALT) == GLFW_PRESS) || (glfwGetKey(I.window, GLFW_KEY_RIGHT_ALT) == GLFW_PRESS);
+        int fbW, fbH; glfwGetFramebufferSize(I.window, &fbW, &fbH);
+        I.glCapture.beginFrame(fbW, fbH);
+
+        // low latency: wait for the GPU to finish the previous frame so input is read as late as
+        // possible (at most one frame queued)
+        if (I.frameFence) {
+            glClientWaitSync(I.frameFence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000); // 100 ms
+            glDeleteSync(I.frameFence);
+            I.frameFence = nullptr;
+        }
+        I.frameStart = glfwGetTime();
+        I.applyPerformanceSettings();
+        // Input: cursor and mouse, as delivered by the input session (live, recorded or replayed)
+        const InputState& in = I.input.state();
+        double mx = in.cursorX, my = in.cursorY;
+        bool middleDown = in.button(GLFW_MOUSE_BUTTON_MIDDLE);
+        bool altState = in.key(GLFW_KEY_LEFT_ALT) || in.key(GLFW_KEY_RIGHT_ALT);
         if (I.firstMouse) { I.lastX = mx; I.lastY = my; I.firstMouse = false; }
 
         // Keyboard toggle for wireframe (single-press)
         {
             ImGuiIO& io = ImGui::GetIO();
             if (!io.WantCaptureKeyboard) {
-                int eState = glfwGetKey(I.window, GLFW_KEY_E);
-                bool ePressed = (eState == GLFW_PRESS);
+                bool ePressed = in.key(GLFW_KEY_E);
                 if (ePressed && !I.prevEPressed) {
                     I.showWireframe = !I.showWireframe;
                 }
@@ -453,9 +853,29 @@ int App::run() {
                 I.prevEPressed = false;
             }
         }
+        const bool f12Pressed = in.key(GLFW_KEY_F12);
+        if (f12Pressed && !I.prevF12Pressed && I.glCapture.active()) I.glCapture.captureNext(1);
+        I.prevF12Pressed = f12Pressed;
+
+        // quad view: the view under the cursor is the one drawn live, and stays so during a drag
+        int winW, winH; glfwGetWindowSize(I.window, &winW, &winH);
+        const double toFbX = winW > 0 ? double(fbW) / winW : 1.0, toFbY = winH > 0 ? double(fbH) / winH : 1.0;
+        if (!middleDown) {
+            const int hovered = I.views.viewAt(mx * toFbX, my * toFbY);
+            if (hovered >= 0) I.views.setActive((size_t)hovered);
+        }
+        const ViewCamera* orthoView = I.views.quad() && I.views.camera(I.views.active()).orthographic
+                                    ? &I.views.camera(I.views.active()) : nullptr;
 
         if (!isLoading.load()) {
-            if (middleState == GLFW_PRESS) {
+            if (middleDown && orthoView) {
+                // orthographic views pan in their own plane, the model following the cursor
+                double dx = mx - I.lastX, dy = my - I.lastY;
+                const float unitsPerPixel = 2.0f * orthoView->halfHeight / float(orthoView->height) * float(toFbY);
+                const glm::vec3 right(orthoView->view[0][0], orthoView->view[1][0], orthoView->view[2][0]);
+                const glm::vec3 up(orthoView->view[0][1], orthoView->view[1][1], orthoView->view[2][1]);
+                I.target -= right * float(dx) * unitsPerPixel - up * float(dy) * unitsPerPixel;
+            } else if (middleDown) {
                 double dx = mx - I.lastX, dy = my - I.lastY;
 
                 bool doOrbit = false;
@@ -466,7 +886,7 @@ int App::run() {
                     if (altState) doOrbit = true;
                     else doPan = true;
                 } else { // Blender
-                    bool shiftState = (glfwGetKey(I.window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) || (glfwGetKey(I.window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS);
+                    bool shiftState = in.key(GLFW_KEY_LEFT_SHIFT) || in.key(GLFW_KEY_RIGHT_SHIFT);
                     if (shiftState) doPan = true;
                     else doOrbit = true;
                 }
@@ -489,116 +909,94 @@ int App::run() {
 
         I.lastX = mx; I.lastY = my;
 
-        int fbW, fbH; glfwGetFramebufferSize(I.window, &fbW, &fbH);
-
-        // Draw background first (renderer)
-        I.renderer.drawBackground();
-
-        glClear(GL_DEPTH_BUFFER_BIT);
+        I.modelStats.msaaSamples = I.sceneTarget.ensure(fbW, fbH, I.userSettings.msaaSamples);
+        I.sceneTarget.bind();
 
         // Camera matrices
         float cx = I.distance * cos(I.pitch) * cos(I.yaw);
         float cy = I.distance * sin(I.pitch);
         float cz = I.distance * cos(I.pitch) * sin(I.yaw);
         glm::vec3 camPos = I.target + glm::vec3(cx, cy, cz);
-        glm::mat4 proj = glm::perspective(glm::radians(45.0f), fbW>0 ? (float)fbW/fbH : 1.0f, 0.01f, 1000.0f);
-        glm::mat4 view = glm::lookAt(camPos, I.target, glm::vec3(0,1,0));
         glm::mat4 model = glm::mat4(1.0f);
-        glm::mat4 mvp = proj * view * model;
 
-        // Handle imports and uploads
-        I.maybeFinishImport();
-        I.uploadModelIfReady();
+        // Upload finished loads
+        I.updateLoaderQos();
+        I.runMainThreadTasks();
 
-        // Set renderer uniforms and draw model if ready
-        if (I.renderer.modelProgram()) {
-            glm::vec3 finalLightDir = I.lightDir;
-            if (!I.staticShadows) finalLightDir = glm::normalize(camPos - I.target);
+        // the orbit camera alone, or with top / front / side views around its target; the debug
+        // views measure a single view
+        const bool quad = I.userSettings.quadView && I.debugView == DebugView::Off;
+        I.views.update(quad, fbW, fbH, OrbitView{ camPos, I.target, glm::radians(45.0f), 0.01f, 1000.0f });
+        I.views.cull(I.model_batches);
 
-            I.renderer.setModelMVP(mvp);
+        // state shared by every view; each view only sets its MVP and headlight
+        if (I.renderer.modelProgram()) {
             I.renderer.setModelMatrix(model);
-            I.renderer.setLightDirection(finalLightDir);
             I.renderer.setLightIntensity(I.lightIntensity);
             I.renderer.setLightColor(I.lightColor);
             I.renderer.setEnableShadows(I.staticShadows);
-
-            if (I.modelUploaded) {
-                glUseProgram(I.renderer.modelProgram());
-                glBindVertexArray(I.model_vao);
-                glDrawElements(GL_TRIANGLES, (GLsizei)I.model_index_count, GL_UNSIGNED_INT, 0);
-                glBindVertexArray(0);
-                glUseProgram(0);
-            }
+            I.renderer.setFlatShading(I.modelFlatShaded);
+            I.renderer.setBackfaceCulling(I.userSettings.backfaceCulling);
         }
-
-        // Wireframe overlay passes
-        if (I.showWireframe && I.modelUploaded && I.model_lines_count > 0) {
-            I.renderer.setModelMVP(mvp);
-            I.renderer.setModelMatrix(model);
-            I.renderer.setForceWire(true);
-            I.renderer.setWireColor(glm::vec3(0.45f,0.83f,0.28f));
-
-            glUseProgram(I.renderer.modelProgram());
-            glBindVertexArray(I.model_vao);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, I.model_lines_ebo);
-
-            glEnable(GL_DEPTH_TEST);
-            glLineWidth(2.0f);
-            glDrawElements(GL_LINES, (GLsizei)I.model_lines_count, GL_UNSIGNED_INT, 0);
-
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, I.model_ebo);
-            glBindVertexArray(0);
-            glUseProgram(0);
-
-            I.renderer.setForceWire(false);
-
-            // second pass
-            I.renderer.setModelMVP(mvp);
-            I.renderer.setModelMatrix(model);
-
-            glUseProgram(I.renderer.modelProgram());
-            glBindVertexArray(I.model_vao);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, I.model_lines_ebo);
-
-            glLineWidth(1.0f);
-            glEnable(GL_DEPTH_TEST);
-            glDrawElements(GL_LINES, (GLsizei)I.model_lines_count, GL_UNSIGNED_INT, 0);
-
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, I.model_ebo);
-            glBindVertexArray(0);
-            glUseProgram(0);
+        I.pointClouds.beginFrame();
+        const uint64_t sceneKey = I.sceneKey();
+        for (size_t v = 0; v < I.views.count(); ++v) {
+            if (I.views.beginView(v, sceneKey)) I.drawView(I.views.camera(v), I.views.batches(v), fbW, fbH);
         }
-
-        // Grid
-        if (I.renderer.gridProgram()) {
-            glm::mat4 mvpGrid = proj * view * glm::mat4(1.0f);
-            I.renderer.drawGrid(mvpGrid);
-        }
-
-        size_t vertexCount = I.currentVertexCount;
-        size_t triCount = (I.model_index_count > 0) ? (I.model_index_count / 3) : 0;
-
-        // pass App's import_progress so the UI reads the same progress the UI-import writes to
-        std::shared_ptr<std::atomic<float>> uiImportProgress = I.import_progress ? I.import_progress : I.loader.currentImportProgress();
-
+        I.views.endViews();
+        I.modelStats.silhouetteCompute = I.silhouettes.usesCompute();
+        I.modelStats.silhouetteMs = I.silhouettes.lastExtractMs();
+        I.modelStats.debugView = I.debugView != DebugView::Off ? I.debugViews.metrics() : DebugViewMetrics{};
+        I.modelStats.points = I.pointClouds.stats();
+        I.modelStats.views = I.views.stats();
+        I.sceneTarget.resolve();
+        I.views.finishFrame();
+
+        const auto importModel = [&I](const std::string& path) { I.importModel(path); };
+        I.input.dispatchActions(importModel); // replay: imports recorded in this frame
         Ui_FrameDraw(I.window,
-                    I.loader.loadProgress,
-                    uiImportProgress,
-                    importRefs,
+                    I.loader,
+                    importModel,
                     I.lightDir,
                     I.lightIntensity,
                     I.lightColor,
                     I.staticShadows,
                     &I.showWireframe,
+                    I.debugView,
                     I.userSettings,
-                    vertexCount,
-                    triCount);
+                    I.modelStats);
 
+        const double workMs = (glfwGetTime() - I.frameStart) * 1000.0;
+        I.frameWorkMs = I.frameWorkMs * 0.9 + workMs * 0.1;
         glfwSwapBuffers(I.window);
-        glfwPollEvents();
+        if (I.userSettings.latencyMode == LatencyMode::Low) I.frameFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        I.glCapture.endFrame();
+        ++I.frameCount;
+
+        // render on demand: once a few frames settled without input, sleep until the next event.
+        // The timeout still draws a frame now and then; an early wake-up means input arrived.
+        // input arriving from here on belongs to the next frame
+        I.input.endFrame(workMs);
+        if (I.input.finished()) glfwSetWindowShouldClose(I.window, GLFW_TRUE);
+
+        if (isLoading.load() || I.input.replaying() || I.modelStats.points.streaming) I.idleFrames = 0;
+        if (I.userSettings.renderOnDemand && ++I.idleFrames > 3) {
+            const double waitStart = glfwGetTime();
+            glfwWaitEventsTimeout(0.25);
+            if (glfwGetTime() - waitStart < 0.25) I.idleFrames = 0;
+        } else {
+            glfwPollEvents();
+        }
+        if (!I.startupSteps.empty()) {
+            I.markStartup("first frame");
+            I.reportStartup();
+        }
     }
 
-    // Wait for loader work to finish before shutdown (loader manages futures internally)
+    I.input.finish(I.replayStatsPath);
+    I.glCapture.finish();
+
+    // loads still in flight are cancelled and drained when the Impl (and its Loader) goes away
     Ui_Shutdown();
     I.shutdownCleanup();
     if (I.window) {
@@ -612,7 +1010,7 @@ int App::run() {
 void App::requestImport(const std::string& objPath) {
     if (!impl_) return;
     if (isLoading.load()) return;
-    impl_->requestImportAsync(objPath);
+    impl_->importModel(objPath);
 }
 
 void App::shutdown() {
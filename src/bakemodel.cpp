@@ -0,0 +1,128 @@
+// bakemodel.cpp
+// splender_bake <model> <header>: build-time tool that loads a model with default LoadOptions and
+// writes it as constexpr arrays in the layout of embeddedmodel.h (see embeddedmodel.cpp)
+
+#include "loader.h"
+#include "geomkernels.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// shortest text that reads back as the same float
+static std::string float_literal(float v)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", v);
+    std::string s = buf;
+    if (s.find_first_of(".e") == std::string::npos) s += ".0";
+    return s + "f";
+}
+
+template <class T, class Format>
+static void write_array(std::ofstream& out, const char* type, const char* name, const T* data, size_t count,
+                        size_t perLine, Format format)
+{
+    // zero-length arrays are ill-formed, the count constant says it is empty
+    out << "constexpr " << type << " " << name << "[] = {";
+    if (count == 0) out << " " << format(T{}) << " ";
+    for (size_t i = 0; i < count; ++i) {
+        if (i % perLine == 0) out << "\n    ";
+        out << format(data[i]) << (i + 1 < count ? "," : "");
+    }
+    out << (count ? "\n};\n" : "};\n");
+    out << "constexpr size_t " << name << "Count = " << count << ";\n\n";
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        std::cerr << "usage: splender_bake <model> <header>\n";
+        return 2;
+    }
+    const std::string inPath = argv[1];
+    const std::string outPath = argv[2];
+
+    MeshData mesh;
+    if (!Loader::load_model(inPath, mesh)) {
+        std::cerr << "splender_bake: failed to load " << inPath << "\n";
+        return 1;
+    }
+    if (!mesh.points.empty()) {
+        std::cerr << "splender_bake: " << inPath << " is a point cloud, only meshes can be embedded\n";
+        return 1;
+    }
+    if (!mesh.textures.empty()) {
+        std::cerr << "splender_bake: " << inPath << " has textures, the embedded copy keeps material colours only\n";
+    }
+
+    // same layout decisions as App::Impl::uploadMesh
+    const bool hasUV = mesh.texcoords.size() == mesh.positions.size();
+    const bool hasNormals = !mesh.flatShaded && mesh.normals.size() == mesh.positions.size();
+    const unsigned int stride = hasNormals ? 8 : 5;
+    std::vector<float> verts(mesh.positions.size() * stride);
+    {
+        std::vector<VertexStream> streams;
+        streams.push_back(VertexStream{ mesh.positions.empty() ? nullptr : &mesh.positions[0].x, 3 });
+        if (hasNormals) streams.push_back(VertexStream{ &mesh.normals[0].x, 3 });
+        streams.push_back(VertexStream{ hasUV && !mesh.texcoords.empty() ? &mesh.texcoords[0].x : nullptr, 2 });
+        geom_interleave(streams.data(), streams.size(), mesh.positions.size(), verts.data());
+    }
+
+    std::filesystem::create_directories(std::filesystem::path(outPath).parent_path());
+    std::ofstream out(outPath, std::ios::trunc);
+    if (!out) {
+        std::cerr << "splender_bake: cannot write " << outPath << "\n";
+        return 1;
+    }
+
+    const std::string source = std::filesystem::path(inPath).filename().string();
+    auto uintText = [](unsigned int v) { return std::to_string(v); };
+
+    out << "#pragma once\n\n"
+        << "// default_model.h\n"
+        << "// Generated by splender_bake from " << source << ", do not edit.\n\n"
+        << "#include <cstddef>\n\n"
+        << "#include \"embeddedmodel.h\"\n\n"
+        << "namespace default_model {\n\n"
+        << "constexpr const char* source = \"" << source << "\";\n"
+        << "constexpr unsigned int stride = " << stride << ";\n"
+        << "constexpr bool flatShaded = " << (hasNormals ? "false" : "true") << ";\n"
+        << "constexpr size_t featureLineCount = " << mesh.featureLineCount << ";\n\n";
+
+    write_array(out, "float", "vertices", verts.data(), verts.size(), stride, float_literal);
+    out << "static_assert(verticesCount % stride == 0);\n"
+        << "constexpr size_t vertexCount = verticesCount / stride;\n\n";
+    write_array(out, "unsigned int", "indices", mesh.indices.data(), mesh.indices.size(), 12, uintText);
+    write_array(out, "unsigned int", "edgeLines", mesh.edgeLines.data(), mesh.edgeLines.size(), 12, uintText);
+    write_array(out, "unsigned int", "silhouetteEdges", mesh.silhouetteEdges.data(), mesh.silhouetteEdges.size(), 12, uintText);
+    out << "constexpr size_t indexCount = indicesCount;\n"
+        << "constexpr size_t edgeLineCount = edgeLinesCount;\n"
+        << "constexpr size_t silhouetteEdgeCount = silhouetteEdgesCount;\n\n";
+
+    out << "constexpr EmbeddedBatch batches[] = {\n";
+    for (const MaterialBatch& b : mesh.batches) {
+        Material m;
+        if (b.materialIndex < mesh.materials.size()) m = mesh.materials[b.materialIndex];
+        out << "    { " << b.firstIndex << ", " << b.indexCount << ", "
+            << float_literal(m.diffuse.r) << ", " << float_literal(m.diffuse.g) << ", " << float_literal(m.diffuse.b) << ", "
+            << float_literal(m.opacity) << ", " << (b.cullBackfaces ? "true" : "false") << " },\n";
+    }
+    if (mesh.batches.empty()) out << "    { 0, 0, 0.0f, 0.0f, 0.0f, 0.0f, false },\n";
+    out << "};\n"
+        << "constexpr size_t batchCount = " << mesh.batches.size() << ";\n\n"
+        << "} // namespace default_model\n";
+
+    out.close();
+    if (!out) {
+        std::cerr << "splender_bake: write failed for " << outPath << "\n";
+        return 1;
+    }
+    std::cout << "splender_bake: " << source << " -> " << mesh.positions.size() << " vertices, "
+              << mesh.indices.size() / 3 << " triangles, " << mesh.batches.size() << " batches\n";
+    return 0;
+}
@@ -0,0 +1,174 @@
+// bcn.cpp
+// Implements the block encoders declared in bcn.h
+
+#include "bcn.h"
+#include "threadpool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define SPLENDER_BCN_SSE2 1
+  #include <emmintrin.h>
+#endif
+
+// per-channel min/max over the 16 texels of a block
+static void block_min_max(const unsigned char* rgba, unsigned char mn[4], unsigned char mx[4])
+{
+#ifdef SPLENDER_BCN_SSE2
+    __m128i r0 = _mm_loadu_si128((const __m128i*)(rgba + 0));
+    __m128i r1 = _mm_loadu_si128((const __m128i*)(rgba + 16));
+    __m128i r2 = _mm_loadu_si128((const __m128i*)(rgba + 32));
+    __m128i r3 = _mm_loadu_si128((const __m128i*)(rgba + 48));
+    __m128i lo = _mm_min_epu8(_mm_min_epu8(r0, r1), _mm_min_epu8(r2, r3));
+    __m128i hi = _mm_max_epu8(_mm_max_epu8(r0, r1), _mm_max_epu8(r2, r3));
+    // fold 4 texels -> 2 -> 1
+    lo = _mm_min_epu8(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(1, 0, 3, 2)));
+    hi = _mm_max_epu8(hi, _mm_shuffle_epi32(hi, _MM_SHUFFLE(1, 0, 3, 2)));
+    lo = _mm_min_epu8(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(2, 3, 0, 1)));
+    hi = _mm_max_epu8(hi, _mm_shuffle_epi32(hi, _MM_SHUFFLE(2, 3, 0, 1)));
+    int l = _mm_cvtsi128_si32(lo), h = _mm_cvtsi128_si32(hi);
+    std::memcpy(mn, &l, 4);
+    std::memcpy(mx, &h, 4);
+#else
+    for (int c = 0; c < 4; ++c) { mn[c] = 255; mx[c] = 0; }
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 4; ++c) {
+            mn[c] = std::min(mn[c], rgba[i * 4 + c]);
+            mx[c] = std::max(mx[c], rgba[i * 4 + c]);
+        }
+    }
+#endif
+}
+
+static unsigned short to565(int r, int g, int b)
+{
+    return (unsigned short)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+static void from565(unsigned short c, int out[3])
+{
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+static void encode_color_block(const unsigned char* rgba, const unsigned char mn[4], const unsigned char mx[4], unsigned char* out)
+{
+    // inset the bounding box by 1/16 of its extent to reduce the error at the ends
+    int lo[3], hi[3];
+    for (int c = 0; c < 3; ++c) {
+        int inset = (mx[c] - mn[c]) >> 4;
+        lo[c] = std::min(255, mn[c] + inset);
+        hi[c] = std::max(0, mx[c] - inset);
+    }
+    unsigned short c0 = to565(hi[0], hi[1], hi[2]);
+    unsigned short c1 = to565(lo[0], lo[1], lo[2]);
+    if (c0 < c1) std::swap(c0, c1);
+
+    unsigned int indices = 0;
+    if (c0 != c1) {
+        int p[4][3];
+        from565(c0, p[0]);
+        from565(c1, p[1]);
+        for (int c = 0; c < 3; ++c) {
+            p[2][c] = (2 * p[0][c] + p[1][c]) / 3;
+            p[3][c] = (p[0][c] + 2 * p[1][c]) / 3;
+        }
+        for (int i = 0; i < 16; ++i) {
+            const unsigned char* t = rgba + i * 4;
+            int best = 0, bestDist = 1 << 30;
+            for (int k = 0; k < 4; ++k) {
+                int dr = t[0] - p[k][0], dg = t[1] - p[k][1], db = t[2] - p[k][2];
+                int d = dr * dr + dg * dg + db * db;
+                if (d < bestDist) { bestDist = d; best = k; }
+            }
+            indices |= (unsigned int)best << (i * 2);
+        }
+    }
+
+    out[0] = (unsigned char)(c0 & 0xFF); out[1] = (unsigned char)(c0 >> 8);
+    out[2] = (unsigned char)(c1 & 0xFF); out[3] = (unsigned char)(c1 >> 8);
+    for (int b = 0; b < 4; ++b) out[4 + b] = (unsigned char)((indices >> (b * 8)) & 0xFF);
+}
+
+void encode_bc1_block(const unsigned char* rgba, unsigned char* out)
+{
+    unsigned char mn[4], mx[4];
+    block_min_max(rgba, mn, mx);
+    encode_color_block(rgba, mn, mx, out);
+}
+
+void encode_bc3_block(const unsigned char* rgba, unsigned char* out)
+{
+    unsigned char mn[4], mx[4];
+    block_min_max(rgba, mn, mx);
+
+    // alpha: a0 > a1 selects the 8-value ramp
+    const int a0 = mx[3], a1 = mn[3];
+    unsigned long long bits = 0;
+    if (a0 != a1) {
+        int ramp[8];
+        ramp[0] = a0; ramp[1] = a1;
+        for (int k = 1; k < 7; ++k) ramp[k + 1] = ((7 - k) * a0 + k * a1) / 7;
+        for (int i = 0; i < 16; ++i) {
+            int a = rgba[i * 4 + 3];
+            int best = 0, bestDist = 1 << 30;
+            for (int k = 0; k < 8; ++k) {
+                int d = std::abs(a - ramp[k]);
+                if (d < bestDist) { bestDist = d; best = k; }
+            }
+            bits |= (unsigned long long)best << (i * 3);
+        }
+    }
+    out[0] = (unsigned char)a0;
+    out[1] = (unsigned char)a1;
+    for (int b = 0; b < 6; ++b) out[2 + b] = (unsigned char)((bits >> (b * 8)) & 0xFF);
+
+    encode_color_block(rgba, mn, mx, out + 8);
+}
+
+bool compress_texture_bcn(const TextureImage& rgba, TextureImage& out)
+{
+    if (rgba.format != TextureFormat::RGBA8 || rgba.mips.empty()) return false;
+
+    out.path = rgba.path;
+    out.width = rgba.width;
+    out.height = rgba.height;
+    out.hasAlpha = rgba.hasAlpha;
+    out.format = rgba.hasAlpha ? TextureFormat::BC3 : TextureFormat::BC1;
+    const size_t blockBytes = (out.format == TextureFormat::BC3) ? 16 : 8;
+    out.mips.assign(rgba.mips.size(), std::vector<unsigned char>());
+
+    int w = rgba.width, h = rgba.height;
+    for (size_t level = 0; level < rgba.mips.size(); ++level) {
+        const int bw = (w + 3) / 4, bh = (h + 3) / 4;
+        const std::vector<unsigned char>& src = rgba.mips[level];
+        std::vector<unsigned char>& dst = out.mips[level];
+        dst.resize(size_t(bw) * size_t(bh) * blockBytes);
+
+        globalThreadPool().parallel_for(0, (size_t)bh, 8, [&](size_t rb, size_t re) {
+            unsigned char block[64];
+            for (size_t by = rb; by < re; ++by) {
+                for (int bx = 0; bx < bw; ++bx) {
+                    // gather with edge clamp for sizes that are not multiples of 4
+                    for (int y = 0; y < 4; ++y) {
+                        const int sy = std::min(h - 1, int(by) * 4 + y);
+                        for (int x = 0; x < 4; ++x) {
+                            const int sx = std::min(w - 1, bx * 4 + x);
+                            std::memcpy(block + (y * 4 + x) * 4, &src[(size_t(sy) * w + sx) * 4], 4);
+                        }
+                    }
+                    unsigned char* o = &dst[(by * bw + bx) * blockBytes];
+                    if (out.format == TextureFormat::BC3) encode_bc3_block(block, o);
+                    else encode_bc1_block(block, o);
+                }
+            }
+        });
+
+        w = std::max(1, w / 2); h = std::max(1, h / 2);
+    }
+    return true;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// bcn.h
+// Real-time BC1 / BC3 block encoder used by the texture cache (bounding box + inset fit).
+
+#include "textures.h"
+
+// encode one 4x4 RGBA8 block (64 bytes, row major) to 8 bytes of BC1
+void encode_bc1_block(const unsigned char* rgba, unsigned char* out);
+
+// encode one 4x4 RGBA8 block to 16 bytes of BC3 (BC4-style alpha block followed by a BC1 colour block)
+void encode_bc3_block(const unsigned char* rgba, unsigned char* out);
+
+// compress every mip of an RGBA8 image; BC3 when the image has alpha, BC1 otherwise.
+// Block rows are spread across the global thread pool.
+bool compress_texture_bcn(const TextureImage& rgba, TextureImage& out);
@@ -0,0 +1,509 @@
+// bench.cpp
+// Implements the benchmarks and the library report declared in bench.h
+
+#include "bench.h"
+#include "loader.h"
+#include "geomkernels.h"
+#include "scratchpool.h"
+#include "inspector.h"
+#include "threadpool.h"
+#include "perfcounters.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// FNV-1a over the index/position arrays, to check variants produce the same mesh
+static uint64_t mesh_fingerprint(const MeshData& mesh)
+{
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+    };
+    mix(mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int));
+    mix(mesh.positions.data(), mesh.positions.size() * sizeof(glm::vec3));
+    return h;
+}
+
+struct BenchVariant {
+    const char* name;
+    LoadOptions options;
+};
+
+// Counter deltas per loader stage and thread, summed over every load of a variant. mark() is
+// LoadOptions::onStage: each call closes the running stage with one read of all threads.
+struct StageCounters {
+    const PerfCounters* counters = nullptr;
+    std::vector<std::string> order;                          // stages as first seen
+    std::map<std::string, std::map<int, PerfValues>> byStage; // stage -> tid -> counts
+    std::string current;
+    std::vector<PerfThreadValues> last;
+
+    void mark(const char* stage) {
+        std::vector<PerfThreadValues> now = counters->read();
+        if (!current.empty()) {
+            std::map<int, PerfValues>& threads = byStage[current];
+            for (size_t i = 0; i < now.size() && i < last.size(); ++i) threads[now[i].tid] += now[i].values - last[i].values;
+        }
+        current = stage ? stage : "";
+        if (stage && std::find(order.begin(), order.end(), current) == order.end()) order.push_back(current);
+        last = std::move(now);
+    }
+};
+
+// events the counters could not open print as "-" rather than 0
+static void print_counter_row(const PerfCounters& counters, const std::string& label, const PerfValues& v, double loads,
+                              size_t vertices, size_t threads)
+{
+    const double perLoad = 1.0 / std::max(loads, 1.0);
+    const double verts = double(std::max<size_t>(vertices, 1));
+    auto cell = [](bool counted, double value, int precision, int width) {
+        if (counted) std::cout << std::setw(width) << std::setprecision(precision) << value;
+        else std::cout << std::setw(width) << "-";
+    };
+    const bool llc = counters.has(PerfEvent::LlcMisses), br = counters.has(PerfEvent::BranchMisses);
+    std::cout << "    " << std::left << std::setw(14) << label << std::right << std::fixed;
+    cell(counters.has(PerfEvent::Cycles), v[PerfEvent::Cycles] * perLoad * 1e-6, 2, 10);
+    cell(counters.has(PerfEvent::Instructions), v[PerfEvent::Instructions] * perLoad * 1e-6, 2, 10);
+    cell(counters.has(PerfEvent::Cycles) && counters.has(PerfEvent::Instructions), v.ipc(), 2, 6);
+    cell(llc, v[PerfEvent::LlcMisses] * perLoad * 1e-3, 2, 10);
+    cell(br, v[PerfEvent::BranchMisses] * perLoad * 1e-3, 2, 10);
+    cell(counters.has(PerfEvent::PageFaults), v[PerfEvent::PageFaults] * perLoad, 0, 9);
+    cell(llc, v[PerfEvent::LlcMisses] * perLoad / verts, 3, 9);
+    cell(br, v[PerfEvent::BranchMisses] * perLoad / verts, 3, 9);
+    if (threads) std::cout << std::setw(8) << threads;
+    std::cout << "\n";
+}
+
+// per-load means of each stage, then per thread when asked
+static void print_stage_counters(const StageCounters& sc, int loads, size_t vertices, bool perThread)
+{
+    std::cout << "    " << std::left << std::setw(14) << "stage" << std::right
+              << std::setw(10) << "Mcycles" << std::setw(10) << "Minstr" << std::setw(6) << "IPC"
+              << std::setw(10) << "kLLCmiss" << std::setw(10) << "kbrmiss" << std::setw(9) << "faults"
+              << std::setw(9) << "LLC/vtx" << std::setw(9) << "br/vtx" << std::setw(8) << "threads" << "\n";
+    PerfValues total;
+    for (const std::string& stage : sc.order) {
+        auto it = sc.byStage.find(stage);
+        if (it == sc.byStage.end()) continue;
+        PerfValues sum;
+        size_t active = 0;
+        for (const auto& [tid, v] : it->second) {
+            sum += v;
+            if (v.any()) ++active;
+        }
+        total += sum;
+        print_counter_row(*sc.counters, stage, sum, loads, vertices, active);
+        if (!perThread) continue;
+        for (const auto& [tid, v] : it->second) {
+            if (v.any()) print_counter_row(*sc.counters, "  tid " + std::to_string(tid), v, loads, vertices, 0);
+        }
+    }
+    print_counter_row(*sc.counters, "total", total, loads, vertices, 0);
+}
+
+int run_load_benchmark(int argc, char** argv)
+{
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " --bench-load <model> [iterations] [--per-thread]\n";
+        return 2;
+    }
+    const std::string path = argv[2];
+    int iterations = 5;
+    bool perThread = false;
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--per-thread") == 0) perThread = true;
+        else iterations = std::max(1, std::atoi(argv[i]));
+    }
+
+    std::error_code ec;
+    const double megabytes = double(std::filesystem::file_size(path, ec)) / (1024.0 * 1024.0);
+    if (ec) {
+        std::cerr << "bench: cannot stat " << path << "\n";
+        return 1;
+    }
+
+    // the first parses OBJ attribute lines through istringstream, the second with from_chars;
+    // scratch reuse is off in both so each load starts from fresh pages, as before the pool
+    std::vector<BenchVariant> variants;
+    {
+        BenchVariant stream{ "stream attributes", LoadOptions{} };
+        stream.options.reuseScratch = false;
+        stream.options.streamObjAttributes = true;
+        variants.push_back(stream);
+        BenchVariant fresh{ "+ from_chars", LoadOptions{} };
+        fresh.options.reuseScratch = false;
+        variants.push_back(fresh);
+        variants.push_back(BenchVariant{ "+ pooled scratch", LoadOptions{} });
+        BenchVariant huge{ "+ huge pages", LoadOptions{} };
+        huge.options.hugePageScratch = true;
+        variants.push_back(huge);
+    }
+
+    std::cout << "bench-load " << path << " (" << std::fixed << std::setprecision(1) << megabytes << " MB), best of "
+              << iterations << "\n";
+
+    // workers first, so the counters see every thread the stages run on
+    globalThreadPool();
+    PerfCounters counters;
+    if (counters.open()) {
+        std::cout << "perf counters: " << counters.status() << " (per-load means by stage, user space)\n";
+    } else {
+        std::cout << "perf counters unavailable, timings only: " << counters.status() << "\n";
+    }
+    uint64_t reference = 0;
+    double referenceParse = 0.0;
+    for (size_t v = 0; v < variants.size(); ++v) {
+        LoadTimings best;
+        best.totalSeconds = best.parseSeconds = 1e30;
+        uint64_t fingerprint = 0;
+        uint64_t faults = 0; // of the last run, i.e. with a warm pool
+        size_t tris = 0, vertices = 0;
+        StageCounters stages;
+        stages.counters = &counters;
+        LoadOptions options = variants[v].options;
+        if (counters.available()) options.onStage = [&stages](const char* stage) { stages.mark(stage); };
+        for (int i = 0; i < iterations; ++i) {
+            MeshData mesh;
+            if (!load_model(path, mesh, nullptr, options)) {
+                std::cerr << "bench: load failed\n";
+                return 1;
+            }
+            if (mesh.timings.parseSeconds < best.parseSeconds) best = mesh.timings;
+            fingerprint = mesh_fingerprint(mesh);
+            faults = mesh.timings.pageFaults;
+            tris = mesh.indices.size() / 3;
+            vertices = mesh.positions.size();
+        }
+        if (v == 0) { reference = fingerprint; referenceParse = best.parseSeconds; }
+
+        std::cout << std::left << std::setw(20) << variants[v].name << std::right << std::setprecision(2)
+                  << " parse " << std::setw(8) << best.parseSeconds * 1000.0 << " ms"
+                  << " (" << std::setw(7) << megabytes / std::max(best.parseSeconds, 1e-9) << " MB/s)"
+                  << "  textures " << best.textureSeconds * 1000.0 << " ms"
+                  << "  post " << best.postSeconds * 1000.0 << " ms"
+                  << "  total " << best.totalSeconds * 1000.0 << " ms"
+                  << "  faults " << faults
+                  << "  tris " << tris;
+        if (v > 0) {
+            std::cout << "  x" << referenceParse / std::max(best.parseSeconds, 1e-9)
+                      << (fingerprint == reference ? "  same mesh" : "  MESH DIFFERS");
+        }
+        std::cout << "\n";
+        if (counters.available()) print_stage_counters(stages, iterations, vertices, perThread);
+        if (fingerprint != reference) return 1;
+    }
+    const ScratchStats pool = globalScratchPool().stats();
+    std::cout << "scratch pool: " << pool.hits << " hits, " << pool.misses << " misses, "
+              << std::setprecision(1) << pool.cachedBytes / (1024.0 * 1024.0) << " MB cached, "
+              << pool.hugePageBytes / (1024.0 * 1024.0) << " MB advised huge\n";
+    return 0;
+}
+
+// ---------------------------------------------------------------------------------------------
+// kernels: every SIMD level must reproduce the scalar output bit for bit
+
+struct KernelOutput {
+    const void* data;
+    size_t bytes;
+};
+
+struct KernelCase {
+    const char* name;
+    size_t bytesPerElement;                 // read + written, for the GB/s column
+    // runs the kernel over `count` elements of the shared inputs into an output buffer allocated
+    // once up front; in-place kernels copy their input in first, and that copy is timed. A fresh
+    // allocation per run would time page faults, which come and go with the allocator's mmap
+    // threshold and swamped the kernels.
+    std::function<KernelOutput(size_t count)> run;
+};
+
+static std::vector<unsigned char> to_bytes(KernelOutput out)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(out.data);
+    return std::vector<unsigned char>(p, p + out.bytes);
+}
+
+static bool same_bytes(KernelOutput out, const std::vector<unsigned char>& expected)
+{
+    return out.bytes == expected.size() && (out.bytes == 0 || std::memcmp(out.data, expected.data(), out.bytes) == 0);
+}
+
+int run_kernel_benchmark(int argc, char** argv)
+{
+    const size_t count = (argc > 2) ? (size_t)std::max(1L, std::atol(argv[2])) : 1000003; // odd on purpose: tails
+    const int iterations = (argc > 3) ? std::max(1, std::atoi(argv[3])) : 10;
+
+    // inputs: positions in a skewed box, normals with zeros, signed zeros and lower-hemisphere vectors
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<glm::vec3> positions(count), normals(count);
+    std::vector<float> uvs(count * 2);
+    for (size_t i = 0; i < count; ++i) {
+        positions[i] = glm::vec3(dist(rng) * 40.0f + 3.0f, dist(rng) * 0.5f, dist(rng) * 1e4f);
+        normals[i] = glm::vec3(dist(rng), dist(rng), dist(rng));
+        if (i % 97 == 0) normals[i] = glm::vec3(0.0f);
+        if (i % 89 == 0) normals[i] = glm::vec3(-0.0f, 0.0f, -1.0f);
+    }
+    for (auto& f : uvs) f = dist(rng) * 2.0f;
+
+    Bounds3 box;
+    geom_bounds(positions.data(), positions.size(), box);
+    const glm::vec3 extent = box.max - box.min;
+    const float lo[3] = { box.min.x, box.min.y, box.min.z };
+    const float qscale[3] = { 65535.0f / extent.x, 65535.0f / extent.y, 65535.0f / extent.z };
+    const float qstep[3] = { extent.x / 65535.0f, extent.y / 65535.0f, extent.z / 65535.0f };
+    std::vector<uint16_t> quantized(count * 3);
+    geom_quantize_unorm16(&positions[0].x, count, 3, lo, qscale, quantized.data());
+
+    glm::mat4 xf(1.0f);
+    xf[0] = glm::vec4(0.8f, 0.1f, -0.3f, 0.0f);
+    xf[1] = glm::vec4(-0.2f, 1.7f, 0.05f, 0.0f);
+    xf[2] = glm::vec4(0.4f, 0.0f, 0.9f, 0.0f);
+    xf[3] = glm::vec4(12.5f, -3.0f, 0.25f, 1.0f);
+
+    // output buffers shared by the cases, touched once here so no run pays for fresh pages
+    Bounds3 boundsOut;
+    std::vector<glm::vec3> vecOut(count, glm::vec3(0.0f));
+    std::vector<uint16_t> u16Out(count * 3, 0);
+    std::vector<int16_t> i16Out(count * 2, 0);
+    std::vector<float> floatOut(count * 8, 0.0f);
+
+    std::vector<KernelCase> cases;
+    cases.push_back({ "bounds", 12, [&](size_t n) {
+        geom_bounds(positions.data(), n, boundsOut);
+        return KernelOutput{ &boundsOut, sizeof(boundsOut) };
+    } });
+    cases.push_back({ "scale_offset", 24, [&](size_t n) {
+        std::copy(positions.begin(), positions.begin() + n, vecOut.begin());
+        geom_scale_offset(vecOut.data(), n, glm::vec3(0.37f, 2.5f, -1.1f), glm::vec3(1.0f, -4.0f, 0.5f));
+        return KernelOutput{ vecOut.data(), n * sizeof(glm::vec3) };
+    } });
+    cases.push_back({ "transform", 24, [&](size_t n) {
+        std::copy(positions.begin(), positions.begin() + n, vecOut.begin());
+        geom_transform(vecOut.data(), n, xf);
+        return KernelOutput{ vecOut.data(), n * sizeof(glm::vec3) };
+    } });
+    cases.push_back({ "normalize", 24, [&](size_t n) {
+        std::copy(normals.begin(), normals.begin() + n, vecOut.begin());
+        geom_normalize(vecOut.data(), n);
+        return KernelOutput{ vecOut.data(), n * sizeof(glm::vec3) };
+    } });
+    cases.push_back({ "quantize", 18, [&](size_t n) {
+        geom_quantize_unorm16(&positions[0].x, n, 3, lo, qscale, u16Out.data());
+        return KernelOutput{ u16Out.data(), n * 3 * sizeof(uint16_t) };
+    } });
+    cases.push_back({ "dequantize", 18, [&](size_t n) {
+        geom_dequantize_unorm16(quantized.data(), n, 3, lo, qstep, floatOut.data());
+        return KernelOutput{ floatOut.data(), n * 3 * sizeof(float) };
+    } });
+    cases.push_back({ "quantize uv", 12, [&](size_t n) {
+        const float uvLo[2] = { -2.0f, -2.0f }, uvScale[2] = { 65535.0f / 4.0f, 65535.0f / 4.0f };
+        geom_quantize_unorm16(uvs.data(), n, 2, uvLo, uvScale, u16Out.data());
+        return KernelOutput{ u16Out.data(), n * 2 * sizeof(uint16_t) };
+    } });
+    cases.push_back({ "oct_encode", 16, [&](size_t n) {
+        geom_oct_encode(normals.data(), n, i16Out.data());
+        return KernelOutput{ i16Out.data(), n * 2 * sizeof(int16_t) };
+    } });
+    cases.push_back({ "interleave", 64, [&](size_t n) {
+        const VertexStream streams[3] = { { &positions[0].x, 3 }, { &normals[0].x, 3 }, { uvs.data(), 2 } };
+        geom_interleave(streams, 3, n, floatOut.data());
+        return KernelOutput{ floatOut.data(), n * 8 * sizeof(float) };
+    } });
+
+    const SimdLevel best = simd_detected_level();
+    std::cout << "bench-kernels " << count << " elements, best of " << iterations << ", detected "
+              << simd_level_name(best) << "\n";
+    bool allSame = true;
+    for (const KernelCase& kc : cases) {
+        // reference outputs: the full array plus every small size so each tail length is covered
+        simd_set_level(SimdLevel::Scalar);
+        const std::vector<unsigned char> reference = to_bytes(kc.run(count));
+        std::vector<std::vector<unsigned char>> small;
+        for (size_t n = 1; n <= std::min<size_t>(count, 40); ++n) small.push_back(to_bytes(kc.run(n)));
+
+        double scalarMs = 0.0;
+        for (int level = 0; level <= (int)best; ++level) {
+            simd_set_level(SimdLevel(level));
+            bool same = same_bytes(kc.run(count), reference);
+            for (size_t n = 1; n <= small.size(); ++n) same = same && same_bytes(kc.run(n), small[n - 1]);
+
+            double bestMs = 1e30;
+            for (int i = 0; i < iterations; ++i) {
+                const auto t0 = std::chrono::steady_clock::now();
+                kc.run(count);
+                bestMs = std::min(bestMs, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count());
+            }
+            if (level == 0) scalarMs = bestMs;
+            allSame = allSame && same;
+
+            std::cout << std::left << std::setw(14) << kc.name << std::setw(8) << simd_level_name(SimdLevel(level))
+                      << std::right << std::fixed << std::setprecision(3) << std::setw(9) << bestMs << " ms"
+                      << std::setprecision(2) << std::setw(8) << double(count * kc.bytesPerElement) / (bestMs * 1.0e6) << " GB/s"
+                      << "  x" << scalarMs / std::max(bestMs, 1e-9)
+                      << (same ? "  exact" : "  MISMATCH") << "\n";
+        }
+    }
+    simd_set_level(best);
+
+    // octahedral round trip stays within the snorm16 quantization error
+    float worst = 1.0f;
+    std::vector<int16_t> oct(count * 2);
+    geom_oct_encode(normals.data(), count, oct.data());
+    for (size_t i = 0; i < count; ++i) {
+        const float len = glm::length(normals[i]);
+        if (len == 0.0f) continue;
+        worst = std::min(worst, glm::dot(normals[i] / len, geom_oct_decode(oct[i * 2], oct[i * 2 + 1])));
+    }
+    std::cout << "oct round trip worst cos " << std::setprecision(7) << worst << (worst > 0.99999f ? "" : "  TOO LOSSY") << "\n";
+
+    return (allSame && worst > 0.99999f) ? 0 : 1;
+}
+
+// ---------------------------------------------------------------------------------------------
+// inspect: one CSV row per model under a directory
+
+// quoted when needed, "" for embedded quotes
+static std::string csv_field(const std::string& s)
+{
+    if (s.find_first_of(",\"\n") == std::string::npos) return s;
+    std::string out = "\"";
+    for (char c : s) { if (c == '"') out += '"'; out += c; }
+    return out + "\"";
+}
+
+// the leading path,bytes,mtime of a report line, undoing csv_field
+static bool csv_key(const std::string& line, std::string& key)
+{
+    std::string path;
+    size_t i = 0;
+    if (!line.empty() && line[0] == '"') {
+        for (i = 1; i < line.size(); ++i) {
+            if (line[i] != '"') { path += line[i]; continue; }
+            if (i + 1 < line.size() && line[i + 1] == '"') { path += '"'; ++i; continue; }
+            ++i;
+            break;
+        }
+    } else {
+        i = line.find(',');
+        if (i == std::string::npos) return false;
+        path = line.substr(0, i);
+    }
+    if (i >= line.size() || line[i] != ',') return false;
+    const size_t bytesEnd = line.find(',', i + 1);
+    const size_t timeEnd = bytesEnd == std::string::npos ? std::string::npos : line.find(',', bytesEnd + 1);
+    if (timeEnd == std::string::npos) return false;
+    key = csv_field(path) + line.substr(i, timeEnd - i);
+    return true;
+}
+
+int run_library_inspection(int argc, char** argv)
+{
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " --inspect <dir> [report.csv]\n";
+        return 2;
+    }
+    const std::filesystem::path root = argv[2];
+    const std::string reportPath = (argc > 3) ? argv[3] : "inspect.csv";
+
+    std::vector<std::filesystem::path> files;
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(root, ec); !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+        std::string ext = it->path().extension().string();
+        for (auto& c : ext) c = static_cast<char>(std::tolower((unsigned char)c));
+        if (ext == ".obj" || ext == ".fbx" || ext == ".dae" || ext == ".gltf" || ext == ".glb" || ext == ".ply" || ext == ".stl") {
+            files.push_back(it->path());
+        }
+    }
+    if (ec) {
+        std::cerr << "inspect: cannot read " << root.string() << "\n";
+        return 1;
+    }
+    std::sort(files.begin(), files.end());
+
+    // rows of an earlier report are reused for files whose size and mtime did not change
+    std::unordered_map<std::string, std::string> previous;
+    const std::string header = "path,bytes,mtime," + mesh_inspection_csv_header();
+    {
+        std::ifstream in(reportPath);
+        std::string line;
+        if (std::getline(in, line) && line == header) {
+            while (std::getline(in, line)) {
+                std::string key;
+                if (csv_key(line, key)) previous[key] = line;
+            }
+        }
+    }
+
+    struct Row {
+        std::string key;
+        std::string line;     // empty when the load failed
+        bool reused = false;
+        double seconds = 0.0;
+    };
+    std::vector<Row> rows(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        const uint64_t bytes = std::filesystem::file_size(files[i], ec);
+        const auto written = std::chrono::file_clock::to_sys(std::filesystem::last_write_time(files[i], ec));
+        const long long mtime = std::chrono::duration_cast<std::chrono::seconds>(written.time_since_epoch()).count();
+        rows[i].key = csv_field(files[i].string()) + "," + std::to_string(bytes) + "," + std::to_string(mtime);
+        auto it = previous.find(rows[i].key);
+        if (it != previous.end()) { rows[i].line = it->second; rows[i].reused = true; }
+    }
+
+    // a few models in flight on the pool; each load and inspection fans out further on its own
+    ThreadPool& pool = globalThreadPool();
+    const size_t inFlight = std::max<size_t>(1, std::min<size_t>(4, pool.size() / 2));
+    std::vector<std::future<void>> running;
+    const auto start = std::chrono::steady_clock::now();
+    size_t inspected = 0, failed = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (rows[i].reused) continue;
+        if (running.size() >= inFlight) { running.front().get(); running.erase(running.begin()); }
+        running.push_back(pool.submit([&rows, &files, i]() {
+            MeshData mesh;
+            if (!load_model(files[i].string(), mesh, nullptr)) return;
+            const MeshInspection r = inspect_mesh(mesh);
+            rows[i].line = rows[i].key + "," + mesh_inspection_csv_row(r);
+            rows[i].seconds = mesh.timings.totalSeconds + r.seconds;
+        }));
+    }
+    for (auto& f : running) f.get();
+
+    std::ofstream out(reportPath, std::ios::trunc);
+    if (!out) {
+        std::cerr << "inspect: cannot write " << reportPath << "\n";
+        return 1;
+    }
+    out << header << "\n";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (rows[i].line.empty()) {
+            std::cerr << "inspect: failed to load " << files[i].string() << "\n";
+            ++failed;
+            continue;
+        }
+        if (!rows[i].reused) ++inspected;
+        out << rows[i].line << "\n";
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "inspect: " << files.size() << " models, " << inspected << " inspected, "
+              << (files.size() - inspected - failed) << " unchanged, " << failed << " failed in "
+              << std::fixed << std::setprecision(1) << seconds << " s -> " << reportPath << "\n";
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// bench.h
+// Command-line tools, run without a window:
+//   splender_gl --bench-load <model> [iterations] [--per-thread]
+//                                                    per-stage timings and perf counters per loader variant
+//   splender_gl --bench-kernels [count] [iterations]  geometry kernels per SIMD level
+//   splender_gl --inspect <dir> [report.csv]          mesh metrics (inspector.h) for every model
+
+// both return a process exit code (non-zero when variants disagree)
+int run_load_benchmark(int argc, char** argv);
+int run_kernel_benchmark(int argc, char** argv);
+
+// Writes one CSV row per model found under dir (default report: inspect.csv). Rows of an existing
+// report are kept for files whose size and mtime are unchanged. Non-zero when a model failed to load.
+int run_library_inspection(int argc, char** argv);
@@ -0,0 +1,407 @@
+// debugview.cpp
+// Implements DebugViewRenderer declared in debugview.h
+
+#include "debugview.h"
+
+#include <initializer_list>
+#include <iostream>
+#include <string>
+
+#include <glm/gtc/type_ptr.hpp>
+
+// layout of the totals buffer shared by both counter passes
+enum : GLuint {
+    kFragments = 0,
+    kCovered = 1,
+    kHot = 2,
+    kInView = 3,
+    kBuckets = 4,   // 5 area buckets
+    kTotalsCount = 9
+};
+
+static const float kHotCount = 4.0f; // layers / lines per pixel counted as hot
+
+static const char* count_vs_src = R"GLSL(
+#version 330 core
+layout(location=0) in vec3 aPos;
+uniform mat4 uMVP;
+void main(){ gl_Position = uMVP * vec4(aPos, 1.0); }
+)GLSL";
+
+static const char* count_fs_src = R"GLSL(
+#version 330 core
+out vec4 fragColor;
+void main(){ fragColor = vec4(1.0); }
+)GLSL";
+
+// fullscreen triangle
+static const char* heat_vs_src = R"GLSL(
+#version 330 core
+void main(){
+    vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);
+}
+)GLSL";
+
+// blue (1) -> cyan -> green -> yellow -> red (1 + uScale and more)
+static const char* heat_fs_src = R"GLSL(
+#version 330 core
+uniform sampler2D uCounts;
+uniform float uScale;
+out vec4 fragColor;
+vec3 ramp(float t){ return clamp(vec3(1.5 - abs(4.0 * t - 3.0), 1.5 - abs(4.0 * t - 2.0), 1.5 - abs(4.0 * t - 1.0)), 0.0, 1.0); }
+void main(){
+    float n = texelFetch(uCounts, ivec2(gl_FragCoord.xy), 0).r;
+    if (n < 0.5) discard;
+    fragColor = vec4(ramp(clamp((n - 1.0) / uScale, 0.0, 1.0)), 1.0);
+}
+)GLSL";
+
+static const char* tri_gs_src = R"GLSL(
+#version 330 core
+layout(triangles) in;
+layout(triangle_strip, max_vertices = 3) out;
+uniform vec2 uViewport;
+flat out float gArea;
+void main(){
+    vec4 a = gl_in[0].gl_Position, b = gl_in[1].gl_Position, c = gl_in[2].gl_Position;
+    if (a.w <= 0.0 || b.w <= 0.0 || c.w <= 0.0) {
+        gArea = 1.0e6; // crosses the eye plane, draw as large
+    } else {
+        vec2 sa = a.xy / a.w * 0.5 * uViewport, sb = b.xy / b.w * 0.5 * uViewport, sc = c.xy / c.w * 0.5 * uViewport;
+        vec2 e0 = sb - sa, e1 = sc - sa;
+        gArea = 0.5 * abs(e0.x * e1.y - e0.y * e1.x);
+    }
+    for (int i = 0; i < 3; ++i) { gl_Position = gl_in[i].gl_Position; EmitVertex(); }
+    EndPrimitive();
+}
+)GLSL";
+
+// red below a pixel, through yellow and green to blue at 4096 px and up
+static const char* tri_fs_src = R"GLSL(
+#version 330 core
+flat in float gArea;
+out vec4 fragColor;
+vec3 ramp(float t){ return clamp(vec3(1.5 - abs(4.0 * t - 3.0), 1.5 - abs(4.0 * t - 2.0), 1.5 - abs(4.0 * t - 1.0)), 0.0, 1.0); }
+void main(){
+    float t = clamp(log2(max(gArea, 1.0)) / 12.0, 0.0, 1.0);
+    fragColor = vec4(ramp(1.0 - t), 1.0);
+}
+)GLSL";
+
+static const char* reduce_cs_src = R"GLSL(
+#version 430 core
+layout(local_size_x = 16, local_size_y = 16) in;
+layout(r32f, binding = 0) readonly uniform image2D uCounts;
+layout(std430, binding = 0) buffer Totals { uint totals[]; };
+uniform float uHot;
+shared uint sFragments, sCovered, sHot;
+void main(){
+    if (gl_LocalInvocationIndex == 0u) { sFragments = 0u; sCovered = 0u; sHot = 0u; }
+    barrier();
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    if (all(lessThan(p, imageSize(uCounts)))) {
+        float n = imageLoad(uCounts, p).r;
+        if (n >= 0.5) {
+            atomicAdd(sFragments, uint(n + 0.5));
+            atomicAdd(sCovered, 1u);
+            if (n >= uHot) atomicAdd(sHot, 1u);
+        }
+    }
+    barrier();
+    if (gl_LocalInvocationIndex == 0u) {
+        atomicAdd(totals[0], sFragments);
+        atomicAdd(totals[1], sCovered);
+        atomicAdd(totals[2], sHot);
+    }
+}
+)GLSL";
+
+// every triangle of the index buffer, whichever way it faces
+static const char* tri_count_cs_src = R"GLSL(
+#version 430 core
+layout(local_size_x = 256) in;
+layout(std430, binding = 0) buffer Totals { uint totals[]; };
+layout(std430, binding = 1) readonly buffer Verts { float verts[]; };
+layout(std430, binding = 2) readonly buffer Indices { uint indices[]; };
+uniform uint uTriCount;
+uniform uint uStride;
+uniform mat4 uMVP;
+uniform vec2 uViewport;
+shared uint sInView, sBuckets[5];
+vec4 clipPos(uint i){ uint o = indices[i] * uStride; return uMVP * vec4(verts[o], verts[o + 1u], verts[o + 2u], 1.0); }
+void main(){
+    if (gl_LocalInvocationIndex < 5u) sBuckets[gl_LocalInvocationIndex] = 0u;
+    if (gl_LocalInvocationIndex == 0u) sInView = 0u;
+    barrier();
+    uint t = gl_GlobalInvocationID.x;
+    if (t < uTriCount) {
+        vec4 a = clipPos(3u * t), b = clipPos(3u * t + 1u), c = clipPos(3u * t + 2u);
+        bool outside = false;
+        for (int k = 0; k < 3; ++k) {
+            outside = outside || (a[k] > a.w && b[k] > b.w && c[k] > c.w) || (a[k] < -a.w && b[k] < -b.w && c[k] < -c.w);
+        }
+        // triangles through the eye plane have no meaningful size, leave them out
+        if (!outside && a.w > 0.0 && b.w > 0.0 && c.w > 0.0) {
+            vec2 sa = a.xy / a.w * 0.5 * uViewport, sb = b.xy / b.w * 0.5 * uViewport, sc = c.xy / c.w * 0.5 * uViewport;
+            vec2 e0 = sb - sa, e1 = sc - sa;
+            float area = 0.5 * abs(e0.x * e1.y - e0.y * e1.x);
+            uint bucket = area < 1.0 ? 0u : area < 4.0 ? 1u : area < 16.0 ? 2u : area < 64.0 ? 3u : 4u;
+            atomicAdd(sInView, 1u);
+            atomicAdd(sBuckets[bucket], 1u);
+        }
+    }
+    barrier();
+    if (gl_LocalInvocationIndex == 0u) atomicAdd(totals[3], sInView);
+    if (gl_LocalInvocationIndex < 5u) atomicAdd(totals[4u + gl_LocalInvocationIndex], sBuckets[gl_LocalInvocationIndex]);
+}
+)GLSL";
+
+static GLuint link_shaders(std::initializer_list<GLuint> shaders) {
+    for (GLuint s : shaders) if (!s) { for (GLuint d : shaders) if (d) glDeleteShader(d); return 0; }
+    GLuint p = glCreateProgram();
+    for (GLuint s : shaders) glAttachShader(p, s);
+    glLinkProgram(p);
+    for (GLuint s : shaders) glDeleteShader(s);
+    GLint ok = 0; glGetProgramiv(p, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        GLint len = 0; glGetProgramiv(p, GL_INFO_LOG_LENGTH, &len);
+        std::string log(len ? len : 1, '\0');
+        glGetProgramInfoLog(p, len, nullptr, &log[0]);
+        std::cerr << "Debug view program link error:\n" << log << "\n";
+        glDeleteProgram(p);
+        return 0;
+    }
+    return p;
+}
+
+// same culling rule as Renderer::drawModelBatches so the counts match what the shaded view draws
+static void draw_batches(GLuint vao, const std::vector<DrawBatch>& batches, bool cullClosed) {
+    glBindVertexArray(vao);
+    glCullFace(GL_BACK);
+    glFrontFace(GL_CCW);
+    bool culling = false;
+    for (const DrawBatch& b : batches) {
+        bool wantCull = cullClosed && b.cullBackfaces;
+        if (wantCull != culling) {
+            if (wantCull) glEnable(GL_CULL_FACE); else glDisable(GL_CULL_FACE);
+            culling = wantCull;
+        }
+        glDrawElements(GL_TRIANGLES, b.indexCount, GL_UNSIGNED_INT, (void*)(b.firstIndex * sizeof(unsigned int)));
+    }
+    if (culling) glDisable(GL_CULL_FACE);
+    glBindVertexArray(0);
+}
+
+bool DebugViewRenderer::init() {
+    count_prog_ = link_shaders({ Renderer::compile_shader(GL_VERTEX_SHADER, count_vs_src),
+                                 Renderer::compile_shader(GL_FRAGMENT_SHADER, count_fs_src) });
+    heat_prog_ = link_shaders({ Renderer::compile_shader(GL_VERTEX_SHADER, heat_vs_src),
+                                Renderer::compile_shader(GL_FRAGMENT_SHADER, heat_fs_src) });
+    tri_prog_ = link_shaders({ Renderer::compile_shader(GL_VERTEX_SHADER, count_vs_src),
+                               Renderer::compile_shader(GL_GEOMETRY_SHADER, tri_gs_src),
+                               Renderer::compile_shader(GL_FRAGMENT_SHADER, tri_fs_src) });
+    glGenVertexArrays(1, &empty_vao_);
+#ifdef GL_VERSION_4_3
+    if (GLAD_GL_VERSION_4_3) {
+        reduce_prog_ = link_shaders({ Renderer::compile_shader(GL_COMPUTE_SHADER, reduce_cs_src) });
+        tri_count_prog_ = link_shaders({ Renderer::compile_shader(GL_COMPUTE_SHADER, tri_count_cs_src) });
+        if (!reduce_prog_ || !tri_count_prog_) {
+            if (reduce_prog_) { glDeleteProgram(reduce_prog_); reduce_prog_ = 0; }
+            if (tri_count_prog_) { glDeleteProgram(tri_count_prog_); tri_count_prog_ = 0; }
+        } else {
+            glGenBuffers(1, &totals_buf_);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, totals_buf_);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, kTotalsCount * sizeof(GLuint), nullptr, GL_DYNAMIC_READ);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        }
+    }
+#endif
+    metrics_.supported = hasCounters();
+    return count_prog_ && heat_prog_ && tri_prog_;
+}
+
+void DebugViewRenderer::setModel(GLuint vbo, GLuint ebo, GLuint linesEbo, size_t vertexStride, size_t indexCount, size_t lineCount) {
+    vbo_ = vbo;
+    ebo_ = ebo;
+    lines_ebo_ = linesEbo;
+    vertex_stride_ = vertexStride;
+    index_count_ = indexCount;
+    line_count_ = lineCount;
+}
+
+void DebugViewRenderer::release() {
+    vbo_ = ebo_ = lines_ebo_ = 0;
+    index_count_ = line_count_ = 0;
+}
+
+void DebugViewRenderer::ensureTarget(int width, int height) {
+    if (count_fbo_ && width == width_ && height == height_) return;
+    if (count_fbo_) { glDeleteFramebuffers(1, &count_fbo_); count_fbo_ = 0; }
+    if (count_tex_) { glDeleteTextures(1, &count_tex_); count_tex_ = 0; }
+    width_ = width; height_ = height;
+
+    glGenTextures(1, &count_tex_);
+    glBindTexture(GL_TEXTURE_2D, count_tex_);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, width, height, 0, GL_RED, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glGenFramebuffers(1, &count_fbo_);
+    glBindFramebuffer(GL_FRAMEBUFFER, count_fbo_);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, count_tex_, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) std::cerr << "debug view count target incomplete\n";
+}
+
+void DebugViewRenderer::draw(DebugView mode, GLuint vao, const std::vector<DrawBatch>& batches, const glm::mat4& mvp,
+                             int width, int height, bool cullClosed, GLuint targetFbo) {
+    if (mode != metrics_.mode) {
+        metrics_ = DebugViewMetrics{};
+        metrics_.mode = mode;
+        metrics_.supported = hasCounters();
+    }
+    collectMetrics();
+    if (mode == DebugView::Off || !vao || width <= 0 || height <= 0) return;
+
+    if (mode == DebugView::TriangleSize) {
+        drawTriangleSizes(vao, batches, mvp, width, height, cullClosed);
+    } else {
+        ensureTarget(width, height);
+        drawCounts(mode, vao, batches, mvp, cullClosed);
+        drawHeatmap(mode == DebugView::Overdraw ? 8.0f : 16.0f, targetFbo);
+    }
+    startCount(mode, mvp, width, height);
+    glBindFramebuffer(GL_FRAMEBUFFER, targetFbo);
+}
+
+void DebugViewRenderer::drawCounts(DebugView mode, GLuint vao, const std::vector<DrawBatch>& batches, const glm::mat4& mvp, bool cullClosed) {
+    glBindFramebuffer(GL_FRAMEBUFFER, count_fbo_);
+    glViewport(0, 0, width_, height_);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+
+    glUseProgram(count_prog_);
+    glUniformMatrix4fv(glGetUniformLocation(count_prog_, "uMVP"), 1, GL_FALSE, glm::value_ptr(mvp));
+    if (mode == DebugView::Overdraw) {
+        draw_batches(vao, batches, cullClosed);
+    } else if (lines_ebo_ && line_count_ > 0) {
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lines_ebo_);
+        glDrawElements(GL_LINES, (GLsizei)line_count_, GL_UNSIGNED_INT, nullptr);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+        glBindVertexArray(0);
+    }
+    glUseProgram(0);
+
+    // app defaults
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_DEPTH_TEST);
+}
+
+void DebugViewRenderer::drawHeatmap(float scale, GLuint targetFbo) {
+    glBindFramebuffer(GL_FRAMEBUFFER, targetFbo);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glUseProgram(heat_prog_);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, count_tex_);
+    glUniform1i(glGetUniformLocation(heat_prog_, "uCounts"), 0);
+    glUniform1f(glGetUniformLocation(heat_prog_, "uScale"), scale);
+    glBindVertexArray(empty_vao_);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+    glEnable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+}
+
+void DebugViewRenderer::drawTriangleSizes(GLuint vao, const std::vector<DrawBatch>& batches, const glm::mat4& mvp,
+                                          int width, int height, bool cullClosed) {
+    glUseProgram(tri_prog_);
+    glUniformMatrix4fv(glGetUniformLocation(tri_prog_, "uMVP"), 1, GL_FALSE, glm::value_ptr(mvp));
+    glUniform2f(glGetUniformLocation(tri_prog_, "uViewport"), (float)width, (float)height);
+    glEnable(GL_DEPTH_TEST);
+    draw_batches(vao, batches, cullClosed);
+    glUseProgram(0);
+}
+
+// Queue the counter pass for this frame's image unless the previous one is still in flight.
+void DebugViewRenderer::startCount(DebugView mode, const glm::mat4& mvp, int width, int height) {
+#ifdef GL_VERSION_4_3
+    if (!hasCounters() || totals_fence_) return;
+    if (mode == DebugView::TriangleSize && (!vbo_ || !ebo_ || index_count_ < 3)) return;
+    const GLuint zero[kTotalsCount] = {};
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, totals_buf_);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(zero), zero);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, totals_buf_);
+
+    if (mode == DebugView::TriangleSize) {
+        const GLuint triCount = (GLuint)(index_count_ / 3);
+        glUseProgram(tri_count_prog_);
+        glUniform1ui(glGetUniformLocation(tri_count_prog_, "uTriCount"), triCount);
+        glUniform1ui(glGetUniformLocation(tri_count_prog_, "uStride"), (GLuint)vertex_stride_);
+        glUniformMatrix4fv(glGetUniformLocation(tri_count_prog_, "uMVP"), 1, GL_FALSE, glm::value_ptr(mvp));
+        glUniform2f(glGetUniformLocation(tri_count_prog_, "uViewport"), (float)width, (float)height);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, vbo_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, ebo_);
+        glDispatchCompute((triCount + 255) / 256, 1, 1);
+    } else {
+        glUseProgram(reduce_prog_);
+        glUniform1f(glGetUniformLocation(reduce_prog_, "uHot"), kHotCount);
+        glBindImageTexture(0, count_tex_, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+        glDispatchCompute((GLuint)(width_ + 15) / 16, (GLuint)(height_ + 15) / 16, 1);
+        glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+    }
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    for (GLuint b = 0; b < 3; ++b) glBindBufferBase(GL_SHADER_STORAGE_BUFFER, b, 0);
+    glUseProgram(0);
+    totals_fence_ = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pending_mode_ = mode;
+    metrics_.pixels = (uint64_t)width * (uint64_t)height;
+#else
+    (void)mode; (void)mvp; (void)width; (void)height;
+#endif
+}
+
+// read the totals once their fence passed, never wait for it
+void DebugViewRenderer::collectMetrics() {
+#ifdef GL_VERSION_4_3
+    if (!totals_fence_) return;
+    const GLenum state = glClientWaitSync(totals_fence_, 0, 0);
+    if (state != GL_ALREADY_SIGNALED && state != GL_CONDITION_SATISFIED) return;
+    glDeleteSync(totals_fence_);
+    totals_fence_ = nullptr;
+    if (pending_mode_ != metrics_.mode) return; // view switched meanwhile
+
+    GLuint totals[kTotalsCount] = {};
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, totals_buf_);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(totals), totals);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    metrics_.fragments = totals[kFragments];
+    metrics_.coveredPixels = totals[kCovered];
+    metrics_.hotPixels = totals[kHot];
+    metrics_.trianglesInView = totals[kInView];
+    for (int i = 0; i < 5; ++i) metrics_.sizeBuckets[i] = totals[kBuckets + i];
+    metrics_.measured = true;
+#endif
+}
+
+void DebugViewRenderer::shutdownCleanup() {
+    release();
+    if (totals_fence_) { glDeleteSync(totals_fence_); totals_fence_ = nullptr; }
+    if (count_prog_) { glDeleteProgram(count_prog_); count_prog_ = 0; }
+    if (heat_prog_) { glDeleteProgram(heat_prog_); heat_prog_ = 0; }
+    if (tri_prog_) { glDeleteProgram(tri_prog_); tri_prog_ = 0; }
+    if (reduce_prog_) { glDeleteProgram(reduce_prog_); reduce_prog_ = 0; }
+    if (tri_count_prog_) { glDeleteProgram(tri_count_prog_); tri_count_prog_ = 0; }
+    if (empty_vao_) { glDeleteVertexArrays(1, &empty_vao_); empty_vao_ = 0; }
+    if (totals_buf_) { glDeleteBuffers(1, &totals_buf_); totals_buf_ = 0; }
+    if (count_fbo_) { glDeleteFramebuffers(1, &count_fbo_); count_fbo_ = 0; }
+    if (count_tex_) { glDeleteTextures(1, &count_tex_); count_tex_ = 0; }
+    width_ = height_ = 0;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+// debugview.h
+// Diagnostic views of the model (overdraw, triangle size, wire density) with GPU-counted metrics.
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "renderer.h"
+
+enum class DebugView {
+    Off,
+    Overdraw,       // fragments per pixel, depth test off, additive
+    TriangleSize,   // projected area of each triangle in pixels
+    WireDensity     // unique edges per pixel, additive
+};
+
+// Numbers behind the current view, counted on the GPU (GL 4.3 compute) and read back a frame or so
+// later without stalling. measured stays false before the first readback or without compute.
+struct DebugViewMetrics {
+    DebugView mode = DebugView::Off;
+    bool supported = false;        // GL 4.3 counters available
+    bool measured = false;
+    uint64_t pixels = 0;           // viewport size
+    // overdraw / wire density
+    uint64_t fragments = 0;        // fragments (overdraw) or line pixels (wire) written
+    uint64_t coveredPixels = 0;
+    uint64_t hotPixels = 0;        // covered pixels reaching 4 layers / lines
+    // triangle size: triangles inside the frustum by projected area < 1, < 4, < 16, < 64, >= 64 px
+    uint64_t trianglesInView = 0;
+    uint64_t sizeBuckets[5] = {};
+};
+
+// Count views render the model into an R32F target with additive blending, then a fullscreen pass
+// maps counts to a heat ramp in the caller's framebuffer. A compute pass sums the target (shared
+// memory per 16x16 tile, then one atomic per tile). Triangle size is drawn with a geometry shader
+// that colours each triangle by its screen area; a compute pass over the index buffer buckets them.
+class DebugViewRenderer {
+public:
+    DebugViewRenderer() = default;
+    ~DebugViewRenderer() = default;
+
+    // compile programs (needs a current context); the counters need GL 4.3
+    bool init();
+
+    // current model buffers (not owned). vertexStride is in floats, position first.
+    void setModel(GLuint vbo, GLuint ebo, GLuint linesEbo, size_t vertexStride, size_t indexCount, size_t lineCount);
+    void release();
+
+    // draw `mode` in place of the shaded model into targetFbo (bound on return, viewport width x height)
+    void draw(DebugView mode, GLuint vao, const std::vector<DrawBatch>& batches, const glm::mat4& mvp,
+              int width, int height, bool cullClosed, GLuint targetFbo);
+
+    const DebugViewMetrics& metrics() const { return metrics_; }
+    bool hasCounters() const { return reduce_prog_ != 0; }
+
+    void shutdownCleanup();
+
+private:
+    void ensureTarget(int width, int height);
+    void drawCounts(DebugView mode, GLuint vao, const std::vector<DrawBatch>& batches, const glm::mat4& mvp, bool cullClosed);
+    void drawHeatmap(float scale, GLuint targetFbo);
+    void drawTriangleSizes(GLuint vao, const std::vector<DrawBatch>& batches, const glm::mat4& mvp,
+                           int width, int height, bool cullClosed);
+    void collectMetrics();
+    void startCount(DebugView mode, const glm::mat4& mvp, int width, int height);
+
+    GLuint count_prog_ = 0;    // writes 1 per fragment
+    GLuint heat_prog_ = 0;     // fullscreen count -> colour
+    GLuint tri_prog_ = 0;      // geometry shader area view
+    GLuint reduce_prog_ = 0;   // sums the count target
+    GLuint tri_count_prog_ = 0; // buckets triangles by area
+    GLuint empty_vao_ = 0;
+
+    GLuint count_fbo_ = 0;
+    GLuint count_tex_ = 0;
+    int width_ = 0, height_ = 0;   // of the count target
+
+    GLuint totals_buf_ = 0;
+    GLsync totals_fence_ = nullptr;
+    DebugView pending_mode_ = DebugView::Off;
+
+    GLuint vbo_ = 0, ebo_ = 0, lines_ebo_ = 0;
+    size_t vertex_stride_ = 0;
+    size_t index_count_ = 0;
+    size_t line_count_ = 0;
+
+    DebugViewMetrics metrics_;
+};
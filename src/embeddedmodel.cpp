@@ -0,0 +1,20 @@
+// embeddedmodel.cpp
+// Implements embedded_default_model declared in embeddedmodel.h
+
+#include "embeddedmodel.h"
+
+// generated at build time by splender_bake (see CMakeLists.txt)
+#include "default_model.h"
+
+const EmbeddedModel& embedded_default_model()
+{
+    static const EmbeddedModel model = {
+        default_model::source,
+        default_model::vertices, default_model::vertexCount, default_model::stride, default_model::flatShaded,
+        default_model::indices, default_model::indexCount,
+        default_model::batches, default_model::batchCount,
+        default_model::edgeLines, default_model::edgeLineCount, default_model::featureLineCount,
+        default_model::silhouetteEdges, default_model::silhouetteEdgeCount,
+    };
+    return model;
+}
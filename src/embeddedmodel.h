@@ -0,0 +1,37 @@
+#pragma once
+
+// embeddedmodel.h
+// Meshes compiled into the binary (the default startup model), already in upload layout.
+
+#include <cstddef>
+
+// One draw range of an embedded model with its flat material colour
+struct EmbeddedBatch {
+    unsigned int firstIndex;
+    unsigned int indexCount;
+    float r, g, b, opacity;
+    bool cullBackfaces;
+};
+
+// Same data uploadMesh derives from a MeshData, baked by splender_bake: vertices interleaved as
+// pos/normal/uv (stride 8) or pos/uv (stride 5, flatShaded), triangles sorted by batch, feature
+// edges first in edgeLines. Arrays are static storage; counts of 0 mean empty.
+struct EmbeddedModel {
+    const char* source;                  // asset the model was baked from
+    const float* vertices;
+    size_t vertexCount;
+    unsigned int stride;                 // floats per vertex
+    bool flatShaded;
+    const unsigned int* indices;
+    size_t indexCount;
+    const EmbeddedBatch* batches;
+    size_t batchCount;
+    const unsigned int* edgeLines;
+    size_t edgeLineCount;
+    size_t featureLineCount;
+    const unsigned int* silhouetteEdges; // 4 per edge, see MeshData::silhouetteEdges
+    size_t silhouetteEdgeCount;          // in unsigned ints
+};
+
+// assets/splender.obj as loaded with default LoadOptions at build time
+const EmbeddedModel& embedded_default_model();
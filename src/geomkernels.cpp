@@ -0,0 +1,704 @@
+// geomkernels.cpp
+// Implements the kernels declared in geomkernels.h
+
+#include "geomkernels.h"
+#include "threadpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+  #define SPLENDER_GEOM_X86 1
+  #include <immintrin.h>
+  #if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+    #define GEOM_SSE41
+    #define GEOM_AVX2
+  #else
+    // per-function targets so the rest of the build keeps its baseline ISA
+    #define GEOM_SSE41 __attribute__((target("sse4.1")))
+    #define GEOM_AVX2 __attribute__((target("avx2")))
+  #endif
+#endif
+
+static const size_t kGrain = 32768; // elements per pool chunk
+
+// ---------------------------------------------------------------------------------------------
+// scalar reference. Vector variants must match these operation for operation.
+
+static void bounds_scalar(const float* p, size_t n, float mn[3], float mx[3])
+{
+    for (size_t i = 0; i < n; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            const float v = p[i * 3 + c];
+            mn[c] = v < mn[c] ? v : mn[c];
+            mx[c] = v > mx[c] ? v : mx[c];
+        }
+    }
+}
+
+// flat float index f has component f % comps
+static void mad_scalar(float* f, size_t floats, unsigned comps, const float* scale, const float* offset)
+{
+    for (size_t i = 0; i < floats; ++i) f[i] = f[i] * scale[i % comps] + offset[i % comps];
+}
+
+static void transform_scalar(float* p, size_t n, const float* m)
+{
+    for (size_t i = 0; i < n; ++i, p += 3) {
+        const float x = p[0], y = p[1], z = p[2];
+        p[0] = ((m[0] * x + m[4] * y) + m[8] * z) + m[12];
+        p[1] = ((m[1] * x + m[5] * y) + m[9] * z) + m[13];
+        p[2] = ((m[2] * x + m[6] * y) + m[10] * z) + m[14];
+    }
+}
+
+static void normalize_scalar(float* p, size_t n)
+{
+    for (size_t i = 0; i < n; ++i, p += 3) {
+        const float len2 = (p[0] * p[0] + p[1] * p[1]) + p[2] * p[2];
+        if (len2 > 0.0f) {
+            const float inv = 1.0f / std::sqrt(len2);
+            p[0] *= inv; p[1] *= inv; p[2] *= inv;
+        } else {
+            p[0] = p[1] = p[2] = 0.0f;
+        }
+    }
+}
+
+static void quantize_scalar(const float* src, size_t floats, unsigned comps, const float* lo, const float* scale, uint16_t* dst)
+{
+    for (size_t i = 0; i < floats; ++i) {
+        float t = (src[i] - lo[i % comps]) * scale[i % comps];
+        t = t > 0.0f ? t : 0.0f;
+        t = t < 65535.0f ? t : 65535.0f;
+        dst[i] = (uint16_t)std::lrintf(t);
+    }
+}
+
+static void dequantize_scalar(const uint16_t* src, size_t floats, unsigned comps, const float* lo, const float* step, float* dst)
+{
+    for (size_t i = 0; i < floats; ++i) dst[i] = lo[i % comps] + float(src[i]) * step[i % comps];
+}
+
+static void oct_encode_scalar(const float* n, size_t count, int16_t* dst)
+{
+    for (size_t i = 0; i < count; ++i, n += 3, dst += 2) {
+        const float l1 = (std::fabs(n[0]) + std::fabs(n[1])) + std::fabs(n[2]);
+        float u = 0.0f, v = 0.0f;
+        if (l1 > 0.0f) {
+            u = n[0] / l1;
+            v = n[1] / l1;
+            if (n[2] < 0.0f) {
+                const float fu = (1.0f - std::fabs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+                const float fv = (1.0f - std::fabs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+                u = fu; v = fv;
+            }
+        }
+        u = u > -1.0f ? u : -1.0f; u = u < 1.0f ? u : 1.0f;
+        v = v > -1.0f ? v : -1.0f; v = v < 1.0f ? v : 1.0f;
+        dst[0] = (int16_t)std::lrintf(u * 32767.0f);
+        dst[1] = (int16_t)std::lrintf(v * 32767.0f);
+    }
+}
+
+#ifdef SPLENDER_GEOM_X86
+
+// ---------------------------------------------------------------------------------------------
+// SSE4.1: 4 vertices per step. xyz triples are transposed in registers (12 floats -> x, y, z)
+
+GEOM_SSE41 static inline void aos_to_soa(__m128 a, __m128 b, __m128 c, __m128& x, __m128& y, __m128& z)
+{
+    // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+    const __m128 t0 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2)); // x2 y2 x3 y3
+    const __m128 t1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1)); // y0 z0 y1 z1
+    x = _mm_shuffle_ps(a, t0, _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm_shuffle_ps(t1, t0, _MM_SHUFFLE(3, 1, 2, 0));
+    const __m128 t2 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)); // z0 z0 z1 z1
+    const __m128 t3 = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)); // z2 z2 z3 z3
+    z = _mm_shuffle_ps(t2, t3, _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+GEOM_SSE41 static inline void soa_to_aos(__m128 x, __m128 y, __m128 z, __m128& a, __m128& b, __m128& c)
+{
+    a = _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 0, 1, 0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+    b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+    c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+GEOM_SSE41 static inline void load_xyz4(const float* p, __m128& x, __m128& y, __m128& z)
+{
+    aos_to_soa(_mm_loadu_ps(p), _mm_loadu_ps(p + 4), _mm_loadu_ps(p + 8), x, y, z);
+}
+
+GEOM_SSE41 static inline void store_xyz4(float* p, __m128 x, __m128 y, __m128 z)
+{
+    __m128 a, b, c;
+    soa_to_aos(x, y, z, a, b, c);
+    _mm_storeu_ps(p, a); _mm_storeu_ps(p + 4, b); _mm_storeu_ps(p + 8, c);
+}
+
+// flat kernels walk blocks of 12 floats: three registers whose lanes repeat the per-component
+// constants, which lines up for 1-4 components
+GEOM_SSE41 static inline void load_pattern4(const float* perComp, unsigned comps, __m128 out[3])
+{
+    float lanes[12];
+    for (unsigned i = 0; i < 12; ++i) lanes[i] = perComp[i % comps];
+    for (int r = 0; r < 3; ++r) out[r] = _mm_loadu_ps(lanes + r * 4);
+}
+
+GEOM_SSE41 static void bounds_sse41(const float* p, size_t n, float mn[3], float mx[3])
+{
+    __m128 lo[3], hi[3];
+    load_pattern4(mn, 3, lo);
+    load_pattern4(mx, 3, hi);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float* q = p + i * 3;
+        for (int r = 0; r < 3; ++r) {
+            const __m128 v = _mm_loadu_ps(q + r * 4);
+            lo[r] = _mm_min_ps(lo[r], v);
+            hi[r] = _mm_max_ps(hi[r], v);
+        }
+    }
+    float l[12], h[12];
+    for (int r = 0; r < 3; ++r) { _mm_storeu_ps(l + r * 4, lo[r]); _mm_storeu_ps(h + r * 4, hi[r]); }
+    for (int k = 0; k < 12; ++k) {
+        mn[k % 3] = std::min(mn[k % 3], l[k]);
+        mx[k % 3] = std::max(mx[k % 3], h[k]);
+    }
+    bounds_scalar(p + i * 3, n - i, mn, mx);
+}
+
+GEOM_SSE41 static void mad_sse41(float* f, size_t floats, unsigned comps, const float* scale, const float* offset)
+{
+    __m128 s[3], o[3];
+    load_pattern4(scale, comps, s);
+    load_pattern4(offset, comps, o);
+    size_t i = 0;
+    for (; i + 12 <= floats; i += 12) {
+        for (int r = 0; r < 3; ++r) {
+            float* q = f + i + r * 4;
+            _mm_storeu_ps(q, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(q), s[r]), o[r]));
+        }
+    }
+    mad_scalar(f + i, floats - i, comps, scale, offset);
+}
+
+GEOM_SSE41 static void transform_sse41(float* p, size_t n, const float* m)
+{
+    __m128 c[16];
+    for (int k = 0; k < 16; ++k) c[k] = _mm_set1_ps(m[k]);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float* q = p + i * 3;
+        __m128 x, y, z;
+        load_xyz4(q, x, y, z);
+        const __m128 nx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(c[0], x), _mm_mul_ps(c[4], y)), _mm_mul_ps(c[8], z)), c[12]);
+        const __m128 ny = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(c[1], x), _mm_mul_ps(c[5], y)), _mm_mul_ps(c[9], z)), c[13]);
+        const __m128 nz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(c[2], x), _mm_mul_ps(c[6], y)), _mm_mul_ps(c[10], z)), c[14]);
+        store_xyz4(q, nx, ny, nz);
+    }
+    transform_scalar(p + i * 3, n - i, m);
+}
+
+GEOM_SSE41 static void normalize_sse41(float* p, size_t n)
+{
+    const __m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float* q = p + i * 3;
+        __m128 x, y, z;
+        load_xyz4(q, x, y, z);
+        const __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+        const __m128 inv = _mm_and_ps(_mm_div_ps(one, _mm_sqrt_ps(len2)), _mm_cmpgt_ps(len2, zero));
+        store_xyz4(q, _mm_mul_ps(x, inv), _mm_mul_ps(y, inv), _mm_mul_ps(z, inv));
+    }
+    normalize_scalar(p + i * 3, n - i);
+}
+
+GEOM_SSE41 static void quantize_sse41(const float* src, size_t floats, unsigned comps, const float* lo, const float* scale, uint16_t* dst)
+{
+    __m128 l[3], s[3];
+    load_pattern4(lo, comps, l);
+    load_pattern4(scale, comps, s);
+    const __m128 zero = _mm_setzero_ps(), top = _mm_set1_ps(65535.0f);
+    size_t i = 0;
+    for (; i + 12 <= floats; i += 12) {
+        for (int r = 0; r < 3; ++r) {
+            __m128 t = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(src + i + r * 4), l[r]), s[r]);
+            t = _mm_min_ps(_mm_max_ps(t, zero), top);
+            const __m128i q = _mm_cvtps_epi32(t);
+            _mm_storel_epi64((__m128i*)(dst + i + r * 4), _mm_packus_epi32(q, q));
+        }
+    }
+    quantize_scalar(src + i, floats - i, comps, lo, scale, dst + i);
+}
+
+GEOM_SSE41 static void dequantize_sse41(const uint16_t* src, size_t floats, unsigned comps, const float* lo, const float* step, float* dst)
+{
+    __m128 l[3], s[3];
+    load_pattern4(lo, comps, l);
+    load_pattern4(step, comps, s);
+    size_t i = 0;
+    for (; i + 12 <= floats; i += 12) {
+        for (int r = 0; r < 3; ++r) {
+            const __m128i q = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(src + i + r * 4)));
+            _mm_storeu_ps(dst + i + r * 4, _mm_add_ps(l[r], _mm_mul_ps(_mm_cvtepi32_ps(q), s[r])));
+        }
+    }
+    dequantize_scalar(src + i, floats - i, comps, lo, step, dst + i);
+}
+
+GEOM_SSE41 static void oct_encode_sse41(const float* n, size_t count, int16_t* dst)
+{
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), minusOne = _mm_set1_ps(-1.0f);
+    const __m128 range = _mm_set1_ps(32767.0f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x, y, z;
+        load_xyz4(n + i * 3, x, y, z);
+        const __m128 l1 = _mm_add_ps(_mm_add_ps(_mm_and_ps(x, absMask), _mm_and_ps(y, absMask)), _mm_and_ps(z, absMask));
+        __m128 u = _mm_div_ps(x, l1);
+        __m128 v = _mm_div_ps(y, l1);
+        const __m128 su = _mm_blendv_ps(minusOne, one, _mm_cmpge_ps(u, zero));
+        const __m128 sv = _mm_blendv_ps(minusOne, one, _mm_cmpge_ps(v, zero));
+        const __m128 fu = _mm_mul_ps(_mm_sub_ps(one, _mm_and_ps(v, absMask)), su);
+        const __m128 fv = _mm_mul_ps(_mm_sub_ps(one, _mm_and_ps(u, absMask)), sv);
+        const __m128 lower = _mm_cmplt_ps(z, zero);
+        const __m128 valid = _mm_cmpgt_ps(l1, zero); // zero vectors divided to NaN, mask them to 0
+        u = _mm_and_ps(_mm_blendv_ps(u, fu, lower), valid);
+        v = _mm_and_ps(_mm_blendv_ps(v, fv, lower), valid);
+        u = _mm_min_ps(_mm_max_ps(u, minusOne), one);
+        v = _mm_min_ps(_mm_max_ps(v, minusOne), one);
+        const __m128i iu = _mm_cvtps_epi32(_mm_mul_ps(u, range));
+        const __m128i iv = _mm_cvtps_epi32(_mm_mul_ps(v, range));
+        _mm_storeu_si128((__m128i*)(dst + i * 2), _mm_packs_epi32(_mm_unpacklo_epi32(iu, iv), _mm_unpackhi_epi32(iu, iv)));
+    }
+    oct_encode_scalar(n + i * 3, count - i, dst + i * 2);
+}
+
+// ---------------------------------------------------------------------------------------------
+// AVX2: 8 vertices per step. Loads put vertices 0-3 in the low and 4-7 in the high 128-bit lane,
+// so the in-lane shuffles of the SSE transpose carry over unchanged.
+
+GEOM_AVX2 static inline __m256 load_lanes(const float* lo, const float* hi)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(lo)), _mm_loadu_ps(hi), 1);
+}
+
+GEOM_AVX2 static inline void store_lanes(float* lo, float* hi, __m256 v)
+{
+    _mm_storeu_ps(lo, _mm256_castps256_ps128(v));
+    _mm_storeu_ps(hi, _mm256_extractf128_ps(v, 1));
+}
+
+GEOM_AVX2 static inline void load_xyz8(const float* p, __m256& x, __m256& y, __m256& z)
+{
+    const __m256 a = load_lanes(p, p + 12), b = load_lanes(p + 4, p + 16), c = load_lanes(p + 8, p + 20);
+    const __m256 t0 = _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+    const __m256 t1 = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+    x = _mm256_shuffle_ps(a, t0, _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm256_shuffle_ps(t1, t0, _MM_SHUFFLE(3, 1, 2, 0));
+    const __m256 t2 = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+    const __m256 t3 = _mm256_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));
+    z = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+GEOM_AVX2 static inline void store_xyz8(float* p, __m256 x, __m256 y, __m256 z)
+{
+    const __m256 a = _mm256_shuffle_ps(_mm256_shuffle_ps(x, y, _MM_SHUFFLE(1, 0, 1, 0)), _mm256_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+    const __m256 b = _mm256_shuffle_ps(_mm256_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+    const __m256 c = _mm256_shuffle_ps(_mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+    store_lanes(p, p + 12, a);
+    store_lanes(p + 4, p + 16, b);
+    store_lanes(p + 8, p + 20, c);
+}
+
+// 24-float blocks, same idea as load_pattern4
+GEOM_AVX2 static inline void load_pattern8(const float* perComp, unsigned comps, __m256 out[3])
+{
+    float lanes[24];
+    for (unsigned i = 0; i < 24; ++i) lanes[i] = perComp[i % comps];
+    for (int r = 0; r < 3; ++r) out[r] = _mm256_loadu_ps(lanes + r * 8);
+}
+
+GEOM_AVX2 static void bounds_avx2(const float* p, size_t n, float mn[3], float mx[3])
+{
+    __m256 lo[3], hi[3];
+    load_pattern8(mn, 3, lo);
+    load_pattern8(mx, 3, hi);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const float* q = p + i * 3;
+        for (int r = 0; r < 3; ++r) {
+            const __m256 v = _mm256_loadu_ps(q + r * 8);
+            lo[r] = _mm256_min_ps(lo[r], v);
+            hi[r] = _mm256_max_ps(hi[r], v);
+        }
+    }
+    float l[24], h[24];
+    for (int r = 0; r < 3; ++r) { _mm256_storeu_ps(l + r * 8, lo[r]); _mm256_storeu_ps(h + r * 8, hi[r]); }
+    for (int k = 0; k < 24; ++k) {
+        mn[k % 3] = std::min(mn[k % 3], l[k]);
+        mx[k % 3] = std::max(mx[k % 3], h[k]);
+    }
+    bounds_scalar(p + i * 3, n - i, mn, mx);
+}
+
+GEOM_AVX2 static void mad_avx2(float* f, size_t floats, unsigned comps, const float* scale, const float* offset)
+{
+    __m256 s[3], o[3];
+    load_pattern8(scale, comps, s);
+    load_pattern8(offset, comps, o);
+    size_t i = 0;
+    for (; i + 24 <= floats; i += 24) {
+        for (int r = 0; r < 3; ++r) {
+            float* q = f + i + r * 8;
+            _mm256_storeu_ps(q, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(q), s[r]), o[r]));
+        }
+    }
+    mad_scalar(f + i, floats - i, comps, scale, offset);
+}
+
+GEOM_AVX2 static void transform_avx2(float* p, size_t n, const float* m)
+{
+    __m256 c[16];
+    for (int k = 0; k < 16; ++k) c[k] = _mm256_set1_ps(m[k]);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        float* q = p + i * 3;
+        __m256 x, y, z;
+        load_xyz8(q, x, y, z);
+        const __m256 nx = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c[0], x), _mm256_mul_ps(c[4], y)), _mm256_mul_ps(c[8], z)), c[12]);
+        const __m256 ny = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c[1], x), _mm256_mul_ps(c[5], y)), _mm256_mul_ps(c[9], z)), c[13]);
+        const __m256 nz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c[2], x), _mm256_mul_ps(c[6], y)), _mm256_mul_ps(c[10], z)), c[14]);
+        store_xyz8(q, nx, ny, nz);
+    }
+    transform_scalar(p + i * 3, n - i, m);
+}
+
+GEOM_AVX2 static void normalize_avx2(float* p, size_t n)
+{
+    const __m256 one = _mm256_set1_ps(1.0f), zero = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        float* q = p + i * 3;
+        __m256 x, y, z;
+        load_xyz8(q, x, y, z);
+        const __m256 len2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+        const __m256 inv = _mm256_and_ps(_mm256_div_ps(one, _mm256_sqrt_ps(len2)), _mm256_cmp_ps(len2, zero, _CMP_GT_OQ));
+        store_xyz8(q, _mm256_mul_ps(x, inv), _mm256_mul_ps(y, inv), _mm256_mul_ps(z, inv));
+    }
+    normalize_scalar(p + i * 3, n - i);
+}
+
+GEOM_AVX2 static void quantize_avx2(const float* src, size_t floats, unsigned comps, const float* lo, const float* scale, uint16_t* dst)
+{
+    __m256 l[3], s[3];
+    load_pattern8(lo, comps, l);
+    load_pattern8(scale, comps, s);
+    const __m256 zero = _mm256_setzero_ps(), top = _mm256_set1_ps(65535.0f);
+    size_t i = 0;
+    for (; i + 24 <= floats; i += 24) {
+        for (int r = 0; r < 3; ++r) {
+            __m256 t = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(src + i + r * 8), l[r]), s[r]);
+            t = _mm256_min_ps(_mm256_max_ps(t, zero), top);
+            const __m256i q = _mm256_cvtps_epi32(t);
+            // packus works per 128-bit lane; gather the two useful quadwords into the low half
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(q, q), _MM_SHUFFLE(3, 1, 2, 0));
+            _mm_storeu_si128((__m128i*)(dst + i + r * 8), _mm256_castsi256_si128(packed));
+        }
+    }
+    quantize_scalar(src + i, floats - i, comps, lo, scale, dst + i);
+}
+
+GEOM_AVX2 static void dequantize_avx2(const uint16_t* src, size_t floats, unsigned comps, const float* lo, const float* step, float* dst)
+{
+    __m256 l[3], s[3];
+    load_pattern8(lo, comps, l);
+    load_pattern8(step, comps, s);
+    size_t i = 0;
+    for (; i + 24 <= floats; i += 24) {
+        for (int r = 0; r < 3; ++r) {
+            const __m256i q = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src + i + r * 8)));
+            _mm256_storeu_ps(dst + i + r * 8, _mm256_add_ps(l[r], _mm256_mul_ps(_mm256_cvtepi32_ps(q), s[r])));
+        }
+    }
+    dequantize_scalar(src + i, floats - i, comps, lo, step, dst + i);
+}
+
+GEOM_AVX2 static void oct_encode_avx2(const float* n, size_t count, int16_t* dst)
+{
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), minusOne = _mm256_set1_ps(-1.0f);
+    const __m256 range = _mm256_set1_ps(32767.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x, y, z;
+        load_xyz8(n + i * 3, x, y, z);
+        const __m256 l1 = _mm256_add_ps(_mm256_add_ps(_mm256_and_ps(x, absMask), _mm256_and_ps(y, absMask)), _mm256_and_ps(z, absMask));
+        __m256 u = _mm256_div_ps(x, l1);
+        __m256 v = _mm256_div_ps(y, l1);
+        const __m256 su = _mm256_blendv_ps(minusOne, one, _mm256_cmp_ps(u, zero, _CMP_GE_OQ));
+        const __m256 sv = _mm256_blendv_ps(minusOne, one, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+        const __m256 fu = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_and_ps(v, absMask)), su);
+        const __m256 fv = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_and_ps(u, absMask)), sv);
+        const __m256 lower = _mm256_cmp_ps(z, zero, _CMP_LT_OQ);
+        const __m256 valid = _mm256_cmp_ps(l1, zero, _CMP_GT_OQ);
+        u = _mm256_and_ps(_mm256_blendv_ps(u, fu, lower), valid);
+        v = _mm256_and_ps(_mm256_blendv_ps(v, fv, lower), valid);
+        u = _mm256_min_ps(_mm256_max_ps(u, minusOne), one);
+        v = _mm256_min_ps(_mm256_max_ps(v, minusOne), one);
+        const __m256i iu = _mm256_cvtps_epi32(_mm256_mul_ps(u, range));
+        const __m256i iv = _mm256_cvtps_epi32(_mm256_mul_ps(v, range));
+        // unpack/pack stay within 128-bit lanes, which keeps vertices 0-3 and 4-7 in order
+        _mm256_storeu_si256((__m256i*)(dst + i * 2), _mm256_packs_epi32(_mm256_unpacklo_epi32(iu, iv), _mm256_unpackhi_epi32(iu, iv)));
+    }
+    oct_encode_scalar(n + i * 3, count - i, dst + i * 2);
+}
+
+#endif // SPLENDER_GEOM_X86
+
+// ---------------------------------------------------------------------------------------------
+// dispatch
+
+struct KernelTable {
+    void (*bounds)(const float*, size_t, float*, float*);
+    void (*mad)(float*, size_t, unsigned, const float*, const float*);
+    void (*transform)(float*, size_t, const float*);
+    void (*normalize)(float*, size_t);
+    void (*quantize)(const float*, size_t, unsigned, const float*, const float*, uint16_t*);
+    void (*dequantize)(const uint16_t*, size_t, unsigned, const float*, const float*, float*);
+    void (*octEncode)(const float*, size_t, int16_t*);
+};
+
+static const KernelTable kScalarKernels = {
+    bounds_scalar, mad_scalar, transform_scalar, normalize_scalar,
+    quantize_scalar, dequantize_scalar, oct_encode_scalar
+};
+#ifdef SPLENDER_GEOM_X86
+static const KernelTable kSse41Kernels = {
+    bounds_sse41, mad_sse41, transform_sse41, normalize_sse41,
+    quantize_sse41, dequantize_sse41, oct_encode_sse41
+};
+static const KernelTable kAvx2Kernels = {
+    bounds_avx2, mad_avx2, transform_avx2, normalize_avx2,
+    quantize_avx2, dequantize_avx2, oct_encode_avx2
+};
+#endif
+
+static SimdLevel detect_level()
+{
+#ifdef SPLENDER_GEOM_X86
+  #if defined(_MSC_VER) && !defined(__clang__)
+    int r[4];
+    __cpuid(r, 0);
+    const int maxLeaf = r[0];
+    __cpuid(r, 1);
+    const bool sse41 = (r[2] & (1 << 19)) != 0;
+    const bool osAvx = (r[2] & (1 << 27)) && (r[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6; // OS saves ymm
+    bool avx2 = false;
+    if (osAvx && maxLeaf >= 7) { __cpuidex(r, 7, 0); avx2 = (r[1] & (1 << 5)) != 0; }
+  #else
+    __builtin_cpu_init();
+    const bool sse41 = __builtin_cpu_supports("sse4.1");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+  #endif
+    if (avx2) return SimdLevel::AVX2;
+    if (sse41) return SimdLevel::SSE41;
+#endif
+    return SimdLevel::Scalar;
+}
+
+static std::atomic<int> g_activeLevel{-1};
+
+SimdLevel simd_detected_level()
+{
+    static const SimdLevel level = detect_level();
+    return level;
+}
+
+SimdLevel simd_active_level()
+{
+    const int l = g_activeLevel.load(std::memory_order_relaxed);
+    return l < 0 ? simd_detected_level() : SimdLevel(l);
+}
+
+void simd_set_level(SimdLevel level)
+{
+    g_activeLevel.store((int)std::min(level, simd_detected_level()), std::memory_order_relaxed);
+}
+
+const char* simd_level_name(SimdLevel level)
+{
+    switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE41: return "SSE4.1";
+        default: return "scalar";
+    }
+}
+
+static const KernelTable& kernels()
+{
+#ifdef SPLENDER_GEOM_X86
+    switch (simd_active_level()) {
+        case SimdLevel::AVX2: return kAvx2Kernels;
+        case SimdLevel::SSE41: return kSse41Kernels;
+        default: break;
+    }
+#endif
+    return kScalarKernels;
+}
+
+// ---------------------------------------------------------------------------------------------
+// public entry points: resolve the table once, then chunk on the pool
+
+bool geom_bounds(const glm::vec3* p, size_t count, Bounds3& out)
+{
+    if (count == 0) return false;
+    const KernelTable& k = kernels();
+    const float* f = &p[0].x;
+    Bounds3 total{ p[0], p[0] };
+    std::mutex m;
+    globalThreadPool().parallel_for(0, count, kGrain, [&](size_t b, size_t e) {
+        float mn[3] = { f[b * 3], f[b * 3 + 1], f[b * 3 + 2] };
+        float mx[3] = { mn[0], mn[1], mn[2] };
+        k.bounds(f + b * 3, e - b, mn, mx);
+        std::lock_guard<std::mutex> lock(m);
+        for (int c = 0; c < 3; ++c) {
+            total.min[c] = std::min(total.min[c], mn[c]);
+            total.max[c] = std::max(total.max[c], mx[c]);
+        }
+    });
+    out = total;
+    return true;
+}
+
+void geom_scale_offset(glm::vec3* p, size_t count, const glm::vec3& scale, const glm::vec3& offset)
+{
+    if (count == 0) return;
+    const KernelTable& k = kernels();
+    float* f = &p[0].x;
+    const float s[3] = { scale.x, scale.y, scale.z };
+    const float o[3] = { offset.x, offset.y, offset.z };
+    globalThreadPool().parallel_for(0, count, kGrain, [&](size_t b, size_t e) {
+        k.mad(f + b * 3, (e - b) * 3, 3, s, o);
+    });
+}
+
+void geom_transform(glm::vec3* p, size_t count, const glm::mat4& m)
+{
+    if (count == 0) return;
+    const KernelTable& k = kernels();
+    float* f = &p[0].x;
+    const float* mf = &m[0][0];
+    globalThreadPool().parallel_for(0, count, kGrain, [&](size_t b, size_t e) {
+        k.transform(f + b * 3, e - b, mf);
+    });
+}
+
+void geom_normalize(glm::vec3* v, size_t count)
+{
+    if (count == 0) return;
+    const KernelTable& k = kernels();
+    float* f = &v[0].x;
+    globalThreadPool().parallel_for(0, count, kGrain, [&](size_t b, size_t e) {
+        k.normalize(f + b * 3, e - b);
+    });
+}
+
+void geom_quantize_unorm16(const float* src, size_t count, unsigned components,
+                           const float* lo, const float* scale, uint16_t* dst)
+{
+    if (components < 1 || components > 4) return;
+    const KernelTable& k = kernels();
+    globalThreadPool().parallel_for(0, count, kGrain, [&](size_t b, size_t e) {
+        k.quantize(src + b * components, (e - b) * components, components, lo, scale, dst + b * components);
+    });
+}
+
+void geom_dequantize_unorm16(const uint16_t* src, size_t count, unsigned components,
+                             const float* lo, const float* step, float* dst)
+{
+    if (components < 1 || components > 4) return;
+    const KernelTable& k = kernels();
+    globalThreadPool().parallel_for(0, count, kGrain, [&](size_t b, size_t e) {
+        k.dequantize(src + b * components, (e - b) * components, components, lo, step, dst + b * components);
+    });
+}
+
+void geom_oct_encode(const glm::vec3* n, size_t count, int16_t* dst)
+{
+    if (count == 0) return;
+    const KernelTable& k = kernels();
+    const float* f = &n[0].x;
+    globalThreadPool().parallel_for(0, count, kGrain, [&](size_t b, size_t e) {
+        k.octEncode(f + b * 3, e - b, dst + b * 2);
+    });
+}
+
+glm::vec3 geom_oct_decode(int16_t u, int16_t v)
+{
+    float x = std::max(float(u) / 32767.0f, -1.0f);
+    float y = std::max(float(v) / 32767.0f, -1.0f);
+    const float z = 1.0f - std::fabs(x) - std::fabs(y);
+    if (z < 0.0f) {
+        const float fx = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        const float fy = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = fx; y = fy;
+    }
+    const float len = std::sqrt(x * x + y * y + z * z);
+    return len > 0.0f ? glm::vec3(x, y, z) / len : glm::vec3(0.0f, 0.0f, 1.0f);
+}
+
+// fixed component counts let the compiler unroll the inner copy
+template <unsigned C>
+static void copy_stream(const float* src, size_t b, size_t e, float* dst, size_t stride, size_t offset)
+{
+    for (size_t v = b; v < e; ++v) {
+        float* d = dst + v * stride + offset;
+        const float* s = src + v * C;
+        for (unsigned c = 0; c < C; ++c) d[c] = s[c];
+    }
+}
+
+void geom_interleave(const VertexStream* streams, size_t streamCount, size_t count, float* dst)
+{
+    size_t stride = 0;
+    for (size_t s = 0; s < streamCount; ++s) stride += streams[s].components;
+    globalThreadPool().parallel_for(0, count, kGrain, [&](size_t b, size_t e) {
+        size_t offset = 0;
+        for (size_t s = 0; s < streamCount; ++s) {
+            const VertexStream& st = streams[s];
+            if (!st.data) {
+                for (size_t v = b; v < e; ++v)
+                    for (unsigned c = 0; c < st.components; ++c) dst[v * stride + offset + c] = 0.0f;
+            } else {
+                switch (st.components) {
+                    case 2: copy_stream<2>(st.data, b, e, dst, stride, offset); break;
+                    case 3: copy_stream<3>(st.data, b, e, dst, stride, offset); break;
+                    case 4: copy_stream<4>(st.data, b, e, dst, stride, offset); break;
+                    default:
+                        for (size_t v = b; v < e; ++v)
+                            for (unsigned c = 0; c < st.components; ++c)
+                                dst[v * stride + offset + c] = st.data[v * st.components + c];
+                        break;
+                }
+            }
+            offset += st.components;
+        }
+    });
+}
+
+void geom_deinterleave(const float* src, size_t stride, size_t offset, unsigned components,
+                       size_t count, float* dst)
+{
+    globalThreadPool().parallel_for(0, count, kGrain, [&](size_t b, size_t e) {
+        for (size_t v = b; v < e; ++v)
+            for (unsigned c = 0; c < components; ++c) dst[v * components + c] = src[v * stride + offset + c];
+    });
+}
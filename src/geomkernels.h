@@ -0,0 +1,67 @@
+#pragma once
+
+// geomkernels.h
+// Bulk vertex-array kernels (bounds, transforms, packing) with scalar / SSE4.1 / AVX2 variants
+// picked at runtime. Large arrays are split across the global thread pool.
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+
+// All variants give bit-identical results: no FMA, no approximate reciprocals, and the scalar code
+// evaluates in the same order as the vector code (geomkernels.cpp is built with fp contraction off).
+// NaN inputs are not supported.
+enum class SimdLevel {
+    Scalar = 0,
+    SSE41 = 1,
+    AVX2 = 2
+};
+
+SimdLevel simd_detected_level();   // best level the CPU and the build support
+SimdLevel simd_active_level();
+// switch variants (benchmarks / exactness checks); clamped to the detected level
+void simd_set_level(SimdLevel level);
+const char* simd_level_name(SimdLevel level);
+
+struct Bounds3 {
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+};
+
+// axis-aligned bounds; false (out untouched) for an empty array
+bool geom_bounds(const glm::vec3* p, size_t count, Bounds3& out);
+
+// p = p * scale + offset per axis
+void geom_scale_offset(glm::vec3* p, size_t count, const glm::vec3& scale, const glm::vec3& offset);
+
+// p = (m * vec4(p, 1)).xyz, the projective row is ignored
+void geom_transform(glm::vec3* p, size_t count, const glm::mat4& m);
+
+// unit length in place, zero vectors stay zero
+void geom_normalize(glm::vec3* v, size_t count);
+
+// Flat arrays of `components` floats per element (1-4), per-component lo/scale/step:
+//   q = round(clamp((v - lo) * scale, 0, 65535))      v = lo + q * step
+void geom_quantize_unorm16(const float* src, size_t count, unsigned components,
+                           const float* lo, const float* scale, uint16_t* dst);
+void geom_dequantize_unorm16(const uint16_t* src, size_t count, unsigned components,
+                             const float* lo, const float* step, float* dst);
+
+// unit vectors to two snorm16 each (octahedral map, lower hemisphere folded). Decoding is a
+// scalar helper for tools and checks.
+void geom_oct_encode(const glm::vec3* n, size_t count, int16_t* dst);
+glm::vec3 geom_oct_decode(int16_t u, int16_t v);
+
+// One attribute stream: `components` floats per vertex, nullptr data writes zeros
+struct VertexStream {
+    const float* data;
+    unsigned components;
+};
+
+// Interleave/deinterleave are strided copies bound by memory bandwidth, so they are chunked on the
+// pool but have a single implementation.
+void geom_interleave(const VertexStream* streams, size_t streamCount, size_t count, float* dst);
+// copy `components` floats at `offset` out of every `stride`-float vertex
+void geom_deinterleave(const float* src, size_t stride, size_t offset, unsigned components,
+                       size_t count, float* dst);
@@ -0,0 +1,1352 @@
+// glcapture.cpp
+// Implements GlCapture and GlReplayer declared in glcapture.h
+
+#include "glcapture.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+// File: "SPLGLC", u16 version, i32 width, i32 height (framebuffer at start), then records of
+// u16 GlOp followed by the call's arguments. Object names, syncs and uniform locations are the
+// captured ones; pointers into GL memory (vertex attribute, index and indirect offsets) are u64.
+static const char kMagic[6] = { 'S', 'P', 'L', 'G', 'L', 'C' };
+static const uint16_t kVersion = 1;
+static const size_t kHeaderSize = sizeof(kMagic) + sizeof(uint16_t) + 2 * sizeof(int32_t);
+static const size_t kFlushBytes = size_t(4) << 20;
+
+const char* gl_op_name(GlOp op)
+{
+    static const char* const names[] = {
+        "frame begin", "frame end",
+        "glEnable", "glDisable", "glIsEnabled", "glBlendFunc", "glDepthMask", "glCullFace", "glFrontFace",
+        "glLineWidth", "glViewport", "glClearColor", "glClear", "glPixelStorei",
+        "glGenBuffers", "glDeleteBuffers", "glBindBuffer", "glBindBufferBase", "glBufferData", "glBufferSubData",
+        "glGetBufferSubData",
+        "glGenVertexArrays", "glDeleteVertexArrays", "glBindVertexArray", "glVertexAttribPointer",
+        "glEnableVertexAttribArray", "glDisableVertexAttribArray",
+        "glGenTextures", "glDeleteTextures", "glBindTexture", "glActiveTexture", "glTexParameteri",
+        "glTexParameterf", "glTexImage2D", "glCompressedTexImage2D", "glBindImageTexture",
+        "glGenFramebuffers", "glDeleteFramebuffers", "glBindFramebuffer", "glFramebufferTexture2D",
+        "glFramebufferRenderbuffer", "glCheckFramebufferStatus", "glBlitFramebuffer",
+        "glGenRenderbuffers", "glDeleteRenderbuffers", "glBindRenderbuffer", "glRenderbufferStorageMultisample",
+        "glCreateShader", "glShaderSource", "glCompileShader", "glGetShaderiv", "glGetShaderInfoLog", "glDeleteShader",
+        "glCreateProgram", "glAttachShader", "glLinkProgram", "glGetProgramiv", "glGetProgramInfoLog",
+        "glDeleteProgram", "glUseProgram",
+        "glGetUniformLocation", "glUniform1i", "glUniform1ui", "glUniform1f", "glUniform2f", "glUniform3f",
+        "glUniform3fv", "glUniformMatrix4fv",
+        "glDrawArrays", "glDrawElements", "glDrawElementsIndirect", "glDispatchCompute", "glMemoryBarrier",
+        "glGenQueries", "glDeleteQueries", "glBeginQuery", "glEndQuery", "glGetQueryObjectiv",
+        "glGetQueryObjectui64v",
+        "glFenceSync", "glClientWaitSync", "glDeleteSync",
+        "glGetIntegerv", "glGetBooleanv", "glGetStringi",
+        "glScissor",
+    };
+    static_assert(std::size(names) == (size_t)GlOp::Count, "one name per GlOp");
+    return (size_t)op < std::size(names) ? names[(size_t)op] : "?";
+}
+
+static bool is_draw(GlOp op)
+{
+    return op == GlOp::DrawArrays || op == GlOp::DrawElements || op == GlOp::DrawElementsIndirect ||
+           op == GlOp::DispatchCompute;
+}
+
+// Bytes glTexImage2D reads for an uncompressed image, 0 for formats the app does not use
+static size_t image_bytes(GLsizei width, GLsizei height, GLenum format, GLenum type, GLint alignment)
+{
+    size_t components = 0;
+    switch (format) {
+    case GL_RED: case GL_RED_INTEGER: case GL_DEPTH_COMPONENT: components = 1; break;
+    case GL_RG: case GL_RG_INTEGER: components = 2; break;
+    case GL_RGB: case GL_BGR: case GL_RGB_INTEGER: components = 3; break;
+    case GL_RGBA: case GL_BGRA: case GL_RGBA_INTEGER: components = 4; break;
+    default: return 0;
+    }
+    size_t pixel = 0;
+    switch (type) {
+    case GL_UNSIGNED_BYTE: case GL_BYTE: pixel = components; break;
+    case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: pixel = components * 2; break;
+    case GL_UNSIGNED_INT: case GL_INT: case GL_FLOAT: pixel = components * 4; break;
+    case GL_UNSIGNED_INT_8_8_8_8: case GL_UNSIGNED_INT_8_8_8_8_REV: case GL_UNSIGNED_INT_2_10_10_10_REV: pixel = 4; break;
+    default: return 0;
+    }
+    if (width <= 0 || height <= 0) return 0;
+    const size_t a = alignment > 0 ? (size_t)alignment : 4;
+    const size_t row = size_t(width) * pixel;
+    const size_t stride = (row + a - 1) / a * a;
+    return stride * size_t(height - 1) + row;   // the last row is not padded
+}
+
+// ---- capture ----
+
+static GlCapture* g_capture = nullptr;
+static GLint g_unpackAlignment = 4;
+static bool g_warnedImage = false;
+
+#define GL_CAPTURE_FUNCTIONS(X) \
+    X(glEnable) X(glDisable) X(glIsEnabled) X(glBlendFunc) X(glDepthMask) X(glCullFace) X(glFrontFace) \
+    X(glLineWidth) X(glViewport) X(glClearColor) X(glClear) X(glPixelStorei) \
+    X(glGenBuffers) X(glDeleteBuffers) X(glBindBuffer) X(glBindBufferBase) X(glBufferData) X(glBufferSubData) \
+    X(glGetBufferSubData) \
+    X(glGenVertexArrays) X(glDeleteVertexArrays) X(glBindVertexArray) X(glVertexAttribPointer) \
+    X(glEnableVertexAttribArray) X(glDisableVertexAttribArray) \
+    X(glGenTextures) X(glDeleteTextures) X(glBindTexture) X(glActiveTexture) X(glTexParameteri) \
+    X(glTexParameterf) X(glTexImage2D) X(glCompressedTexImage2D) X(glBindImageTexture) \
+    X(glGenFramebuffers) X(glDeleteFramebuffers) X(glBindFramebuffer) X(glFramebufferTexture2D) \
+    X(glFramebufferRenderbuffer) X(glCheckFramebufferStatus) X(glBlitFramebuffer) \
+    X(glGenRenderbuffers) X(glDeleteRenderbuffers) X(glBindRenderbuffer) X(glRenderbufferStorageMultisample) \
+    X(glCreateShader) X(glShaderSource) X(glCompileShader) X(glGetShaderiv) X(glGetShaderInfoLog) X(glDeleteShader) \
+    X(glCreateProgram) X(glAttachShader) X(glLinkProgram) X(glGetProgramiv) X(glGetProgramInfoLog) \
+    X(glDeleteProgram) X(glUseProgram) \
+    X(glGetUniformLocation) X(glUniform1i) X(glUniform1ui) X(glUniform1f) X(glUniform2f) X(glUniform3f) \
+    X(glUniform3fv) X(glUniformMatrix4fv) \
+    X(glDrawArrays) X(glDrawElements) X(glDrawElementsIndirect) X(glDispatchCompute) X(glMemoryBarrier) \
+    X(glGenQueries) X(glDeleteQueries) X(glBeginQuery) X(glEndQuery) X(glGetQueryObjectiv) \
+    X(glGetQueryObjectui64v) \
+    X(glFenceSync) X(glClientWaitSync) X(glDeleteSync) \
+    X(glGetIntegerv) X(glGetBooleanv) X(glGetStringi) \
+    X(glScissor)
+
+#define GL_CAPTURE_REAL(name) static decltype(glad_##name) real_##name = nullptr;
+GL_CAPTURE_FUNCTIONS(GL_CAPTURE_REAL)
+#undef GL_CAPTURE_REAL
+
+template <typename T>
+static void put(const T& v) { g_capture->put(&v, sizeof(T)); }
+static void put_bytes(const void* data, size_t bytes) { g_capture->put(data, bytes); }
+static void put_string(const char* s, size_t length)
+{
+    put((uint32_t)length);
+    put_bytes(s, length);
+}
+static void put_names(GLsizei n, const GLuint* names)
+{
+    put(n);
+    put_bytes(names, size_t(n > 0 ? n : 0) * sizeof(GLuint));
+}
+static void put_pointer(const void* p) { put((uint64_t)(uintptr_t)p); }
+
+// state and object calls always go to the file, work only inside captured frames
+static bool rec(GlOp op) { return g_capture && g_capture->record(op, false); }
+static bool rec_work(GlOp op) { return g_capture && g_capture->record(op, true); }
+
+static void APIENTRY cap_glEnable(GLenum cap) { if (rec(GlOp::Enable)) put(cap); real_glEnable(cap); }
+static void APIENTRY cap_glDisable(GLenum cap) { if (rec(GlOp::Disable)) put(cap); real_glDisable(cap); }
+static GLboolean APIENTRY cap_glIsEnabled(GLenum cap)
+{
+    if (rec_work(GlOp::IsEnabled)) put(cap);
+    return real_glIsEnabled(cap);
+}
+static void APIENTRY cap_glBlendFunc(GLenum s, GLenum d)
+{
+    if (rec(GlOp::BlendFunc)) { put(s); put(d); }
+    real_glBlendFunc(s, d);
+}
+static void APIENTRY cap_glDepthMask(GLboolean flag) { if (rec(GlOp::DepthMask)) put(flag); real_glDepthMask(flag); }
+static void APIENTRY cap_glCullFace(GLenum mode) { if (rec(GlOp::CullFace)) put(mode); real_glCullFace(mode); }
+static void APIENTRY cap_glFrontFace(GLenum mode) { if (rec(GlOp::FrontFace)) put(mode); real_glFrontFace(mode); }
+static void APIENTRY cap_glLineWidth(GLfloat width) { if (rec(GlOp::LineWidth)) put(width); real_glLineWidth(width); }
+static void APIENTRY cap_glViewport(GLint x, GLint y, GLsizei w, GLsizei h)
+{
+    if (rec(GlOp::Viewport)) { put(x); put(y); put(w); put(h); }
+    real_glViewport(x, y, w, h);
+}
+static void APIENTRY cap_glScissor(GLint x, GLint y, GLsizei w, GLsizei h)
+{
+    if (rec(GlOp::Scissor)) { put(x); put(y); put(w); put(h); }
+    real_glScissor(x, y, w, h);
+}
+static void APIENTRY cap_glClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+{
+    if (rec(GlOp::ClearColor)) { put(r); put(g); put(b); put(a); }
+    real_glClearColor(r, g, b, a);
+}
+static void APIENTRY cap_glClear(GLbitfield mask) { if (rec_work(GlOp::Clear)) put(mask); real_glClear(mask); }
+static void APIENTRY cap_glPixelStorei(GLenum pname, GLint param)
+{
+    if (pname == GL_UNPACK_ALIGNMENT) g_unpackAlignment = param;
+    if (rec(GlOp::PixelStorei)) { put(pname); put(param); }
+    real_glPixelStorei(pname, param);
+}
+
+static void APIENTRY cap_glGenBuffers(GLsizei n, GLuint* buffers)
+{
+    real_glGenBuffers(n, buffers);
+    if (rec(GlOp::GenBuffers)) put_names(n, buffers);
+}
+static void APIENTRY cap_glDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    if (rec(GlOp::DeleteBuffers)) put_names(n, buffers);
+    real_glDeleteBuffers(n, buffers);
+}
+static void APIENTRY cap_glBindBuffer(GLenum target, GLuint buffer)
+{
+    if (rec(GlOp::BindBuffer)) { put(target); put(buffer); }
+    real_glBindBuffer(target, buffer);
+}
+static void APIENTRY cap_glBindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+    if (rec(GlOp::BindBufferBase)) { put(target); put(index); put(buffer); }
+    real_glBindBufferBase(target, index, buffer);
+}
+static void APIENTRY cap_glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+    if (rec(GlOp::BufferData)) {
+        const uint64_t bytes = data && size > 0 ? (uint64_t)size : 0;
+        put(target); put((uint64_t)size); put(usage); put(bytes);
+        put_bytes(data, bytes);
+        g_capture->countUpload(bytes);
+    }
+    real_glBufferData(target, size, data, usage);
+}
+static void APIENTRY cap_glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    if (rec(GlOp::BufferSubData)) {
+        const uint64_t bytes = data && size > 0 ? (uint64_t)size : 0;
+        put(target); put((uint64_t)offset); put(bytes);
+        put_bytes(data, bytes);
+        g_capture->countUpload(bytes);
+    }
+    real_glBufferSubData(target, offset, size, data);
+}
+static void APIENTRY cap_glGetBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, void* data)
+{
+    if (rec_work(GlOp::GetBufferSubData)) { put(target); put((uint64_t)offset); put((uint64_t)size); }
+    real_glGetBufferSubData(target, offset, size, data);
+}
+
+static void APIENTRY cap_glGenVertexArrays(GLsizei n, GLuint* arrays)
+{
+    real_glGenVertexArrays(n, arrays);
+    if (rec(GlOp::GenVertexArrays)) put_names(n, arrays);
+}
+static void APIENTRY cap_glDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+    if (rec(GlOp::DeleteVertexArrays)) put_names(n, arrays);
+    real_glDeleteVertexArrays(n, arrays);
+}
+static void APIENTRY cap_glBindVertexArray(GLuint array)
+{
+    if (rec(GlOp::BindVertexArray)) put(array);
+    real_glBindVertexArray(array);
+}
+static void APIENTRY cap_glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                                               GLsizei stride, const void* pointer)
+{
+    // always an offset into the bound array buffer in this app
+    if (rec(GlOp::VertexAttribPointer)) {
+        put(index); put(size); put(type); put(normalized); put(stride); put_pointer(pointer);
+    }
+    real_glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+}
+static void APIENTRY cap_glEnableVertexAttribArray(GLuint index)
+{
+    if (rec(GlOp::EnableVertexAttribArray)) put(index);
+    real_glEnableVertexAttribArray(index);
+}
+static void APIENTRY cap_glDisableVertexAttribArray(GLuint index)
+{
+    if (rec(GlOp::DisableVertexAttribArray)) put(index);
+    real_glDisableVertexAttribArray(index);
+}
+
+static void APIENTRY cap_glGenTextures(GLsizei n, GLuint* textures)
+{
+    real_glGenTextures(n, textures);
+    if (rec(GlOp::GenTextures)) put_names(n, textures);
+}
+static void APIENTRY cap_glDeleteTextures(GLsizei n, const GLuint* textures)
+{
+    if (rec(GlOp::DeleteTextures)) put_names(n, textures);
+    real_glDeleteTextures(n, textures);
+}
+static void APIENTRY cap_glBindTexture(GLenum target, GLuint texture)
+{
+    if (rec(GlOp::BindTexture)) { put(target); put(texture); }
+    real_glBindTexture(target, texture);
+}
+static void APIENTRY cap_glActiveTexture(GLenum texture)
+{
+    if (rec(GlOp::ActiveTexture)) put(texture);
+    real_glActiveTexture(texture);
+}
+static void APIENTRY cap_glTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+    if (rec(GlOp::TexParameteri)) { put(target); put(pname); put(param); }
+    real_glTexParameteri(target, pname, param);
+}
+static void APIENTRY cap_glTexParameterf(GLenum target, GLenum pname, GLfloat param)
+{
+    if (rec(GlOp::TexParameterf)) { put(target); put(pname); put(param); }
+    real_glTexParameterf(target, pname, param);
+}
+static void APIENTRY cap_glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width,
+                                      GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
+{
+    if (rec(GlOp::TexImage2D)) {
+        const uint64_t bytes = pixels ? image_bytes(width, height, format, type, g_unpackAlignment) : 0;
+        if (pixels && !bytes && !g_warnedImage) {
+            std::cerr << "gl-capture: texture format not captured, replay uploads undefined contents\n";
+            g_warnedImage = true;
+        }
+        put(target); put(level); put(internalformat); put(width); put(height); put(border);
+        put(format); put(type); put(bytes);
+        put_bytes(pixels, bytes);
+        g_capture->countUpload(bytes);
+    }
+    real_glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+}
+static void APIENTRY cap_glCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width,
+                                                GLsizei height, GLint border, GLsizei imageSize, const void* data)
+{
+    if (rec(GlOp::CompressedTexImage2D)) {
+        const uint64_t bytes = data && imageSize > 0 ? (uint64_t)imageSize : 0;
+        put(target); put(level); put(internalformat); put(width); put(height); put(border);
+        put(imageSize); put(bytes);
+        put_bytes(data, bytes);
+        g_capture->countUpload(bytes);
+    }
+    real_glCompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data);
+}
+static void APIENTRY cap_glBindImageTexture(GLuint unit, GLuint texture, GLint level, GLboolean layered,
+                                            GLint layer, GLenum access, GLenum format)
+{
+    if (rec(GlOp::BindImageTexture)) {
+        put(unit); put(texture); put(level); put(layered); put(layer); put(access); put(format);
+    }
+    real_glBindImageTexture(unit, texture, level, layered, layer, access, format);
+}
+
+static void APIENTRY cap_glGenFramebuffers(GLsizei n, GLuint* framebuffers)
+{
+    real_glGenFramebuffers(n, framebuffers);
+    if (rec(GlOp::GenFramebuffers)) put_names(n, framebuffers);
+}
+static void APIENTRY cap_glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+    if (rec(GlOp::DeleteFramebuffers)) put_names(n, framebuffers);
+    real_glDeleteFramebuffers(n, framebuffers);
+}
+static void APIENTRY cap_glBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    if (rec(GlOp::BindFramebuffer)) { put(target); put(framebuffer); }
+    real_glBindFramebuffer(target, framebuffer);
+}
+static void APIENTRY cap_glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget,
+                                                GLuint texture, GLint level)
+{
+    if (rec(GlOp::FramebufferTexture2D)) { put(target); put(attachment); put(textarget); put(texture); put(level); }
+    real_glFramebufferTexture2D(target, attachment, textarget, texture, level);
+}
+static void APIENTRY cap_glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget,
+                                                   GLuint renderbuffer)
+{
+    if (rec(GlOp::FramebufferRenderbuffer)) { put(target); put(attachment); put(renderbuffertarget); put(renderbuffer); }
+    real_glFramebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer);
+}
+static GLenum APIENTRY cap_glCheckFramebufferStatus(GLenum target)
+{
+    if (rec_work(GlOp::CheckFramebufferStatus)) put(target);
+    return real_glCheckFramebufferStatus(target);
+}
+static void APIENTRY cap_glBlitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0,
+                                           GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter)
+{
+    if (rec_work(GlOp::BlitFramebuffer)) {
+        put(srcX0); put(srcY0); put(srcX1); put(srcY1); put(dstX0); put(dstY0); put(dstX1); put(dstY1);
+        put(mask); put(filter);
+    }
+    real_glBlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+}
+
+static void APIENTRY cap_glGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+{
+    real_glGenRenderbuffers(n, renderbuffers);
+    if (rec(GlOp::GenRenderbuffers)) put_names(n, renderbuffers);
+}
+static void APIENTRY cap_glDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+{
+    if (rec(GlOp::DeleteRenderbuffers)) put_names(n, renderbuffers);
+    real_glDeleteRenderbuffers(n, renderbuffers);
+}
+static void APIENTRY cap_glBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+    if (rec(GlOp::BindRenderbuffer)) { put(target); put(renderbuffer); }
+    real_glBindRenderbuffer(target, renderbuffer);
+}
+static void APIENTRY cap_glRenderbufferStorageMultisample(GLenum target, GLsizei samples, GLenum internalformat,
+                                                          GLsizei width, GLsizei height)
+{
+    if (rec(GlOp::RenderbufferStorageMultisample)) { put(target); put(samples); put(internalformat); put(width); put(height); }
+    real_glRenderbufferStorageMultisample(target, samples, internalformat, width, height);
+}
+
+static GLuint APIENTRY cap_glCreateShader(GLenum type)
+{
+    const GLuint shader = real_glCreateShader(type);
+    if (rec(GlOp::CreateShader)) { put(type); put(shader); }
+    return shader;
+}
+static void APIENTRY cap_glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+{
+    if (rec(GlOp::ShaderSource)) {
+        put(shader); put(count);
+        for (GLsizei i = 0; i < count; ++i) {
+            put_string(string[i], length && length[i] >= 0 ? (size_t)length[i] : std::strlen(string[i]));
+        }
+    }
+    real_glShaderSource(shader, count, string, length);
+}
+static void APIENTRY cap_glCompileShader(GLuint shader)
+{
+    if (rec(GlOp::CompileShader)) put(shader);
+    real_glCompileShader(shader);
+}
+static void APIENTRY cap_glGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    if (rec_work(GlOp::GetShaderiv)) { put(shader); put(pname); }
+    real_glGetShaderiv(shader, pname, params);
+}
+static void APIENTRY cap_glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    if (rec_work(GlOp::GetShaderInfoLog)) { put(shader); put(bufSize); }
+    real_glGetShaderInfoLog(shader, bufSize, length, infoLog);
+}
+static void APIENTRY cap_glDeleteShader(GLuint shader)
+{
+    if (rec(GlOp::DeleteShader)) put(shader);
+    real_glDeleteShader(shader);
+}
+
+static GLuint APIENTRY cap_glCreateProgram()
+{
+    const GLuint program = real_glCreateProgram();
+    if (rec(GlOp::CreateProgram)) put(program);
+    return program;
+}
+static void APIENTRY cap_glAttachShader(GLuint program, GLuint shader)
+{
+    if (rec(GlOp::AttachShader)) { put(program); put(shader); }
+    real_glAttachShader(program, shader);
+}
+static void APIENTRY cap_glLinkProgram(GLuint program)
+{
+    if (rec(GlOp::LinkProgram)) put(program);
+    real_glLinkProgram(program);
+}
+static void APIENTRY cap_glGetProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+    if (rec_work(GlOp::GetProgramiv)) { put(program); put(pname); }
+    real_glGetProgramiv(program, pname, params);
+}
+static void APIENTRY cap_glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    if (rec_work(GlOp::GetProgramInfoLog)) { put(program); put(bufSize); }
+    real_glGetProgramInfoLog(program, bufSize, length, infoLog);
+}
+static void APIENTRY cap_glDeleteProgram(GLuint program)
+{
+    if (rec(GlOp::DeleteProgram)) put(program);
+    real_glDeleteProgram(program);
+}
+static void APIENTRY cap_glUseProgram(GLuint program)
+{
+    if (rec(GlOp::UseProgram)) put(program);
+    real_glUseProgram(program);
+}
+
+static GLint APIENTRY cap_glGetUniformLocation(GLuint program, const GLchar* name)
+{
+    // kept even inside frames: the replayer needs every location the uniform calls use
+    const GLint location = real_glGetUniformLocation(program, name);
+    if (rec(GlOp::GetUniformLocation)) { put(program); put_string(name, std::strlen(name)); put(location); }
+    return location;
+}
+static void APIENTRY cap_glUniform1i(GLint location, GLint v0)
+{
+    if (rec(GlOp::Uniform1i)) { put(location); put(v0); }
+    real_glUniform1i(location, v0);
+}
+static void APIENTRY cap_glUniform1ui(GLint location, GLuint v0)
+{
+    if (rec(GlOp::Uniform1ui)) { put(location); put(v0); }
+    real_glUniform1ui(location, v0);
+}
+static void APIENTRY cap_glUniform1f(GLint location, GLfloat v0)
+{
+    if (rec(GlOp::Uniform1f)) { put(location); put(v0); }
+    real_glUniform1f(location, v0);
+}
+static void APIENTRY cap_glUniform2f(GLint location, GLfloat v0, GLfloat v1)
+{
+    if (rec(GlOp::Uniform2f)) { put(location); put(v0); put(v1); }
+    real_glUniform2f(location, v0, v1);
+}
+static void APIENTRY cap_glUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+{
+    if (rec(GlOp::Uniform3f)) { put(location); put(v0); put(v1); put(v2); }
+    real_glUniform3f(location, v0, v1, v2);
+}
+static void APIENTRY cap_glUniform3fv(GLint location, GLsizei count, const GLfloat* value)
+{
+    if (rec(GlOp::Uniform3fv)) { put(location); put(count); put_bytes(value, size_t(count > 0 ? count : 0) * 3 * sizeof(GLfloat)); }
+    real_glUniform3fv(location, count, value);
+}
+static void APIENTRY cap_glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    if (rec(GlOp::UniformMatrix4fv)) {
+        put(location); put(count); put(transpose);
+        put_bytes(value, size_t(count > 0 ? count : 0) * 16 * sizeof(GLfloat));
+    }
+    real_glUniformMatrix4fv(location, count, transpose, value);
+}
+
+static void APIENTRY cap_glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    if (rec_work(GlOp::DrawArrays)) { put(mode); put(first); put(count); }
+    real_glDrawArrays(mode, first, count);
+}
+static void APIENTRY cap_glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+    // indices is an offset into the bound element buffer, the app never draws from client memory
+    if (rec_work(GlOp::DrawElements)) { put(mode); put(count); put(type); put_pointer(indices); }
+    real_glDrawElements(mode, count, type, indices);
+}
+static void APIENTRY cap_glDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect)
+{
+    if (rec_work(GlOp::DrawElementsIndirect)) { put(mode); put(type); put_pointer(indirect); }
+    real_glDrawElementsIndirect(mode, type, indirect);
+}
+static void APIENTRY cap_glDispatchCompute(GLuint x, GLuint y, GLuint z)
+{
+    if (rec_work(GlOp::DispatchCompute)) { put(x); put(y); put(z); }
+    real_glDispatchCompute(x, y, z);
+}
+static void APIENTRY cap_glMemoryBarrier(GLbitfield barriers)
+{
+    if (rec_work(GlOp::MemoryBarrier)) put(barriers);
+    real_glMemoryBarrier(barriers);
+}
+
+static void APIENTRY cap_glGenQueries(GLsizei n, GLuint* ids)
+{
+    real_glGenQueries(n, ids);
+    if (rec(GlOp::GenQueries)) put_names(n, ids);
+}
+static void APIENTRY cap_glDeleteQueries(GLsizei n, const GLuint* ids)
+{
+    if (rec(GlOp::DeleteQueries)) put_names(n, ids);
+    real_glDeleteQueries(n, ids);
+}
+static void APIENTRY cap_glBeginQuery(GLenum target, GLuint id)
+{
+    if (rec_work(GlOp::BeginQuery)) { put(target); put(id); }
+    real_glBeginQuery(target, id);
+}
+static void APIENTRY cap_glEndQuery(GLenum target)
+{
+    if (rec_work(GlOp::EndQuery)) put(target);
+    real_glEndQuery(target);
+}
+static void APIENTRY cap_glGetQueryObjectiv(GLuint id, GLenum pname, GLint* params)
+{
+    if (rec_work(GlOp::GetQueryObjectiv)) { put(id); put(pname); }
+    real_glGetQueryObjectiv(id, pname, params);
+}
+static void APIENTRY cap_glGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params)
+{
+    if (rec_work(GlOp::GetQueryObjectui64v)) { put(id); put(pname); }
+    real_glGetQueryObjectui64v(id, pname, params);
+}
+
+static GLsync APIENTRY cap_glFenceSync(GLenum condition, GLbitfield flags)
+{
+    const GLsync sync = real_glFenceSync(condition, flags);
+    if (rec(GlOp::FenceSync)) { put(condition); put(flags); put_pointer(sync); }
+    return sync;
+}
+static GLenum APIENTRY cap_glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+    if (rec_work(GlOp::ClientWaitSync)) { put_pointer(sync); put(flags); put(timeout); }
+    return real_glClientWaitSync(sync, flags, timeout);
+}
+static void APIENTRY cap_glDeleteSync(GLsync sync)
+{
+    if (rec(GlOp::DeleteSync)) put_pointer(sync);
+    real_glDeleteSync(sync);
+}
+
+static void APIENTRY cap_glGetIntegerv(GLenum pname, GLint* data)
+{
+    if (rec_work(GlOp::GetIntegerv)) put(pname);
+    real_glGetIntegerv(pname, data);
+}
+static void APIENTRY cap_glGetBooleanv(GLenum pname, GLboolean* data)
+{
+    if (rec_work(GlOp::GetBooleanv)) put(pname);
+    real_glGetBooleanv(pname, data);
+}
+static const GLubyte* APIENTRY cap_glGetStringi(GLenum name, GLuint index)
+{
+    if (rec_work(GlOp::GetStringi)) { put(name); put(index); }
+    return real_glGetStringi(name, index);
+}
+
+GlCapture::~GlCapture()
+{
+    finish();
+}
+
+bool GlCapture::start(const std::string& path, int width, int height)
+{
+    if (g_capture) {
+        std::cerr << "gl-capture: already capturing\n";
+        return false;
+    }
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_) {
+        std::cerr << "gl-capture: cannot write " << path << "\n";
+        return false;
+    }
+    path_ = path;
+    buf_.reserve(kFlushBytes + (size_t(1) << 16));
+    const int32_t w = width, h = height;
+    put(kMagic, sizeof(kMagic));
+    put(&kVersion, sizeof(kVersion));
+    put(&w, sizeof(w));
+    put(&h, sizeof(h));
+
+    g_capture = this;
+    g_unpackAlignment = 4;
+    // entry points the context lacks (4.3 ones on a 3.3 context) stay null
+#define GL_CAPTURE_HOOK(name) real_##name = glad_##name; if (glad_##name) glad_##name = cap_##name;
+    GL_CAPTURE_FUNCTIONS(GL_CAPTURE_HOOK)
+#undef GL_CAPTURE_HOOK
+    std::cout << "gl-capture: writing " << path << "\n";
+    return true;
+}
+
+void GlCapture::captureFrames(uint32_t first, uint32_t count)
+{
+    first_ = first;
+    end_ = first + count;
+}
+
+void GlCapture::captureNext(uint32_t count)
+{
+    if (frame_ + 1 < end_) return;   // still capturing
+    captureFrames(frame_ + 1, count);
+    std::cout << "gl-capture: capturing frame " << first_ << (count > 1 ? " on" : "") << "\n";
+}
+
+void GlCapture::beginFrame(int framebufferWidth, int framebufferHeight)
+{
+    if (!active()) return;
+    inFrame_ = frame_ >= first_ && frame_ < end_;
+    if (!inFrame_) return;
+    const GlOp op = GlOp::FrameBegin;
+    const int32_t w = framebufferWidth, h = framebufferHeight;
+    put(&op, sizeof(op));
+    put(&frame_, sizeof(frame_));
+    put(&w, sizeof(w));
+    put(&h, sizeof(h));
+    GlFrameCounts c;
+    c.frame = frame_;
+    counts_.push_back(c);
+}
+
+void GlCapture::endFrame()
+{
+    if (!active()) return;
+    if (inFrame_) {
+        const GlOp op = GlOp::FrameEnd;
+        put(&op, sizeof(op));
+        flush();
+    }
+    inFrame_ = false;
+    ++frame_;
+}
+
+bool GlCapture::record(GlOp op, bool work)
+{
+    if (inFrame_) {
+        ++counts_.back().calls;
+        if (is_draw(op)) ++counts_.back().draws;
+    } else if (work) {
+        return false;
+    }
+    put(&op, sizeof(op));
+    return true;
+}
+
+void GlCapture::put(const void* data, size_t bytes)
+{
+    if (!bytes) return;
+    const unsigned char* p = (const unsigned char*)data;
+    buf_.insert(buf_.end(), p, p + bytes);
+    if (buf_.size() >= kFlushBytes) flush();
+}
+
+void GlCapture::countUpload(size_t bytes)
+{
+    if (inFrame_) counts_.back().uploadBytes += bytes;
+}
+
+void GlCapture::flush()
+{
+    if (buf_.empty()) return;
+    out_.write((const char*)buf_.data(), (std::streamsize)buf_.size());
+    written_ += buf_.size();
+    buf_.clear();
+}
+
+void GlCapture::finish()
+{
+    if (!active()) return;
+#define GL_CAPTURE_UNHOOK(name) if (real_##name) glad_##name = real_##name;
+    GL_CAPTURE_FUNCTIONS(GL_CAPTURE_UNHOOK)
+#undef GL_CAPTURE_UNHOOK
+    g_capture = nullptr;
+
+    if (inFrame_) {
+        // the loop ended mid-frame: drop the partial frame from the stats, the replayer ignores it
+        counts_.pop_back();
+        inFrame_ = false;
+    }
+    flush();
+    const bool ok = (bool)out_;
+    out_.close();
+
+    std::cout << "gl-capture: " << path_ << ": " << counts_.size() << " frames, "
+              << (written_ >> 10) << " KB" << (ok ? "" : " (write failed)") << "\n";
+    for (const GlFrameCounts& c : counts_) {
+        std::printf("  frame %u: %u calls, %u draws/dispatches, %.2f MB uploaded\n",
+                    c.frame, c.calls, c.draws, double(c.uploadBytes) / (1024.0 * 1024.0));
+    }
+    if (counts_.empty()) std::cout << "  (no frame captured: --gl-capture-frames or F12)\n";
+}
+
+// ---- replay ----
+
+namespace {
+
+struct Reader {
+    const unsigned char* p;
+    const unsigned char* end;
+    bool ok = true;
+
+    bool has(size_t bytes) const { return size_t(end - p) >= bytes; }
+    template <typename T>
+    T get()
+    {
+        T v{};
+        if (!has(sizeof(T))) { ok = false; p = end; return v; }
+        std::memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        return v;
+    }
+    const unsigned char* bytes(uint64_t n)
+    {
+        if (!has((size_t)n)) { ok = false; p = end; return nullptr; }
+        const unsigned char* b = p;
+        p += n;
+        return n ? b : nullptr;
+    }
+    std::string string()
+    {
+        const uint32_t n = get<uint32_t>();
+        const unsigned char* b = bytes(n);
+        return b ? std::string((const char*)b, n) : std::string();
+    }
+};
+
+} // namespace
+
+static GLuint mapped(const std::unordered_map<GLuint, GLuint>& map, GLuint name)
+{
+    if (!name) return 0;
+    auto it = map.find(name);
+    return it == map.end() ? 0 : it->second;
+}
+
+bool GlReplayer::load(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "glreplay: cannot open " << path << "\n";
+        return false;
+    }
+    in.seekg(0, std::ios::end);
+    data_.resize((size_t)in.tellg());
+    in.seekg(0);
+    in.read((char*)data_.data(), (std::streamsize)data_.size());
+    Reader r{ data_.data(), data_.data() + data_.size() };
+    const unsigned char* magic = r.bytes(sizeof(kMagic));
+    const uint16_t version = r.get<uint16_t>();
+    width_ = r.get<int32_t>();
+    height_ = r.get<int32_t>();
+    if (!r.ok || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        std::cerr << "glreplay: " << path << " is not a GL capture\n";
+        return false;
+    }
+    if (version != kVersion) {
+        std::cerr << "glreplay: " << path << " has version " << version << ", expected " << kVersion << "\n";
+        return false;
+    }
+    streamBegin_ = kHeaderSize;
+
+    // walk the stream once without issuing anything to find the frames
+    frames_.clear();
+    if (!execute(streamBegin_, data_.size(), false)) {
+        std::cerr << "glreplay: " << path << " is truncated or corrupt\n";
+        return false;
+    }
+    if (!frames_.empty() && frames_.front().width > 0) {
+        width_ = frames_.front().width;
+        height_ = frames_.front().height;
+    }
+    return true;
+}
+
+void GlReplayer::run()
+{
+    execute(streamBegin_, data_.size(), true);
+}
+
+void GlReplayer::runFrame(size_t index)
+{
+    if (index < frames_.size()) execute(frames_[index].begin, frames_[index].end, true);
+}
+
+// Decodes records in [begin, end); issue=false only scans (load() uses that to find the frames).
+bool GlReplayer::execute(size_t begin, size_t end, bool issue)
+{
+    Reader r{ data_.data() + begin, data_.data() + end };
+    GlReplayFrame* scanning = nullptr;   // frame being scanned, counts calls
+    GLuint names[64];
+
+    auto gen = [&](std::unordered_map<GLuint, GLuint>& map, void (APIENTRYP genFn)(GLsizei, GLuint*)) {
+        const GLsizei n = r.get<GLsizei>();
+        const unsigned char* captured = r.bytes(uint64_t(n > 0 ? n : 0) * sizeof(GLuint));
+        if (!issue || !captured) return;
+        for (GLsizei i = 0; i < n; i += 64) {
+            const GLsizei k = std::min<GLsizei>(64, n - i);
+            genFn(k, names);
+            for (GLsizei j = 0; j < k; ++j) {
+                GLuint c;
+                std::memcpy(&c, captured + size_t(i + j) * sizeof(GLuint), sizeof(GLuint));
+                map[c] = names[j];
+            }
+        }
+    };
+    auto del = [&](std::unordered_map<GLuint, GLuint>& map, void (APIENTRYP delFn)(GLsizei, const GLuint*)) {
+        const GLsizei n = r.get<GLsizei>();
+        const unsigned char* captured = r.bytes(uint64_t(n > 0 ? n : 0) * sizeof(GLuint));
+        if (!issue || !captured) return;
+        for (GLsizei i = 0; i < n; ++i) {
+            GLuint c;
+            std::memcpy(&c, captured + size_t(i) * sizeof(GLuint), sizeof(GLuint));
+            const GLuint name = mapped(map, c);
+            if (name) delFn(1, &name);
+            map.erase(c);
+        }
+    };
+    auto uniform = [&](GLint capturedLocation) -> GLint {
+        if (capturedLocation < 0) return -1;
+        auto it = uniforms_.find((uint64_t(currentProgram_) << 32) | uint32_t(capturedLocation));
+        return it == uniforms_.end() ? -1 : it->second;
+    };
+    auto scratch = [&](size_t bytes) -> void* {
+        if (scratch_.size() < bytes) scratch_.resize(bytes);
+        return scratch_.data();
+    };
+    // uniform arrays out of the file, which keeps no alignment
+    auto scratch_copy = [&](const unsigned char* src, size_t bytes) -> void* {
+        void* dst = scratch(bytes);
+        std::memcpy(dst, src, bytes);
+        return dst;
+    };
+    auto pointer = [&]() { return (const void*)(uintptr_t)r.get<uint64_t>(); };
+
+    while (r.ok && r.p < r.end) {
+        const size_t recordStart = size_t(r.p - data_.data());
+        const GlOp op = r.get<GlOp>();
+        if (scanning && op != GlOp::FrameEnd && op < GlOp::Count) {
+            ++scanning->counts.calls;
+            ++scanning->ops[(size_t)op];
+            if (is_draw(op)) ++scanning->counts.draws;
+        }
+
+        switch (op) {
+        case GlOp::FrameBegin: {
+            const uint32_t frame = r.get<uint32_t>();
+            const int32_t w = r.get<int32_t>(), h = r.get<int32_t>();
+            if (!issue) {
+                GlReplayFrame f;
+                f.counts.frame = frame;
+                f.width = w;
+                f.height = h;
+                f.begin = size_t(r.p - data_.data());
+                frames_.push_back(f);
+                scanning = &frames_.back();
+            }
+            break;
+        }
+        case GlOp::FrameEnd:
+            if (scanning) scanning->end = recordStart;
+            scanning = nullptr;
+            break;
+
+        case GlOp::Enable: { const GLenum cap = r.get<GLenum>(); if (issue) glEnable(cap); break; }
+        case GlOp::Disable: { const GLenum cap = r.get<GLenum>(); if (issue) glDisable(cap); break; }
+        case GlOp::IsEnabled: { const GLenum cap = r.get<GLenum>(); if (issue) (void)glIsEnabled(cap); break; }
+        case GlOp::BlendFunc: {
+            const GLenum s = r.get<GLenum>(), d = r.get<GLenum>();
+            if (issue) glBlendFunc(s, d);
+            break;
+        }
+        case GlOp::DepthMask: { const GLboolean f = r.get<GLboolean>(); if (issue) glDepthMask(f); break; }
+        case GlOp::CullFace: { const GLenum m = r.get<GLenum>(); if (issue) glCullFace(m); break; }
+        case GlOp::FrontFace: { const GLenum m = r.get<GLenum>(); if (issue) glFrontFace(m); break; }
+        case GlOp::LineWidth: { const GLfloat w = r.get<GLfloat>(); if (issue) glLineWidth(w); break; }
+        case GlOp::Viewport: {
+            const GLint x = r.get<GLint>(), y = r.get<GLint>();
+            const GLsizei w = r.get<GLsizei>(), h = r.get<GLsizei>();
+            if (issue) glViewport(x, y, w, h);
+            break;
+        }
+        case GlOp::ClearColor: {
+            const GLfloat cr = r.get<GLfloat>(), cg = r.get<GLfloat>(), cb = r.get<GLfloat>(), ca = r.get<GLfloat>();
+            if (issue) glClearColor(cr, cg, cb, ca);
+            break;
+        }
+        case GlOp::Clear: { const GLbitfield m = r.get<GLbitfield>(); if (issue) glClear(m); break; }
+        case GlOp::PixelStorei: {
+            const GLenum pname = r.get<GLenum>();
+            const GLint param = r.get<GLint>();
+            if (issue) glPixelStorei(pname, param);
+            break;
+        }
+
+        case GlOp::GenBuffers: gen(buffers_, glGenBuffers); break;
+        case GlOp::DeleteBuffers: del(buffers_, glDeleteBuffers); break;
+        case GlOp::BindBuffer: {
+            const GLenum target = r.get<GLenum>();
+            const GLuint b = r.get<GLuint>();
+            if (issue) glBindBuffer(target, mapped(buffers_, b));
+            break;
+        }
+        case GlOp::BindBufferBase: {
+            const GLenum target = r.get<GLenum>();
+            const GLuint index = r.get<GLuint>(), b = r.get<GLuint>();
+            if (issue) glBindBufferBase(target, index, mapped(buffers_, b));
+            break;
+        }
+        case GlOp::BufferData: {
+            const GLenum target = r.get<GLenum>();
+            const uint64_t size = r.get<uint64_t>();
+            const GLenum usage = r.get<GLenum>();
+            const uint64_t bytes = r.get<uint64_t>();
+            const unsigned char* data = r.bytes(bytes);
+            if (scanning) scanning->counts.uploadBytes += bytes;
+            if (issue) glBufferData(target, (GLsizeiptr)size, data, usage);
+            break;
+        }
+        case GlOp::BufferSubData: {
+            const GLenum target = r.get<GLenum>();
+            const uint64_t offset = r.get<uint64_t>(), bytes = r.get<uint64_t>();
+            const unsigned char* data = r.bytes(bytes);
+            if (scanning) scanning->counts.uploadBytes += bytes;
+            if (issue && data) glBufferSubData(target, (GLintptr)offset, (GLsizeiptr)bytes, data);
+            break;
+        }
+        case GlOp::GetBufferSubData: {
+            const GLenum target = r.get<GLenum>();
+            const uint64_t offset = r.get<uint64_t>(), size = r.get<uint64_t>();
+            if (issue) glGetBufferSubData(target, (GLintptr)offset, (GLsizeiptr)size, scratch((size_t)size));
+            break;
+        }
+
+        case GlOp::GenVertexArrays: gen(vertexArrays_, glGenVertexArrays); break;
+        case GlOp::DeleteVertexArrays: del(vertexArrays_, glDeleteVertexArrays); break;
+        case GlOp::BindVertexArray: {
+            const GLuint a = r.get<GLuint>();
+            if (issue) glBindVertexArray(mapped(vertexArrays_, a));
+            break;
+        }
+        case GlOp::VertexAttribPointer: {
+            const GLuint index = r.get<GLuint>();
+            const GLint size = r.get<GLint>();
+            const GLenum type = r.get<GLenum>();
+            const GLboolean normalized = r.get<GLboolean>();
+            const GLsizei stride = r.get<GLsizei>();
+            const void* offset = pointer();
+            if (issue) glVertexAttribPointer(index, size, type, normalized, stride, offset);
+            break;
+        }
+        case GlOp::EnableVertexAttribArray: { const GLuint i = r.get<GLuint>(); if (issue) glEnableVertexAttribArray(i); break; }
+        case GlOp::DisableVertexAttribArray: { const GLuint i = r.get<GLuint>(); if (issue) glDisableVertexAttribArray(i); break; }
+
+        case GlOp::GenTextures: gen(textures_, glGenTextures); break;
+        case GlOp::DeleteTextures: del(textures_, glDeleteTextures); break;
+        case GlOp::BindTexture: {
+            const GLenum target = r.get<GLenum>();
+            const GLuint t = r.get<GLuint>();
+            if (issue) glBindTexture(target, mapped(textures_, t));
+            break;
+        }
+        case GlOp::ActiveTexture: { const GLenum t = r.get<GLenum>(); if (issue) glActiveTexture(t); break; }
+        case GlOp::TexParameteri: {
+            const GLenum target = r.get<GLenum>(), pname = r.get<GLenum>();
+            const GLint param = r.get<GLint>();
+            if (issue) glTexParameteri(target, pname, param);
+            break;
+        }
+        case GlOp::TexParameterf: {
+            const GLenum target = r.get<GLenum>(), pname = r.get<GLenum>();
+            const GLfloat param = r.get<GLfloat>();
+            if (issue) glTexParameterf(target, pname, param);
+            break;
+        }
+        case GlOp::TexImage2D: {
+            const GLenum target = r.get<GLenum>();
+            const GLint level = r.get<GLint>(), internalformat = r.get<GLint>();
+            const GLsizei w = r.get<GLsizei>(), h = r.get<GLsizei>();
+            const GLint border = r.get<GLint>();
+            const GLenum format = r.get<GLenum>(), type = r.get<GLenum>();
+            const uint64_t bytes = r.get<uint64_t>();
+            const unsigned char* pixels = r.bytes(bytes);
+            if (scanning) scanning->counts.uploadBytes += bytes;
+            if (issue) glTexImage2D(target, level, internalformat, w, h, border, format, type, pixels);
+            break;
+        }
+        case GlOp::CompressedTexImage2D: {
+            const GLenum target = r.get<GLenum>();
+            const GLint level = r.get<GLint>();
+            const GLenum internalformat = r.get<GLenum>();
+            const GLsizei w = r.get<GLsizei>(), h = r.get<GLsizei>();
+            const GLint border = r.get<GLint>();
+            const GLsizei imageSize = r.get<GLsizei>();
+            const uint64_t bytes = r.get<uint64_t>();
+            const unsigned char* data = r.bytes(bytes);
+            if (scanning) scanning->counts.uploadBytes += bytes;
+            if (issue) glCompressedTexImage2D(target, level, internalformat, w, h, border, imageSize, data);
+            break;
+        }
+        case GlOp::BindImageTexture: {
+            const GLuint unit = r.get<GLuint>(), t = r.get<GLuint>();
+            const GLint level = r.get<GLint>();
+            const GLboolean layered = r.get<GLboolean>();
+            const GLint layer = r.get<GLint>();
+            const GLenum access = r.get<GLenum>(), format = r.get<GLenum>();
+            if (issue) glBindImageTexture(unit, mapped(textures_, t), level, layered, layer, access, format);
+            break;
+        }
+
+        case GlOp::GenFramebuffers: gen(framebuffers_, glGenFramebuffers); break;
+        case GlOp::DeleteFramebuffers: del(framebuffers_, glDeleteFramebuffers); break;
+        case GlOp::BindFramebuffer: {
+            const GLenum target = r.get<GLenum>();
+            const GLuint fb = r.get<GLuint>();
+            if (issue) glBindFramebuffer(target, mapped(framebuffers_, fb));
+            break;
+        }
+        case GlOp::FramebufferTexture2D: {
+            const GLenum target = r.get<GLenum>(), attachment = r.get<GLenum>(), textarget = r.get<GLenum>();
+            const GLuint t = r.get<GLuint>();
+            const GLint level = r.get<GLint>();
+            if (issue) glFramebufferTexture2D(target, attachment, textarget, mapped(textures_, t), level);
+            break;
+        }
+        case GlOp::FramebufferRenderbuffer: {
+            const GLenum target = r.get<GLenum>(), attachment = r.get<GLenum>(), rbTarget = r.get<GLenum>();
+            const GLuint rb = r.get<GLuint>();
+            if (issue) glFramebufferRenderbuffer(target, attachment, rbTarget, mapped(renderbuffers_, rb));
+            break;
+        }
+        case GlOp::CheckFramebufferStatus: {
+            const GLenum target = r.get<GLenum>();
+            if (issue) (void)glCheckFramebufferStatus(target);
+            break;
+        }
+        case GlOp::BlitFramebuffer: {
+            GLint v[8];
+            for (GLint& x : v) x = r.get<GLint>();
+            const GLbitfield mask = r.get<GLbitfield>();
+            const GLenum filter = r.get<GLenum>();
+            if (issue) glBlitFramebuffer(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], mask, filter);
+            break;
+        }
+
+        case GlOp::GenRenderbuffers: gen(renderbuffers_, glGenRenderbuffers); break;
+        case GlOp::DeleteRenderbuffers: del(renderbuffers_, glDeleteRenderbuffers); break;
+        case GlOp::BindRenderbuffer: {
+            const GLenum target = r.get<GLenum>();
+            const GLuint rb = r.get<GLuint>();
+            if (issue) glBindRenderbuffer(target, mapped(renderbuffers_, rb));
+            break;
+        }
+        case GlOp::RenderbufferStorageMultisample: {
+            const GLenum target = r.get<GLenum>();
+            const GLsizei samples = r.get<GLsizei>();
+            const GLenum internalformat = r.get<GLenum>();
+            const GLsizei w = r.get<GLsizei>(), h = r.get<GLsizei>();
+            if (issue) glRenderbufferStorageMultisample(target, samples, internalformat, w, h);
+            break;
+        }
+
+        case GlOp::CreateShader: {
+            const GLenum type = r.get<GLenum>();
+            const GLuint captured = r.get<GLuint>();
+            if (issue) shaders_[captured] = glCreateShader(type);
+            break;
+        }
+        case GlOp::ShaderSource: {
+            const GLuint shader = r.get<GLuint>();
+            const GLsizei count = r.get<GLsizei>();
+            std::vector<std::string> sources;
+            for (GLsizei i = 0; i < count && r.ok; ++i) sources.push_back(r.string());
+            if (issue) {
+                std::vector<const GLchar*> strings;
+                std::vector<GLint> lengths;
+                for (const std::string& s : sources) {
+                    strings.push_back(s.data());
+                    lengths.push_back((GLint)s.size());
+                }
+                glShaderSource(mapped(shaders_, shader), count, strings.data(), lengths.data());
+            }
+            break;
+        }
+        case GlOp::CompileShader: { const GLuint s = r.get<GLuint>(); if (issue) glCompileShader(mapped(shaders_, s)); break; }
+        case GlOp::GetShaderiv: {
+            const GLuint s = r.get<GLuint>();
+            const GLenum pname = r.get<GLenum>();
+            if (issue) glGetShaderiv(mapped(shaders_, s), pname, (GLint*)scratch(16 * sizeof(GLint)));
+            break;
+        }
+        case GlOp::GetShaderInfoLog: {
+            const GLuint s = r.get<GLuint>();
+            const GLsizei bufSize = r.get<GLsizei>();
+            if (issue) glGetShaderInfoLog(mapped(shaders_, s), bufSize, nullptr, (GLchar*)scratch(size_t(bufSize > 0 ? bufSize : 1)));
+            break;
+        }
+        case GlOp::DeleteShader: {
+            const GLuint s = r.get<GLuint>();
+            if (issue) {
+                if (const GLuint name = mapped(shaders_, s)) glDeleteShader(name);
+                shaders_.erase(s);
+            }
+            break;
+        }
+
+        case GlOp::CreateProgram: {
+            const GLuint captured = r.get<GLuint>();
+            if (issue) programs_[captured] = glCreateProgram();
+            break;
+        }
+        case GlOp::AttachShader: {
+            const GLuint p = r.get<GLuint>(), s = r.get<GLuint>();
+            if (issue) glAttachShader(mapped(programs_, p), mapped(shaders_, s));
+            break;
+        }
+        case GlOp::LinkProgram: { const GLuint p = r.get<GLuint>(); if (issue) glLinkProgram(mapped(programs_, p)); break; }
+        case GlOp::GetProgramiv: {
+            const GLuint p = r.get<GLuint>();
+            const GLenum pname = r.get<GLenum>();
+            if (issue) glGetProgramiv(mapped(programs_, p), pname, (GLint*)scratch(16 * sizeof(GLint)));
+            break;
+        }
+        case GlOp::GetProgramInfoLog: {
+            const GLuint p = r.get<GLuint>();
+            const GLsizei bufSize = r.get<GLsizei>();
+            if (issue) glGetProgramInfoLog(mapped(programs_, p), bufSize, nullptr, (GLchar*)scratch(size_t(bufSize > 0 ? bufSize : 1)));
+            break;
+        }
+        case GlOp::DeleteProgram: {
+            const GLuint p = r.get<GLuint>();
+            if (issue) {
+                if (const GLuint name = mapped(programs_, p)) glDeleteProgram(name);
+                programs_.erase(p);
+            }
+            break;
+        }
+        case GlOp::UseProgram: {
+            const GLuint p = r.get<GLuint>();
+            if (issue) {
+                currentProgram_ = p;
+                glUseProgram(mapped(programs_, p));
+            }
+            break;
+        }
+
+        case GlOp::GetUniformLocation: {
+            const GLuint p = r.get<GLuint>();
+            const std::string name = r.string();
+            const GLint captured = r.get<GLint>();
+            if (issue && captured >= 0) {
+                uniforms_[(uint64_t(p) << 32) | uint32_t(captured)] = glGetUniformLocation(mapped(programs_, p), name.c_str());
+            }
+            break;
+        }
+        case GlOp::Uniform1i: {
+            const GLint loc = r.get<GLint>(), v = r.get<GLint>();
+            if (issue) glUniform1i(uniform(loc), v);
+            break;
+        }
+        case GlOp::Uniform1ui: {
+            const GLint loc = r.get<GLint>();
+            const GLuint v = r.get<GLuint>();
+            if (issue) glUniform1ui(uniform(loc), v);
+            break;
+        }
+        case GlOp::Uniform1f: {
+            const GLint loc = r.get<GLint>();
+            const GLfloat v = r.get<GLfloat>();
+            if (issue) glUniform1f(uniform(loc), v);
+            break;
+        }
+        case GlOp::Uniform2f: {
+            const GLint loc = r.get<GLint>();
+            const GLfloat x = r.get<GLfloat>(), y = r.get<GLfloat>();
+            if (issue) glUniform2f(uniform(loc), x, y);
+            break;
+        }
+        case GlOp::Uniform3f: {
+            const GLint loc = r.get<GLint>();
+            const GLfloat x = r.get<GLfloat>(), y = r.get<GLfloat>(), z = r.get<GLfloat>();
+            if (issue) glUniform3f(uniform(loc), x, y, z);
+            break;
+        }
+        case GlOp::Uniform3fv: {
+            const GLint loc = r.get<GLint>();
+            const GLsizei count = r.get<GLsizei>();
+            const unsigned char* v = r.bytes(uint64_t(count > 0 ? count : 0) * 3 * sizeof(GLfloat));
+            if (issue && v) glUniform3fv(uniform(loc), count, (const GLfloat*)scratch_copy(v, size_t(count) * 3 * sizeof(GLfloat)));
+            break;
+        }
+        case GlOp::UniformMatrix4fv: {
+            const GLint loc = r.get<GLint>();
+            const GLsizei count = r.get<GLsizei>();
+            const GLboolean transpose = r.get<GLboolean>();
+            const unsigned char* v = r.bytes(uint64_t(count > 0 ? count : 0) * 16 * sizeof(GLfloat));
+            if (issue && v) glUniformMatrix4fv(uniform(loc), count, transpose, (const GLfloat*)scratch_copy(v, size_t(count) * 16 * sizeof(GLfloat)));
+            break;
+        }
+
+        case GlOp::DrawArrays: {
+            const GLenum mode = r.get<GLenum>();
+            const GLint first = r.get<GLint>();
+            const GLsizei count = r.get<GLsizei>();
+            if (issue) glDrawArrays(mode, first, count);
+            break;
+        }
+        case GlOp::DrawElements: {
+            const GLenum mode = r.get<GLenum>();
+            const GLsizei count = r.get<GLsizei>();
+            const GLenum type = r.get<GLenum>();
+            const void* offset = pointer();
+            if (issue) glDrawElements(mode, count, type, offset);
+            break;
+        }
+        case GlOp::DrawElementsIndirect: {
+            const GLenum mode = r.get<GLenum>(), type = r.get<GLenum>();
+            const void* offset = pointer();
+            if (issue) glDrawElementsIndirect(mode, type, offset);
+            break;
+        }
+        case GlOp::DispatchCompute: {
+            const GLuint x = r.get<GLuint>(), y = r.get<GLuint>(), z = r.get<GLuint>();
+            if (issue) glDispatchCompute(x, y, z);
+            break;
+        }
+        case GlOp::MemoryBarrier: { const GLbitfield b = r.get<GLbitfield>(); if (issue) glMemoryBarrier(b); break; }
+
+        case GlOp::GenQueries: gen(queries_, glGenQueries); break;
+        case GlOp::DeleteQueries: del(queries_, glDeleteQueries); break;
+        case GlOp::BeginQuery: {
+            const GLenum target = r.get<GLenum>();
+            const GLuint id = r.get<GLuint>();
+            if (issue) glBeginQuery(target, mapped(queries_, id));
+            break;
+        }
+        case GlOp::EndQuery: { const GLenum target = r.get<GLenum>(); if (issue) glEndQuery(target); break; }
+        case GlOp::GetQueryObjectiv: {
+            const GLuint id = r.get<GLuint>();
+            const GLenum pname = r.get<GLenum>();
+            if (issue) glGetQueryObjectiv(mapped(queries_, id), pname, (GLint*)scratch(sizeof(GLint)));
+            break;
+        }
+        case GlOp::GetQueryObjectui64v: {
+            const GLuint id = r.get<GLuint>();
+            const GLenum pname = r.get<GLenum>();
+            if (issue) glGetQueryObjectui64v(mapped(queries_, id), pname, (GLuint64*)scratch(sizeof(GLuint64)));
+            break;
+        }
+
+        case GlOp::FenceSync: {
+            const GLenum condition = r.get<GLenum>();
+            const GLbitfield flags = r.get<GLbitfield>();
+            const uint64_t captured = r.get<uint64_t>();
+            if (issue) {
+                // a repeated frame creates its fence again; the frame after it, which deleted it, is not replayed
+                GLsync& sync = syncs_[captured];
+                if (sync) glDeleteSync(sync);
+                sync = glFenceSync(condition, flags);
+            }
+            break;
+        }
+        case GlOp::ClientWaitSync: {
+            const uint64_t captured = r.get<uint64_t>();
+            const GLbitfield flags = r.get<GLbitfield>();
+            const GLuint64 timeout = r.get<GLuint64>();
+            if (issue) {
+                auto it = syncs_.find(captured);
+                if (it != syncs_.end()) (void)glClientWaitSync(it->second, flags, timeout);
+            }
+            break;
+        }
+        case GlOp::DeleteSync: {
+            const uint64_t captured = r.get<uint64_t>();
+            if (issue) {
+                auto it = syncs_.find(captured);
+                if (it != syncs_.end()) {
+                    glDeleteSync(it->second);
+                    syncs_.erase(it);
+                }
+            }
+            break;
+        }
+
+        case GlOp::GetIntegerv: {
+            const GLenum pname = r.get<GLenum>();
+            if (issue) glGetIntegerv(pname, (GLint*)scratch(16 * sizeof(GLint)));
+            break;
+        }
+        case GlOp::GetBooleanv: {
+            const GLenum pname = r.get<GLenum>();
+            if (issue) glGetBooleanv(pname, (GLboolean*)scratch(16 * sizeof(GLboolean)));
+            break;
+        }
+        case GlOp::GetStringi: {
+            const GLenum name = r.get<GLenum>();
+            const GLuint index = r.get<GLuint>();
+            if (issue) (void)glGetStringi(name, index);
+            break;
+        }
+        case GlOp::Scissor: {
+            const GLint x = r.get<GLint>(), y = r.get<GLint>();
+            const GLsizei w = r.get<GLsizei>(), h = r.get<GLsizei>();
+            if (issue) glScissor(x, y, w, h);
+            break;
+        }
+
+        default:
+            return false;
+        }
+    }
+    if (!issue && !frames_.empty() && !frames_.back().end) frames_.pop_back();  // cut off mid-frame
+    return r.ok;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+// glcapture.h
+// GL command capture through the glad function pointers, and the replayer behind splender_glreplay.
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// One per intercepted entry point (the calls renderer, app, silhouette and debug view code makes).
+// Appending is fine, reordering breaks older captures.
+enum class GlOp : uint16_t {
+    FrameBegin, FrameEnd,
+    Enable, Disable, IsEnabled, BlendFunc, DepthMask, CullFace, FrontFace, LineWidth, Viewport,
+    ClearColor, Clear, PixelStorei,
+    GenBuffers, DeleteBuffers, BindBuffer, BindBufferBase, BufferData, BufferSubData, GetBufferSubData,
+    GenVertexArrays, DeleteVertexArrays, BindVertexArray, VertexAttribPointer,
+    EnableVertexAttribArray, DisableVertexAttribArray,
+    GenTextures, DeleteTextures, BindTexture, ActiveTexture, TexParameteri, TexParameterf, TexImage2D,
+    CompressedTexImage2D, BindImageTexture,
+    GenFramebuffers, DeleteFramebuffers, BindFramebuffer, FramebufferTexture2D, FramebufferRenderbuffer,
+    CheckFramebufferStatus, BlitFramebuffer,
+    GenRenderbuffers, DeleteRenderbuffers, BindRenderbuffer, RenderbufferStorageMultisample,
+    CreateShader, ShaderSource, CompileShader, GetShaderiv, GetShaderInfoLog, DeleteShader,
+    CreateProgram, AttachShader, LinkProgram, GetProgramiv, GetProgramInfoLog, DeleteProgram, UseProgram,
+    GetUniformLocation, Uniform1i, Uniform1ui, Uniform1f, Uniform2f, Uniform3f, Uniform3fv, UniformMatrix4fv,
+    DrawArrays, DrawElements, DrawElementsIndirect, DispatchCompute, MemoryBarrier,
+    GenQueries, DeleteQueries, BeginQuery, EndQuery, GetQueryObjectiv, GetQueryObjectui64v,
+    FenceSync, ClientWaitSync, DeleteSync,
+    GetIntegerv, GetBooleanv, GetStringi,
+    Scissor,
+    Count
+};
+
+const char* gl_op_name(GlOp op);
+
+// Calls of one captured frame
+struct GlFrameCounts {
+    uint32_t frame = 0;
+    uint32_t calls = 0;
+    uint32_t draws = 0;         // draw and dispatch calls
+    uint64_t uploadBytes = 0;   // buffer and texture data handed to GL
+};
+
+// Swaps the glad pointers of the GlOp entry points for recording wrappers. Outside the captured
+// frames only calls that create or change objects and state go to the file (with their data), so
+// any frame can be replayed from the stream before it; draws, clears, dispatches, queries and
+// readbacks are dropped there. Inside them every call is written. ImGui draws through its own GL
+// loader and is not captured. Main thread only.
+class GlCapture {
+public:
+    GlCapture() = default;
+    ~GlCapture();
+    GlCapture(const GlCapture&) = delete;
+    GlCapture& operator=(const GlCapture&) = delete;
+
+    // right after gladLoadGLLoader, so every object the frames use is created on record
+    bool start(const std::string& path, int width, int height);
+    bool active() const { return out_.is_open(); }
+
+    // frames by index (the frame loop's count from 0); captureNext starts with the next frame
+    void captureFrames(uint32_t first, uint32_t count);
+    void captureNext(uint32_t count);
+
+    void beginFrame(int framebufferWidth, int framebufferHeight);
+    void endFrame();
+
+    // restores the glad pointers, closes the file and prints the captured frames' call counts
+    void finish();
+
+    // for the wrappers
+    bool record(GlOp op, bool work);
+    void put(const void* data, size_t bytes);
+    void countUpload(size_t bytes);
+
+private:
+    void flush();
+
+    std::ofstream out_;
+    std::string path_;
+    std::vector<unsigned char> buf_;
+    uint64_t written_ = 0;
+    uint32_t frame_ = 0;
+    uint32_t first_ = UINT32_MAX, end_ = 0;   // captured frame range [first_, end_)
+    bool inFrame_ = false;
+    std::vector<GlFrameCounts> counts_;
+};
+
+// A captured frame as the replayer sees it
+struct GlReplayFrame {
+    GlFrameCounts counts;
+    int width = 0, height = 0;
+    size_t begin = 0, end = 0;          // byte range of its calls
+    uint32_t ops[(size_t)GlOp::Count] = {};
+};
+
+// Re-issues a capture on the current context. run() plays the whole stream once (setup, state
+// changes and every captured frame in order); runFrame() repeats one captured frame, which assumes
+// the frame sets the state it uses, as the app's frames do. Object names, uniform locations and
+// syncs are mapped to the ones this driver hands out.
+class GlReplayer {
+public:
+    bool load(const std::string& path);
+
+    const std::vector<GlReplayFrame>& frames() const { return frames_; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    void run();
+    void runFrame(size_t index);
+
+private:
+    bool execute(size_t begin, size_t end, bool issue);
+
+    std::vector<unsigned char> data_;
+    size_t streamBegin_ = 0;
+    int width_ = 0, height_ = 0;
+    std::vector<GlReplayFrame> frames_;
+
+    std::unordered_map<GLuint, GLuint> buffers_, vertexArrays_, textures_, framebuffers_, renderbuffers_;
+    std::unordered_map<GLuint, GLuint> shaders_, programs_, queries_;
+    std::unordered_map<uint64_t, GLint> uniforms_;  // (captured program << 32 | captured location)
+    std::unordered_map<uint64_t, GLsync> syncs_;
+    GLuint currentProgram_ = 0;                       // captured name, for uniform locations
+    std::vector<unsigned char> scratch_;              // readback target
+};
@@ -0,0 +1,120 @@
+// glreplay.cpp
+// splender_glreplay <capture> [iterations] [--ops]: replays a GL capture (splender_gl --gl-capture)
+// in a hidden window as fast as the driver goes, for comparing drivers and GPUs on the same frames
+// without the app, its input or its loader in the way
+
+#include "glcapture.h"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+static double ms_since(std::chrono::steady_clock::time_point t)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t).count();
+}
+
+int main(int argc, char** argv)
+{
+    std::string path;
+    int iterations = 100;
+    bool showOps = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--ops") == 0) showOps = true;
+        else if (path.empty()) path = argv[i];
+        else iterations = std::max(1, std::atoi(argv[i]));
+    }
+    if (path.empty()) {
+        std::cerr << "usage: splender_glreplay <capture> [iterations] [--ops]\n";
+        return 2;
+    }
+
+    GlReplayer replayer;
+    if (!replayer.load(path)) return 1;
+    if (replayer.frames().empty()) {
+        std::cerr << "splender_glreplay: " << path << " has no captured frame\n";
+        return 1;
+    }
+
+    // same context request as the app, just never shown or swapped
+    if (!glfwInit()) {
+        std::cerr << "splender_glreplay: glfwInit failed\n";
+        return 1;
+    }
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_SAMPLES, 0);
+    GLFWwindow* window = glfwCreateWindow(std::max(1, replayer.width()), std::max(1, replayer.height()),
+                                          "splender_glreplay", nullptr, nullptr);
+    if (!window) {
+        std::cerr << "splender_glreplay: cannot create a GL context\n";
+        glfwTerminate();
+        return 1;
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cerr << "splender_glreplay: glad init failed\n";
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return 1;
+    }
+    std::cout << "GL: " << (const char*)glGetString(GL_RENDERER) << " (" << (const char*)glGetString(GL_VERSION) << ")\n";
+
+    // setup, state changes and every frame once: compiles shaders and uploads the data
+    auto t = std::chrono::steady_clock::now();
+    replayer.run();
+    glFinish();
+    std::printf("%s: %zu frames, first pass %.1f ms\n", path.c_str(), replayer.frames().size(), ms_since(t));
+
+    // then each frame repeated: submit is the CPU cost of issuing the calls, total adds glFinish
+    const size_t frameCount = replayer.frames().size();
+    std::vector<double> submitSum(frameCount, 0.0), totalSum(frameCount, 0.0);
+    std::vector<double> submitMin(frameCount, 1e30), totalMin(frameCount, 1e30);
+    for (int it = 0; it < iterations; ++it) {
+        for (size_t f = 0; f < frameCount; ++f) {
+            t = std::chrono::steady_clock::now();
+            replayer.runFrame(f);
+            const double submit = ms_since(t);
+            glFinish();
+            const double total = ms_since(t);
+            submitSum[f] += submit;
+            totalSum[f] += total;
+            submitMin[f] = std::min(submitMin[f], submit);
+            totalMin[f] = std::min(totalMin[f], total);
+        }
+    }
+
+    std::printf("%8s %7s %6s %10s %10s %9s %10s %9s\n",
+                "frame", "calls", "draws", "upload MB", "submit ms", "min", "total ms", "min");
+    for (size_t f = 0; f < frameCount; ++f) {
+        const GlFrameCounts& c = replayer.frames()[f].counts;
+        std::printf("%8u %7u %6u %10.2f %10.3f %9.3f %10.3f %9.3f\n",
+                    c.frame, c.calls, c.draws, double(c.uploadBytes) / (1024.0 * 1024.0),
+                    submitSum[f] / iterations, submitMin[f], totalSum[f] / iterations, totalMin[f]);
+    }
+    std::printf("(%d iterations)\n", iterations);
+
+    if (showOps) {
+        for (const GlReplayFrame& frame : replayer.frames()) {
+            std::vector<std::pair<uint32_t, GlOp>> ops;
+            for (size_t op = 0; op < (size_t)GlOp::Count; ++op) {
+                if (frame.ops[op]) ops.emplace_back(frame.ops[op], (GlOp)op);
+            }
+            std::sort(ops.begin(), ops.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+            std::printf("frame %u:", frame.counts.frame);
+            for (const auto& [count, op] : ops) std::printf(" %s %u", gl_op_name(op), count);
+            std::printf("\n");
+        }
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
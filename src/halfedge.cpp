@@ -0,0 +1,179 @@
+// halfedge.cpp
+// Implements the half-edge builder declared in halfedge.h
+
+#include "halfedge.h"
+#include "threadpool.h"
+#include "scratchpool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+float HalfEdgeMesh::dihedralAngle(unsigned int h) const
+{
+    const unsigned int t = twin[h];
+    if (t == invalid) return -1.0f;
+    const glm::vec3& n0 = faceNormals[face(h)];
+    glm::vec3 n1 = faceNormals[face(t)];
+    if (twinSameDirection(h)) n1 = -n1; // inconsistent winding, compare the surfaces not the normals
+    return std::acos(glm::clamp(glm::dot(n0, n1), -1.0f, 1.0f));
+}
+
+void build_half_edge_mesh(const std::vector<glm::vec3>& positions,
+                          const std::vector<unsigned int>& indices,
+                          HalfEdgeMesh& out)
+{
+    out = HalfEdgeMesh{};
+    const size_t halfCount = indices.size() / 3 * 3;
+    const size_t faceCount = halfCount / 3;
+    ThreadPool& pool = globalThreadPool();
+
+    // weld by exact position: sort vertex ids by position and number the runs
+    ScratchVector<unsigned int> posId(positions.size());
+    {
+        ScratchVector<unsigned int> order(positions.size());
+        for (size_t v = 0; v < order.size(); ++v) order[v] = (unsigned int)v;
+        parallel_sort(order, [&](unsigned int a, unsigned int b) {
+            const glm::vec3& pa = positions[a];
+            const glm::vec3& pb = positions[b];
+            if (pa.x != pb.x) return pa.x < pb.x;
+            if (pa.y != pb.y) return pa.y < pb.y;
+            if (pa.z != pb.z) return pa.z < pb.z;
+            return a < b;
+        });
+        unsigned int id = 0;
+        for (size_t i = 0; i < order.size(); ++i) {
+            if (i > 0 && positions[order[i]] != positions[order[i - 1]]) ++id;
+            posId[order[i]] = id;
+        }
+        out.positionCount = order.empty() ? 0 : id + 1;
+    }
+
+    out.origin.resize(halfCount);
+    out.twin.assign(halfCount, HalfEdgeMesh::invalid);
+    out.nonManifold.assign(halfCount, 0);
+    out.faceNormals.resize(faceCount);
+
+    // undirected edge key per half-edge, sorted so all sides of an edge are neighbours
+    struct EdgeRef { uint64_t key; unsigned int half; };
+    ScratchVector<EdgeRef> edges(halfCount);
+    pool.parallel_for(0, faceCount, 8192, [&](size_t b, size_t e) {
+        for (size_t t = b; t < e; ++t) {
+            for (unsigned int c = 0; c < 3; ++c) {
+                const unsigned int h = (unsigned int)(t * 3 + c);
+                const unsigned int a = posId[indices[h]];
+                const unsigned int z = posId[indices[HalfEdgeMesh::next(h)]];
+                out.origin[h] = a;
+                edges[h] = EdgeRef{ a < z ? ((uint64_t)a << 32 | z) : ((uint64_t)z << 32 | a), h };
+            }
+            const glm::vec3& p0 = positions[indices[t * 3 + 0]];
+            glm::vec3 n = glm::cross(positions[indices[t * 3 + 1]] - p0, positions[indices[t * 3 + 2]] - p0);
+            const float len = glm::length(n);
+            out.faceNormals[t] = len > 0.0f ? n / len : glm::vec3(0.0f);
+        }
+    });
+    parallel_sort(edges, [](const EdgeRef& x, const EdgeRef& y) {
+        return x.key != y.key ? x.key < y.key : x.half < y.half;
+    });
+
+    for (size_t i = 0; i < edges.size();) {
+        size_t j = i + 1;
+        while (j < edges.size() && edges[j].key == edges[i].key) ++j;
+        const size_t n = j - i;
+        out.edgeCount++;
+        if (n == 2 && HalfEdgeMesh::face(edges[i].half) != HalfEdgeMesh::face(edges[i + 1].half)) {
+            out.twin[edges[i].half] = edges[i + 1].half;
+            out.twin[edges[i + 1].half] = edges[i].half;
+        } else if (n == 1) {
+            out.boundaryEdges++;
+        } else {
+            out.nonManifoldEdges++;
+            for (size_t k = i; k < j; ++k) out.nonManifold[edges[k].half] = 1;
+        }
+        i = j;
+    }
+
+    // components through manifold edges (union-find, smaller root wins)
+    ScratchVector<unsigned int> parent(faceCount);
+    for (size_t t = 0; t < faceCount; ++t) parent[t] = (unsigned int)t;
+    auto find = [&](unsigned int x) {
+        while (parent[x] != x) { parent[x] = parent[parent[x]]; x = parent[x]; }
+        return x;
+    };
+    for (size_t h = 0; h < halfCount; ++h) {
+        const unsigned int t = out.twin[h];
+        if (t == HalfEdgeMesh::invalid) continue;
+        const unsigned int a = find(HalfEdgeMesh::face((unsigned int)h)), b = find(HalfEdgeMesh::face(t));
+        if (a != b) parent[std::max(a, b)] = std::min(a, b);
+    }
+    out.component.resize(faceCount);
+    ScratchVector<unsigned int> label(faceCount, HalfEdgeMesh::invalid);
+    for (size_t t = 0; t < faceCount; ++t) {
+        const unsigned int r = find((unsigned int)t);
+        if (label[r] == HalfEdgeMesh::invalid) label[r] = (unsigned int)out.componentCount++;
+        out.component[t] = label[r];
+    }
+}
+
+size_t build_edge_lines(const HalfEdgeMesh& mesh,
+                        const std::vector<unsigned int>& indices,
+                        float creaseDegrees,
+                        std::vector<unsigned int>& lines)
+{
+    lines.clear();
+    const size_t halfCount = mesh.twin.size();
+    const float crease = glm::radians(creaseDegrees);
+
+    // 0 = not drawn (the twin with the lower id draws), 1 = plain edge, 2 = feature edge.
+    // Non-manifold edges are drawn once per face; they are rare and always features.
+    ScratchVector<unsigned char> kind(halfCount, 0);
+    globalThreadPool().parallel_for(0, halfCount, 16384, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            const unsigned int h = (unsigned int)i;
+            const unsigned int t = mesh.twin[h];
+            if (t == HalfEdgeMesh::invalid) { kind[h] = 2; continue; }
+            if (t < h) continue;
+            kind[h] = mesh.dihedralAngle(h) > crease ? 2 : 1;
+        }
+    });
+
+    lines.reserve(mesh.edgeCount * 2);
+    size_t featureCount = 0;
+    for (int want = 2; want >= 1; --want) {
+        for (size_t h = 0; h < halfCount; ++h) {
+            if (kind[h] != want) continue;
+            lines.push_back(indices[h]);
+            lines.push_back(indices[HalfEdgeMesh::next((unsigned int)h)]);
+        }
+        if (want == 2) featureCount = lines.size();
+    }
+    return featureCount;
+}
+
+void build_silhouette_edges(const HalfEdgeMesh& mesh,
+                            const std::vector<unsigned int>& indices,
+                            std::vector<unsigned int>& edges)
+{
+    // one record per manifold twin pair (lower id) and per open half-edge
+    const size_t halfCount = mesh.twin.size();
+    ScratchVector<unsigned int> slot(halfCount + 1, 0);
+    for (size_t h = 0; h < halfCount; ++h) {
+        const unsigned int t = mesh.twin[h];
+        slot[h + 1] = slot[h] + ((t == HalfEdgeMesh::invalid || t > h) ? 1u : 0u);
+    }
+    edges.assign(size_t(slot[halfCount]) * 4, 0);
+    globalThreadPool().parallel_for(0, halfCount, 16384, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            if (slot[i + 1] == slot[i]) continue;
+            const unsigned int h = (unsigned int)i;
+            const unsigned int t = mesh.twin[h];
+            unsigned int* r = &edges[size_t(slot[h]) * 4];
+            r[0] = indices[HalfEdgeMesh::prev(h)];
+            r[1] = indices[h];
+            r[2] = indices[HalfEdgeMesh::next(h)];
+            r[3] = (t == HalfEdgeMesh::invalid) ? r[0] : indices[HalfEdgeMesh::prev(t)];
+        }
+    });
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+// halfedge.h
+// Compact index-based half-edge connectivity for triangle meshes, built on the thread pool.
+
+#include <cstddef>
+#include <vector>
+#include <glm/vec3.hpp>
+
+// Half-edge h = 3 * t + c runs from corner c to corner (c + 1) % 3 of triangle t, so next/prev/face
+// are arithmetic and only the twins are stored. Vertices are welded by exact position first, so
+// uv/normal seams don't show up as boundaries. Edges with more than two faces are non-manifold:
+// their half-edges get no twin and count towards nonManifoldEdges instead.
+struct HalfEdgeMesh {
+    static constexpr unsigned int invalid = 0xFFFFFFFFu;
+
+    std::vector<unsigned int> origin;      // welded position id of each half-edge's start
+    std::vector<unsigned int> twin;        // opposite half-edge, invalid on boundary / non-manifold edges
+    std::vector<unsigned char> nonManifold;// half-edge lies on an edge shared by 3+ faces
+    std::vector<unsigned int> component;   // per face, connected through manifold edges
+    std::vector<glm::vec3> faceNormals;    // unit length, zero for degenerate faces
+
+    size_t positionCount = 0;
+    size_t edgeCount = 0;                  // undirected
+    size_t boundaryEdges = 0;
+    size_t nonManifoldEdges = 0;
+    size_t componentCount = 0;
+
+    size_t faceCount() const { return twin.size() / 3; }
+    static unsigned int face(unsigned int h) { return h / 3; }
+    static unsigned int next(unsigned int h) { return h - h % 3 + (h % 3 + 1) % 3; }
+    static unsigned int prev(unsigned int h) { return h - h % 3 + (h % 3 + 2) % 3; }
+
+    bool isBoundary(unsigned int h) const { return twin[h] == invalid && !nonManifold[h]; }
+    bool isNonManifold(unsigned int h) const { return nonManifold[h] != 0; }
+
+    // angle between the two face normals across h in radians (0 = coplanar), -1 on open edges
+    float dihedralAngle(unsigned int h) const;
+
+    // true when the faces across h are wound the same way round (i.e. inconsistent)
+    bool twinSameDirection(unsigned int h) const { return origin[h] == origin[twin[h]]; }
+};
+
+// build connectivity for an indexed triangle list
+void build_half_edge_mesh(const std::vector<glm::vec3>& positions,
+                          const std::vector<unsigned int>& indices,
+                          HalfEdgeMesh& out);
+
+// edge-adjacency list for SilhouetteRenderer: (opposite vertex A, v0, v1, opposite vertex B) per
+// undirected edge, indices into the original vertex buffer. Open edges repeat A as B.
+void build_silhouette_edges(const HalfEdgeMesh& mesh,
+                            const std::vector<unsigned int>& indices,
+                            std::vector<unsigned int>& edges);
+
+// GL_LINES index pairs (into the original vertex buffer), one per undirected edge, feature edges
+// first: boundaries, non-manifold edges and creases sharper than creaseDegrees.
+// Returns the number of indices that belong to feature edges.
+size_t build_edge_lines(const HalfEdgeMesh& mesh,
+                        const std::vector<unsigned int>& indices,
+                        float creaseDegrees,
+                        std::vector<unsigned int>& lines);
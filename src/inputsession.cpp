@@ -0,0 +1,473 @@
+// inputsession.cpp
+// Implements InputSession declared in inputsession.h
+
+#include "inputsession.h"
+
+#include "imgui.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+
+// file layout, little endian: magic, version, window size, model path, last frame, event count,
+// then per event frame (u32), time (f32), type (u8) and a payload that depends on the type
+static const char kMagic[6] = { 'S', 'P', 'L', 'R', 'E', 'C' };
+static const uint16_t kVersion = 1;
+
+static InputSession* g_session = nullptr; // one window, so one session receives the callbacks
+
+namespace {
+
+struct ByteWriter {
+    std::vector<unsigned char> bytes;
+    template <class T> void put(T v) {
+        const size_t at = bytes.size();
+        bytes.resize(at + sizeof(T));
+        std::memcpy(bytes.data() + at, &v, sizeof(T));
+    }
+    void putString(const std::string& s) {
+        const uint16_t n = (uint16_t)std::min<size_t>(s.size(), 0xFFFF);
+        put(n);
+        bytes.insert(bytes.end(), s.begin(), s.begin() + n);
+    }
+};
+
+struct ByteReader {
+    const std::vector<unsigned char>& bytes;
+    size_t at = 0;
+    bool ok = true;
+    template <class T> T get() {
+        T v{};
+        if (at + sizeof(T) > bytes.size()) { ok = false; return v; }
+        std::memcpy(&v, bytes.data() + at, sizeof(T));
+        at += sizeof(T);
+        return v;
+    }
+    std::string getString() {
+        const uint16_t n = get<uint16_t>();
+        if (!ok || at + n > bytes.size()) { ok = false; return {}; }
+        std::string s(bytes.begin() + at, bytes.begin() + at + n);
+        at += n;
+        return s;
+    }
+};
+
+} // namespace
+
+InputSession::~InputSession()
+{
+    if (g_session == this) g_session = nullptr;
+}
+
+float InputSession::now() const
+{
+    return std::chrono::duration<float>(std::chrono::steady_clock::now() - start_).count();
+}
+
+bool InputSession::startRecording(const std::string& path, const std::string& modelPath)
+{
+    std::ofstream probe(path, std::ios::binary | std::ios::app);
+    if (!probe) {
+        std::cerr << "record: cannot write " << path << "\n";
+        return false;
+    }
+    mode_ = Mode::Record;
+    path_ = path;
+    model_ = modelPath;
+    return true;
+}
+
+bool InputSession::startReplay(const std::string& path, double fixedStepMs)
+{
+    std::ifstream in(path, std::ios::binary);
+    const std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    ByteReader r{ bytes };
+    char magic[sizeof(kMagic)] = {};
+    for (char& c : magic) c = r.get<char>();
+    if (!in.is_open() || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || r.get<uint16_t>() != kVersion) {
+        std::cerr << "replay: " << path << " is not a splender input recording\n";
+        return false;
+    }
+    windowW_ = r.get<int32_t>();
+    windowH_ = r.get<int32_t>();
+    model_ = r.getString();
+    lastFrame_ = r.get<uint32_t>();
+    const uint32_t count = r.get<uint32_t>();
+    for (uint32_t i = 0; i < count && r.ok; ++i) {
+        InputEvent e;
+        e.frame = r.get<uint32_t>();
+        e.time = r.get<float>();
+        e.type = (InputEventType)r.get<uint8_t>();
+        switch (e.type) {
+        case InputEventType::CursorPos:
+        case InputEventType::Scroll:
+            e.x = r.get<double>(); e.y = r.get<double>();
+            break;
+        case InputEventType::MouseButton:
+            e.a = r.get<uint8_t>(); e.c = r.get<uint8_t>(); e.d = r.get<uint8_t>();
+            break;
+        case InputEventType::Key:
+            e.a = r.get<int32_t>(); e.b = r.get<int32_t>(); e.c = r.get<uint8_t>(); e.d = r.get<uint8_t>();
+            break;
+        case InputEventType::Char:
+            e.a = (int32_t)r.get<uint32_t>();
+            break;
+        case InputEventType::CursorEnter:
+        case InputEventType::Focus:
+            e.a = r.get<uint8_t>();
+            break;
+        case InputEventType::WindowSize:
+            e.a = r.get<int32_t>(); e.b = r.get<int32_t>();
+            break;
+        case InputEventType::Import:
+            e.path = r.getString();
+            break;
+        case InputEventType::LoadApplied:
+            break;
+        default:
+            r.ok = false;
+            break;
+        }
+        if (!r.ok) break;
+        if (e.type == InputEventType::Import) imports_.push_back(std::move(e));
+        else if (e.type == InputEventType::LoadApplied) loads_.push_back(e.frame);
+        else events_.push_back(std::move(e));
+    }
+    if (!r.ok) {
+        std::cerr << "replay: " << path << " is truncated\n";
+        return false;
+    }
+    mode_ = Mode::Replay;
+    path_ = path;
+    fixedStepMs_ = std::max(0.0, fixedStepMs);
+    std::cout << "replay: " << path << ", " << lastFrame_ << " frames, " << events_.size() << " input events, "
+              << imports_.size() << " imports\n";
+    return true;
+}
+
+void InputSession::install(GLFWwindow* window)
+{
+    window_ = window;
+    g_session = this;
+    prevCursorPos_ = glfwSetCursorPosCallback(window, cursorPosCallback);
+    prevMouseButton_ = glfwSetMouseButtonCallback(window, mouseButtonCallback);
+    prevScroll_ = glfwSetScrollCallback(window, scrollCallback);
+    prevKey_ = glfwSetKeyCallback(window, keyCallback);
+    prevChar_ = glfwSetCharCallback(window, charCallback);
+    prevCursorEnter_ = glfwSetCursorEnterCallback(window, cursorEnterCallback);
+    prevFocus_ = glfwSetWindowFocusCallback(window, focusCallback);
+    prevWindowSize_ = glfwSetWindowSizeCallback(window, windowSizeCallback);
+
+    start_ = frameStart_ = std::chrono::steady_clock::now();
+    if (mode_ == Mode::Replay) {
+        if (windowW_ > 0 && windowH_ > 0) {
+            glfwRestoreWindow(window);
+            glfwSetWindowSize(window, windowW_, windowH_);
+        }
+        // the cursor counts as inside the window throughout, so ImGui never polls the real one
+        InputEvent enter;
+        enter.type = InputEventType::CursorEnter;
+        enter.a = 1;
+        deliver(enter);
+        while (nextEvent_ < events_.size() && events_[nextEvent_].frame == 0) deliver(events_[nextEvent_++]);
+        return;
+    }
+
+    glfwGetWindowSize(window, &windowW_, &windowH_);
+    InputEvent cursor;
+    cursor.type = InputEventType::CursorPos;
+    glfwGetCursorPos(window, &cursor.x, &cursor.y);
+    live(cursor);
+}
+
+void InputSession::live(InputEvent e)
+{
+    if (mode_ == Mode::Replay) return; // real input is ignored while replaying
+    if (mode_ == Mode::Record) {
+        e.frame = frame_;
+        e.time = now();
+        events_.push_back(e);
+    }
+    deliver(e);
+}
+
+void InputSession::deliver(const InputEvent& e)
+{
+    GLFWwindow* w = window_;
+    switch (e.type) {
+    case InputEventType::CursorPos:
+        state_.cursorX = e.x;
+        state_.cursorY = e.y;
+        if (prevCursorPos_) prevCursorPos_(w, e.x, e.y);
+        break;
+    case InputEventType::MouseButton:
+        if (e.a >= 0 && e.a <= GLFW_MOUSE_BUTTON_LAST) state_.buttons[e.a] = e.c != GLFW_RELEASE;
+        if (prevMouseButton_) prevMouseButton_(w, e.a, e.c, e.d);
+        break;
+    case InputEventType::Scroll:
+        if (prevScroll_) prevScroll_(w, e.x, e.y);
+        break;
+    case InputEventType::Key:
+        if (e.a >= 0 && e.a <= GLFW_KEY_LAST) state_.keys[e.a] = e.c != GLFW_RELEASE;
+        if (prevKey_) prevKey_(w, e.a, e.b, e.c, e.d);
+        break;
+    case InputEventType::Char:
+        if (prevChar_) prevChar_(w, (unsigned int)e.a);
+        break;
+    case InputEventType::CursorEnter:
+        // replay keeps the cursor inside (see install), leaving would make ImGui poll the real one
+        if (mode_ == Mode::Replay && !e.a) break;
+        if (prevCursorEnter_) prevCursorEnter_(w, e.a);
+        break;
+    case InputEventType::Focus:
+        if (prevFocus_) prevFocus_(w, e.a);
+        break;
+    case InputEventType::WindowSize:
+        if (mode_ == Mode::Replay) glfwSetWindowSize(w, e.a, e.b);
+        else if (prevWindowSize_) prevWindowSize_(w, e.a, e.b);
+        break;
+    default:
+        break;
+    }
+
+    // the ImGui backend reads modifiers from the real keyboard on key and button events
+    if (mode_ == Mode::Replay && ImGui::GetCurrentContext() &&
+        (e.type == InputEventType::Key || e.type == InputEventType::MouseButton)) {
+        ImGuiIO& io = ImGui::GetIO();
+        io.AddKeyEvent(ImGuiMod_Ctrl, state_.key(GLFW_KEY_LEFT_CONTROL) || state_.key(GLFW_KEY_RIGHT_CONTROL));
+        io.AddKeyEvent(ImGuiMod_Shift, state_.key(GLFW_KEY_LEFT_SHIFT) || state_.key(GLFW_KEY_RIGHT_SHIFT));
+        io.AddKeyEvent(ImGuiMod_Alt, state_.key(GLFW_KEY_LEFT_ALT) || state_.key(GLFW_KEY_RIGHT_ALT));
+        io.AddKeyEvent(ImGuiMod_Super, state_.key(GLFW_KEY_LEFT_SUPER) || state_.key(GLFW_KEY_RIGHT_SUPER));
+    }
+}
+
+void InputSession::recordImport(const std::string& path)
+{
+    if (mode_ != Mode::Record) return;
+    InputEvent e;
+    e.type = InputEventType::Import;
+    e.frame = frame_;
+    e.time = now();
+    e.path = path;
+    events_.push_back(e);
+}
+
+void InputSession::dispatchActions(const std::function<void(const std::string&)>& importModel)
+{
+    if (mode_ != Mode::Replay) return;
+    while (nextImport_ < imports_.size() && imports_[nextImport_].frame <= frame_) {
+        importModel(imports_[nextImport_++].path);
+    }
+}
+
+void InputSession::noteLoadApplied()
+{
+    if (mode_ == Mode::Replay) {
+        if (nextLoad_ < loads_.size()) ++nextLoad_;
+    } else if (mode_ == Mode::Record) {
+        InputEvent e;
+        e.type = InputEventType::LoadApplied;
+        e.frame = frame_;
+        e.time = now();
+        events_.push_back(e);
+    }
+}
+
+bool InputSession::holdLoads() const
+{
+    return mode_ == Mode::Replay && nextLoad_ < loads_.size() && loads_[nextLoad_] > frame_;
+}
+
+bool InputSession::loadDue() const
+{
+    return mode_ == Mode::Replay && nextLoad_ < loads_.size() && loads_[nextLoad_] <= frame_;
+}
+
+void InputSession::endFrame(double workMs)
+{
+    const auto t = std::chrono::steady_clock::now();
+    if (mode_ == Mode::Replay && frame_ < lastFrame_) {
+        stats_.push_back(ReplayFrameStats{ std::chrono::duration<double, std::milli>(t - frameStart_).count(), workMs });
+    }
+    frameStart_ = t;
+    ++frame_;
+    if (mode_ == Mode::Record) lastFrame_ = frame_;
+    if (mode_ != Mode::Replay) return;
+    while (nextEvent_ < events_.size() && events_[nextEvent_].frame <= frame_) deliver(events_[nextEvent_++]);
+}
+
+bool InputSession::finished() const
+{
+    return mode_ == Mode::Replay && frame_ >= lastFrame_;
+}
+
+static double percentile(const std::vector<double>& sorted, double q)
+{
+    if (sorted.empty()) return 0.0;
+    return sorted[std::min(sorted.size() - 1, size_t(q * double(sorted.size() - 1) + 0.5))];
+}
+
+bool InputSession::finish(const std::string& statsCsv)
+{
+    if (mode_ == Mode::Record) {
+        ByteWriter w;
+        for (char c : kMagic) w.put(c);
+        w.put(kVersion);
+        w.put((int32_t)windowW_);
+        w.put((int32_t)windowH_);
+        w.putString(model_);
+        w.put((uint32_t)lastFrame_);
+        w.put((uint32_t)events_.size());
+        for (const InputEvent& e : events_) {
+            w.put(e.frame);
+            w.put(e.time);
+            w.put((uint8_t)e.type);
+            switch (e.type) {
+            case InputEventType::CursorPos:
+            case InputEventType::Scroll:
+                w.put(e.x); w.put(e.y);
+                break;
+            case InputEventType::MouseButton:
+                w.put((uint8_t)e.a); w.put((uint8_t)e.c); w.put((uint8_t)e.d);
+                break;
+            case InputEventType::Key:
+                w.put((int32_t)e.a); w.put((int32_t)e.b); w.put((uint8_t)e.c); w.put((uint8_t)e.d);
+                break;
+            case InputEventType::Char:
+                w.put((uint32_t)e.a);
+                break;
+            case InputEventType::CursorEnter:
+            case InputEventType::Focus:
+                w.put((uint8_t)e.a);
+                break;
+            case InputEventType::WindowSize:
+                w.put((int32_t)e.a); w.put((int32_t)e.b);
+                break;
+            case InputEventType::Import:
+                w.putString(e.path);
+                break;
+            case InputEventType::LoadApplied:
+                break;
+            }
+        }
+        std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(w.bytes.data()), (std::streamsize)w.bytes.size());
+        if (!out) {
+            std::cerr << "record: cannot write " << path_ << "\n";
+            return false;
+        }
+        std::cout << "record: " << lastFrame_ << " frames, " << events_.size() << " events ("
+                  << w.bytes.size() / 1024 << " KB) -> " << path_ << "\n";
+        return true;
+    }
+
+    if (mode_ != Mode::Replay || stats_.empty()) return true;
+    std::vector<double> frameMs, workMs;
+    double total = 0.0, work = 0.0;
+    size_t slow = 0;
+    for (const ReplayFrameStats& s : stats_) {
+        frameMs.push_back(s.frameMs);
+        workMs.push_back(s.workMs);
+        total += s.frameMs;
+        work += s.workMs;
+        if (s.frameMs > 1000.0 / 60.0) ++slow;
+    }
+    std::sort(frameMs.begin(), frameMs.end());
+    std::sort(workMs.begin(), workMs.end());
+    const double n = double(stats_.size());
+    std::cout << std::fixed << std::setprecision(2)
+              << "replay: " << stats_.size() << " frames in " << total / 1000.0 << " s (recorded input spans "
+              << (events_.empty() ? 0.0f : events_.back().time) << " s)\n"
+              << "  frame ms: mean " << total / n << ", p50 " << percentile(frameMs, 0.5)
+              << ", p95 " << percentile(frameMs, 0.95) << ", p99 " << percentile(frameMs, 0.99)
+              << ", max " << frameMs.back() << ", over 16.7 ms: " << slow << "\n"
+              << "  work ms:  mean " << work / n << ", p95 " << percentile(workMs, 0.95)
+              << ", max " << workMs.back() << "\n";
+
+    if (statsCsv.empty()) return true;
+    std::ofstream csv(statsCsv, std::ios::trunc);
+    csv << "frame,frame_ms,work_ms\n" << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < stats_.size(); ++i) csv << i << "," << stats_[i].frameMs << "," << stats_[i].workMs << "\n";
+    if (!csv) {
+        std::cerr << "replay: cannot write " << statsCsv << "\n";
+        return false;
+    }
+    return true;
+}
+
+// GLFW callbacks: everything funnels through live(), which drops real input during a replay
+
+void InputSession::cursorPosCallback(GLFWwindow*, double x, double y)
+{
+    if (!g_session) return;
+    InputEvent e;
+    e.type = InputEventType::CursorPos;
+    e.x = x; e.y = y;
+    g_session->live(e);
+}
+
+void InputSession::mouseButtonCallback(GLFWwindow*, int button, int action, int mods)
+{
+    if (!g_session) return;
+    InputEvent e;
+    e.type = InputEventType::MouseButton;
+    e.a = button; e.c = action; e.d = mods;
+    g_session->live(e);
+}
+
+void InputSession::scrollCallback(GLFWwindow*, double x, double y)
+{
+    if (!g_session) return;
+    InputEvent e;
+    e.type = InputEventType::Scroll;
+    e.x = x; e.y = y;
+    g_session->live(e);
+}
+
+void InputSession::keyCallback(GLFWwindow*, int key, int scancode, int action, int mods)
+{
+    if (!g_session) return;
+    InputEvent e;
+    e.type = InputEventType::Key;
+    e.a = key; e.b = scancode; e.c = action; e.d = mods;
+    g_session->live(e);
+}
+
+void InputSession::charCallback(GLFWwindow*, unsigned int codepoint)
+{
+    if (!g_session) return;
+    InputEvent e;
+    e.type = InputEventType::Char;
+    e.a = (int32_t)codepoint;
+    g_session->live(e);
+}
+
+void InputSession::cursorEnterCallback(GLFWwindow*, int entered)
+{
+    if (!g_session) return;
+    InputEvent e;
+    e.type = InputEventType::CursorEnter;
+    e.a = entered;
+    g_session->live(e);
+}
+
+void InputSession::focusCallback(GLFWwindow*, int focused)
+{
+    if (!g_session) return;
+    InputEvent e;
+    e.type = InputEventType::Focus;
+    e.a = focused;
+    g_session->live(e);
+}
+
+void InputSession::windowSizeCallback(GLFWwindow*, int width, int height)
+{
+    if (!g_session) return;
+    InputEvent e;
+    e.type = InputEventType::WindowSize;
+    e.a = width; e.b = height;
+    g_session->live(e);
+}
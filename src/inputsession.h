@@ -0,0 +1,142 @@
+#pragma once
+
+// inputsession.h
+// Window input as the frame loop sees it, with recording to a compact file and deterministic replay.
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include <GLFW/glfw3.h>
+
+enum class InputEventType : uint8_t {
+    CursorPos,
+    MouseButton,
+    Scroll,
+    Key,
+    Char,
+    CursorEnter,
+    Focus,
+    WindowSize,
+    Import,         // UI action: a model import was requested (the file dialog is not replayed)
+    LoadApplied     // a finished load reached the main thread this frame
+};
+
+struct InputEvent {
+    uint32_t frame = 0;     // frame the event is consumed in
+    float time = 0.0f;      // seconds since the session started
+    InputEventType type = InputEventType::CursorPos;
+    int32_t a = 0, b = 0, c = 0, d = 0; // button/key, scancode, action, mods (per type)
+    double x = 0.0, y = 0.0;
+    std::string path;
+};
+
+// What the frame loop reads instead of polling glfwGetKey / glfwGetMouseButton / glfwGetCursorPos,
+// so live, recorded and replayed input all take the same path.
+struct InputState {
+    double cursorX = 0.0, cursorY = 0.0;
+    bool buttons[GLFW_MOUSE_BUTTON_LAST + 1] = {};
+    bool keys[GLFW_KEY_LAST + 1] = {};
+
+    bool button(int b) const { return b >= 0 && b <= GLFW_MOUSE_BUTTON_LAST && buttons[b]; }
+    bool key(int k) const { return k >= 0 && k <= GLFW_KEY_LAST && keys[k]; }
+};
+
+// Per-frame numbers collected while replaying
+struct ReplayFrameStats {
+    double frameMs = 0.0;   // start of this frame to the start of the next (swap included)
+    double workMs = 0.0;    // main-thread time before the swap
+};
+
+// Sits on top of the ImGui GLFW backend's callbacks (install after Ui_Init) and forwards to them.
+// Events are stamped with the frame that consumes them: input polled at the end of frame N belongs
+// to frame N+1. Replay swallows real input and hands the recorded events to the same callbacks at
+// the same frame boundaries, so ImGui and the app see an identical event stream; loads are held
+// until the frame they finished in during the recording. The window size is requested, but the
+// window manager has the last word on it.
+class InputSession {
+public:
+    enum class Mode { Live, Record, Replay };
+
+    InputSession() = default;
+    ~InputSession();
+
+    // Record writes the file in finish(); Replay reads it up front
+    bool startRecording(const std::string& path, const std::string& modelPath);
+    bool startReplay(const std::string& path, double fixedStepMs);
+
+    void install(GLFWwindow* window);
+
+    Mode mode() const { return mode_; }
+    bool replaying() const { return mode_ == Mode::Replay; }
+    const InputState& state() const { return state_; }
+    const std::string& recordedModel() const { return model_; }
+    uint32_t frame() const { return frame_; }
+    float fixedDeltaTime() const { return float(fixedStepMs_ / 1000.0); }
+
+    // UI actions: imports are recorded as their file path. Replay calls importModel with the
+    // recorded paths of the current frame.
+    void recordImport(const std::string& path);
+    void dispatchActions(const std::function<void(const std::string&)>& importModel);
+
+    // Load results: noted when applied (recorded, or the replay moves on to the next one). While
+    // replaying, holdLoads says to leave finished loads queued, and loadDue that this is the frame
+    // to wait for the next one.
+    void noteLoadApplied();
+    bool holdLoads() const;
+    bool loadDue() const;
+
+    // End of the frame loop body, before polling: advances the frame and, while replaying,
+    // delivers the next frame's input. workMs is this frame's main-thread time.
+    void endFrame(double workMs);
+    bool finished() const;  // replay reached the frame the recording ended on
+
+    // writes the recording or prints the replay statistics (to statsCsv too when set)
+    bool finish(const std::string& statsCsv);
+
+private:
+    static void cursorPosCallback(GLFWwindow* w, double x, double y);
+    static void mouseButtonCallback(GLFWwindow* w, int button, int action, int mods);
+    static void scrollCallback(GLFWwindow* w, double x, double y);
+    static void keyCallback(GLFWwindow* w, int key, int scancode, int action, int mods);
+    static void charCallback(GLFWwindow* w, unsigned int codepoint);
+    static void cursorEnterCallback(GLFWwindow* w, int entered);
+    static void focusCallback(GLFWwindow* w, int focused);
+    static void windowSizeCallback(GLFWwindow* w, int width, int height);
+
+    void live(InputEvent e);                 // from GLFW: record, then deliver
+    void deliver(const InputEvent& e);       // update state_ and forward to the callbacks below us
+    float now() const;
+
+    Mode mode_ = Mode::Live;
+    GLFWwindow* window_ = nullptr;
+    InputState state_;
+    uint32_t frame_ = 0;
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+
+    std::string path_;
+    std::string model_;
+    int windowW_ = 0, windowH_ = 0;     // at the start of the recording
+    std::vector<InputEvent> events_;    // recorded (all types), or the input part of a replay
+    std::vector<InputEvent> imports_;   // replay: Import actions
+    std::vector<uint32_t> loads_;       // replay: frames a load was applied in
+    size_t nextEvent_ = 0, nextImport_ = 0, nextLoad_ = 0;
+    uint32_t lastFrame_ = 0;
+    double fixedStepMs_ = 0.0;
+
+    std::chrono::steady_clock::time_point frameStart_ = start_;
+    std::vector<ReplayFrameStats> stats_;
+
+    // callbacks installed before ours (the ImGui backend, which chains to the app's own)
+    GLFWcursorposfun prevCursorPos_ = nullptr;
+    GLFWmousebuttonfun prevMouseButton_ = nullptr;
+    GLFWscrollfun prevScroll_ = nullptr;
+    GLFWkeyfun prevKey_ = nullptr;
+    GLFWcharfun prevChar_ = nullptr;
+    GLFWcursorenterfun prevCursorEnter_ = nullptr;
+    GLFWwindowfocusfun prevFocus_ = nullptr;
+    GLFWwindowsizefun prevWindowSize_ = nullptr;
+};
@@ -0,0 +1,233 @@
+// inspector.cpp
+// Implements inspect_mesh declared in inspector.h
+
+#include "inspector.h"
+#include "threadpool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <iomanip>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+static const int kOverdrawGrid = 256;
+static const size_t kCacheEntries = 64;
+
+// FNV-1a over 8-byte words of the index and position arrays
+static uint64_t mesh_content_hash(const MeshData& mesh)
+{
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        size_t i = 0;
+        for (; i + 8 <= bytes; i += 8) {
+            uint64_t w;
+            std::memcpy(&w, p + i, 8);
+            h ^= w; h *= 1099511628211ull;
+        }
+        for (; i < bytes; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+    };
+    const uint64_t counts[2] = { mesh.indices.size(), mesh.positions.size() };
+    mix(counts, sizeof(counts));
+    mix(mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int));
+    mix(mesh.positions.data(), mesh.positions.size() * sizeof(glm::vec3));
+    return h;
+}
+
+// misses of a FIFO cache of `size` entries over the index stream
+static size_t fifo_cache_misses(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int size)
+{
+    std::vector<size_t> insertedAt(vertexCount, SIZE_MAX);
+    size_t misses = 0;
+    for (unsigned int v : indices) {
+        if (v >= vertexCount) continue;
+        if (insertedAt[v] != SIZE_MAX && misses - insertedAt[v] <= size) continue; // fewer than size newer entries
+        insertedAt[v] = misses++;
+    }
+    return misses;
+}
+
+// Fragments and covered pixels of the views along +axis and -axis: (a, b) is the right-handed
+// projection plane, so a positive 2D area means the triangle faces +axis.
+static void axis_overdraw(const MeshData& mesh, const std::vector<unsigned char>& cullable, int axis,
+                          uint64_t& fragments, uint64_t& covered)
+{
+    const int a = (axis + 1) % 3, b = (axis + 2) % 3;
+    glm::vec2 lo(1e30f), hi(-1e30f);
+    for (const glm::vec3& p : mesh.positions) {
+        lo = glm::min(lo, glm::vec2(p[a], p[b]));
+        hi = glm::max(hi, glm::vec2(p[a], p[b]));
+    }
+    const float extent = std::max(hi.x - lo.x, hi.y - lo.y);
+    if (!(extent > 0.0f)) return;
+    const float scale = float(kOverdrawGrid) / extent;
+
+    std::vector<uint32_t> pos(size_t(kOverdrawGrid) * kOverdrawGrid, 0), neg(pos.size(), 0);
+    const size_t triCount = mesh.indices.size() / 3;
+    for (size_t t = 0; t < triCount; ++t) {
+        glm::vec2 v[3];
+        for (int c = 0; c < 3; ++c) {
+            const glm::vec3& p = mesh.positions[mesh.indices[3 * t + c]];
+            v[c] = (glm::vec2(p[a], p[b]) - lo) * scale;
+        }
+        const float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+        if (area == 0.0f) continue;
+        // the renderer draws open parts two-sided: they count in both directions
+        const bool toPos = area > 0.0f || !cullable[t];
+        const bool toNeg = area < 0.0f || !cullable[t];
+        if (area < 0.0f) std::swap(v[1], v[2]); // counter-clockwise for the edge tests
+
+        const int x0 = std::max(0, (int)std::floor(std::min({ v[0].x, v[1].x, v[2].x })));
+        const int y0 = std::max(0, (int)std::floor(std::min({ v[0].y, v[1].y, v[2].y })));
+        const int x1 = std::min(kOverdrawGrid - 1, (int)std::ceil(std::max({ v[0].x, v[1].x, v[2].x })));
+        const int y1 = std::min(kOverdrawGrid - 1, (int)std::ceil(std::max({ v[0].y, v[1].y, v[2].y })));
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                const glm::vec2 c(x + 0.5f, y + 0.5f);
+                bool inside = true;
+                for (int e = 0; e < 3 && inside; ++e) {
+                    const glm::vec2& p0 = v[e];
+                    const glm::vec2& p1 = v[(e + 1) % 3];
+                    inside = (p1.x - p0.x) * (c.y - p0.y) - (p1.y - p0.y) * (c.x - p0.x) >= 0.0f;
+                }
+                if (!inside) continue;
+                const size_t i = size_t(y) * kOverdrawGrid + x;
+                if (toPos) ++pos[i];
+                if (toNeg) ++neg[i];
+            }
+        }
+    }
+    for (size_t i = 0; i < pos.size(); ++i) {
+        fragments += uint64_t(pos[i]) + neg[i];
+        covered += (pos[i] ? 1 : 0) + (neg[i] ? 1 : 0);
+    }
+}
+
+struct Vec3Hash {
+    size_t operator()(const glm::vec3& p) const noexcept {
+        return std::hash<float>()(p.x) ^ (std::hash<float>()(p.y) << 1) ^ (std::hash<float>()(p.z) << 2);
+    }
+};
+
+static MeshInspection inspect_uncached(const MeshData& mesh)
+{
+    MeshInspection r;
+    r.vertices = mesh.positions.size();
+    r.triangles = mesh.indices.size() / 3;
+    r.boundaryEdges = mesh.topologyReport.boundaryEdges;
+    r.nonManifoldEdges = mesh.topologyReport.nonManifoldEdges;
+    r.components = mesh.topologyReport.components;
+    r.closedComponents = mesh.orientReport.closedComponents;
+    r.degenerateRemoved = mesh.cleanupReport.degenerateTriangles;
+    if (r.triangles == 0) return r;
+
+    std::vector<unsigned char> cullable(r.triangles, 0);
+    for (const MaterialBatch& b : mesh.batches) {
+        if (!b.cullBackfaces) continue;
+        for (size_t t = b.firstIndex / 3; t < (b.firstIndex + b.indexCount) / 3 && t < r.triangles; ++t) cullable[t] = 1;
+    }
+
+    // 0-2: cache simulations, 3-5: overdraw axes, 6: geometry
+    size_t misses[3] = {};
+    uint64_t fragments[3] = {}, covered[3] = {};
+    globalThreadPool().parallel_for(0, 7, 1, [&](size_t jb, size_t je) {
+        for (size_t job = jb; job < je; ++job) {
+            if (job < 3) {
+                misses[job] = fifo_cache_misses(mesh.indices, mesh.positions.size(), kInspectCacheSizes[job]);
+            } else if (job < 6) {
+                axis_overdraw(mesh, cullable, int(job - 3), fragments[job - 3], covered[job - 3]);
+            } else {
+                std::unordered_set<glm::vec3, Vec3Hash> unique(mesh.positions.begin(), mesh.positions.end());
+                r.uniquePositions = unique.size();
+                r.boundsMin = glm::vec3(1e30f);
+                r.boundsMax = glm::vec3(-1e30f);
+                for (const glm::vec3& p : mesh.positions) {
+                    r.boundsMin = glm::min(r.boundsMin, p);
+                    r.boundsMax = glm::max(r.boundsMax, p);
+                }
+                double area = 0.0, volume = 0.0;
+                for (size_t t = 0; t < r.triangles; ++t) {
+                    const glm::dvec3 p0(mesh.positions[mesh.indices[3 * t]]);
+                    const glm::dvec3 p1(mesh.positions[mesh.indices[3 * t + 1]]);
+                    const glm::dvec3 p2(mesh.positions[mesh.indices[3 * t + 2]]);
+                    const double a = 0.5 * glm::length(glm::cross(p1 - p0, p2 - p0));
+                    if (a == 0.0) ++r.zeroAreaTriangles;
+                    area += a;
+                    volume += glm::dot(p0, glm::cross(p1, p2)) / 6.0;
+                }
+                r.surfaceArea = area;
+                r.volume = volume;
+            }
+        }
+    });
+
+    r.splitRatio = r.uniquePositions ? double(r.vertices) / double(r.uniquePositions) : 0.0;
+    for (int i = 0; i < 3; ++i) {
+        r.acmr[i] = double(misses[i]) / double(r.triangles);
+        r.atvr[i] = r.vertices ? double(misses[i]) / double(r.vertices) : 0.0;
+    }
+    const uint64_t allCovered = covered[0] + covered[1] + covered[2];
+    r.overdraw = allCovered ? double(fragments[0] + fragments[1] + fragments[2]) / double(allCovered) : 0.0;
+    return r;
+}
+
+MeshInspection inspect_mesh(const MeshData& mesh)
+{
+    static std::mutex cacheMutex;
+    static std::unordered_map<uint64_t, MeshInspection> cache;
+
+    const uint64_t key = mesh_content_hash(mesh);
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            MeshInspection hit = it->second;
+            hit.seconds = 0.0;
+            return hit;
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    MeshInspection r = inspect_uncached(mesh);
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (cache.size() >= kCacheEntries) cache.clear();
+    cache[key] = r;
+    return r;
+}
+
+std::string mesh_inspection_csv_header()
+{
+    std::ostringstream s;
+    s << "vertices,triangles,unique_positions,split_ratio";
+    for (unsigned int size : kInspectCacheSizes) s << ",acmr_" << size;
+    for (unsigned int size : kInspectCacheSizes) s << ",atvr_" << size;
+    s << ",overdraw,manifold,closed,components,closed_components,boundary_edges,non_manifold_edges"
+      << ",degenerate_removed,zero_area_triangles,min_x,min_y,min_z,max_x,max_y,max_z,surface_area,volume";
+    return s.str();
+}
+
+std::string mesh_inspection_csv_row(const MeshInspection& r)
+{
+    std::ostringstream s;
+    s << r.vertices << "," << r.triangles << "," << r.uniquePositions << "," << std::fixed << std::setprecision(3) << r.splitRatio;
+    for (double v : r.acmr) s << "," << v;
+    for (double v : r.atvr) s << "," << v;
+    s << "," << r.overdraw << "," << (r.manifold() ? 1 : 0) << "," << (r.closed() ? 1 : 0)
+      << "," << r.components << "," << r.closedComponents << "," << r.boundaryEdges << "," << r.nonManifoldEdges
+      << "," << r.degenerateRemoved << "," << r.zeroAreaTriangles;
+    s << std::defaultfloat << std::setprecision(7);
+    for (int i = 0; i < 3; ++i) s << "," << r.boundsMin[i];
+    for (int i = 0; i < 3; ++i) s << "," << r.boundsMax[i];
+    s << "," << r.surfaceArea << "," << r.volume;
+    return s.str();
+}
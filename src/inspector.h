@@ -0,0 +1,47 @@
+#pragma once
+
+// inspector.h
+// Mesh efficiency metrics, to find the assets worth optimizing (UI panel and --inspect report).
+
+#include <cstddef>
+#include <string>
+#include <glm/vec3.hpp>
+
+#include "loader.h"
+
+// FIFO post-transform cache sizes the ACMR/ATVR figures are simulated for
+constexpr unsigned int kInspectCacheSizes[3] = { 16, 24, 32 };
+
+struct MeshInspection {
+    size_t vertices = 0;
+    size_t triangles = 0;
+    size_t uniquePositions = 0;
+    double splitRatio = 0.0;        // vertices per unique position (normal/uv seams of the vertex dedup)
+    double acmr[3] = {};            // cache misses per triangle, 0.5 is ideal for big grids, 3 is no reuse
+    double atvr[3] = {};            // cache misses per vertex, 1 is ideal
+    double overdraw = 0.0;          // fragments per covered pixel, six axis views, see inspect_mesh
+    size_t boundaryEdges = 0;       // topology from the load
+    size_t nonManifoldEdges = 0;
+    size_t components = 0;
+    size_t closedComponents = 0;
+    size_t degenerateRemoved = 0;   // dropped by the loader's cleanup pass
+    size_t zeroAreaTriangles = 0;   // left in the mesh (distinct but collinear corners)
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+    double surfaceArea = 0.0;
+    double volume = 0.0;            // signed (divergence theorem), only meaningful for closed meshes
+    double seconds = 0.0;           // time the metrics took, 0 on a cache hit
+
+    bool manifold() const { return nonManifoldEdges == 0; }
+    bool closed() const { return manifold() && boundaryEdges == 0 && triangles > 0; }
+};
+
+// Metrics run as parallel jobs on globalThreadPool (safe to call from a worker). Overdraw
+// rasterizes the mesh from the six axis directions at 256x256, culling back faces of the batches
+// the renderer culls, and divides all fragments by all covered pixels. Results are cached by mesh
+// content (indices and positions), inspecting the same mesh again is a lookup.
+MeshInspection inspect_mesh(const MeshData& mesh);
+
+// CSV columns after the caller's own (no trailing newline)
+std::string mesh_inspection_csv_header();
+std::string mesh_inspection_csv_row(const MeshInspection& r);
@@ -10,34 +10,68 @@
 #include <sstream>
 #include <unordered_map>
 #include <algorithm>
-#include <future>
+#include <thread>
 #include <memory>
 #include <atomic>
 #include <filesystem>
 #include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <limits>
 
 #include <glm/glm.hpp>
 
+#include "threadpool.h"
+#include "texturecache.h"
+#include "halfedge.h"
+#include "geomkernels.h"
+#include "scratchpool.h"
+
 #ifdef USE_ASSIMP
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #endif
 
-Loader::Loader()
+void MeshData::clear()
 {
-    positions_ptr = std::make_shared<std::vector<glm::vec3>>();
-    normals_ptr = std::make_shared<std::vector<glm::vec3>>();
-    indices_ptr = std::make_shared<std::vector<unsigned int>>();
-    modelReady.store(false);
-    modelLoadFailed.store(false);
-    loadProgress.store(0.0f);
+    positions.clear();
+    normals.clear();
+    texcoords.clear();
+    indices.clear();
+    materials.clear();
+    batches.clear();
+    textures.clear();
+    flatShaded = false;
+    atlasReport = AtlasReport{};
+    cacheReport = TextureCacheReport{};
+    flatReport = FlatShadingReport{};
+    cleanupReport = CleanupReport{};
+    orientReport = OrientationReport{};
+    weldReport = WeldReport{};
+    edgeLines.clear();
+    silhouetteEdges.clear();
+    points.clear();
+    featureLineCount = 0;
+    topologyReport = TopologyReport{};
+    timings = LoadTimings{};
 }
 
+Loader::Loader(MainExecutor& main) : main_(main) {}
+
 Loader::~Loader()
 {
-    if (initialLoader.valid()) initialLoader.wait();
-    if (importLoaderFuture.valid()) importLoaderFuture.wait();
+    // pipelines only finish on the main executor, so keep draining it until they are all back
+    for (auto& job : jobs_) job->cancel.cancel();
+    while (!jobs_.empty()) {
+        if (main_.run(1000.0) == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+static void mark_stage(const LoadOptions& options, const char* stage)
+{
+    if (options.onStage) options.onStage(stage);
 }
 
 static std::string extlower(const std::string& p) {
@@ -46,75 +80,1076 @@ static std::string extlower(const std::string& p) {
     return s;
 }
 
-// Forward to internal OBJ parser used below
+// ---- OBJ line parsing ----
+// Character scanning and std::from_chars instead of a stream per line; fan triangulation writes
+// straight into the index arrays.
+
+struct ObjFaceSink {
+    ScratchVector<unsigned int>* pos_idx;
+    ScratchVector<unsigned int>* uv_idx;
+    ScratchVector<unsigned int>* norm_idx;
+    ScratchVector<unsigned int>* triMaterial;
+    const ScratchVector<glm::vec3>* temp_pos;
+    const ScratchVector<glm::vec2>* temp_uv;
+    const ScratchVector<glm::vec3>* temp_norm;
+    unsigned int material = 0;
+};
+
+static inline bool is_blank(char c) { return c == ' ' || c == '\t'; }
+static inline bool is_line_end(char c) { return c == '\0' || c == '\r' || c == '\n' || c == '#'; }
+static inline bool is_corner_end(char c) { return is_line_end(c) || is_blank(c); }
+
+static inline const char* skip_blanks(const char* s) {
+    while (is_blank(*s)) ++s;
+    return s;
+}
+
+// signed decimal int; nullptr when there are no digits. Out of range gives 0, which
+// convert_obj_index turns into an invalid reference
+static inline const char* parse_int(const char* s, const char* end, int& out) {
+    if (*s == '+' && s[1] != '-') ++s;
+    const std::from_chars_result r = std::from_chars(s, end, out);
+    if (r.ec == std::errc::invalid_argument) return nullptr;
+    if (r.ec == std::errc::result_out_of_range) out = 0;
+    return r.ptr;
+}
+
+// up to `count` floats of a v/vt/vn line; components that are missing or malformed stay as they are
+static inline void parse_floats(const char* s, const char* end, float* out, int count) {
+    for (int i = 0; i < count; ++i) {
+        s = skip_blanks(s);
+        if (*s == '+') ++s;
+        const std::from_chars_result r = std::from_chars(s, end, out[i]);
+        if (r.ec != std::errc()) return;
+        s = r.ptr;
+    }
+}
+
+// 1-based / negative-relative OBJ index to 0-based, -1 for 0
+static inline int convert_obj_index(int idx, size_t array_size) {
+    if (idx > 0) return idx - 1;
+    if (idx < 0) return (int)array_size + idx;
+    return -1;
+}
+
+struct ObjCorner { int v = 0, t = 0, n = 0; };
+
+static inline void push_obj_triangle(ObjFaceSink& sink, const ObjCorner& a, const ObjCorner& b, const ObjCorner& c) {
+    for (const ObjCorner* k : { &a, &b, &c }) {
+        const int p = convert_obj_index(k->v, sink.temp_pos->size());
+        const int t = convert_obj_index(k->t, sink.temp_uv->size());
+        const int n = convert_obj_index(k->n, sink.temp_norm->size());
+        // invalid position refs stay -1; the triangle is dropped after parsing
+        sink.pos_idx->push_back((unsigned int)p);
+        sink.uv_idx->push_back((unsigned int)t);
+        sink.norm_idx->push_back((n >= 0) ? (unsigned int)n : 0u);
+    }
+    sink.triMaterial->push_back(sink.material);
+}
+
+// s points past the "f"; any mix of layouts per corner, malformed corners are skipped
+static void parse_face(const char* s, const char* end, ObjFaceSink& sink) {
+    ObjCorner c0, c1, c;
+    int count = 0;
+    while (true) {
+        s = skip_blanks(s);
+        if (is_line_end(*s)) break;
+        c = ObjCorner{};
+        const char* e = parse_int(s, end, c.v);
+        if (!e) {
+            while (!is_corner_end(*s)) ++s;
+            continue;
+        }
+        if (*e == '/') {
+            if (e[1] == '/') {
+                const char* en = parse_int(e + 2, end, c.n);
+                e = en ? en : e + 2;
+            } else {
+                const char* et = parse_int(e + 1, end, c.t);
+                e = et ? et : e + 1;
+                if (*e == '/') {
+                    const char* en = parse_int(e + 1, end, c.n);
+                    e = en ? en : e + 1;
+                }
+            }
+        }
+        s = e;
+        while (!is_corner_end(*s)) ++s;
+
+        if (count == 0) c0 = c;
+        else if (count >= 2) push_obj_triangle(sink, c0, c1, c);
+        c1 = c;
+        ++count;
+    }
+}
+
 static bool load_obj_simple_internal(const std::string& path,
-                        std::vector<glm::vec3>& out_positions,
-                        std::vector<glm::vec3>& out_normals,
-                        std::vector<unsigned int>& out_indices,
-                        std::atomic<float>* progress);
-
-void Loader::startInitialLoad(const std::string& model_path) {
-    positions_ptr = std::make_shared<std::vector<glm::vec3>>();
-    normals_ptr = std::make_shared<std::vector<glm::vec3>>();
-    indices_ptr = std::make_shared<std::vector<unsigned int>>();
-    modelLoadFailed.store(false);
-    modelReady.store(false);
-    loadProgress.store(0.0f);
-
-    initialLoader = std::async(std::launch::async,
-        [this, model_path]() {
-            bool ok = Loader::load_model_simple(model_path, *positions_ptr, *normals_ptr, *indices_ptr, &loadProgress);
-            if (!ok) modelLoadFailed.store(true);
-            else modelReady.store(true);
+                        MeshData& out,
+                        std::atomic<float>* progress,
+                        const LoadOptions& options);
+
+static void post_process_mesh(MeshData& out, const LoadOptions& options);
+
+uint64_t Loader::request(const std::string& path, const LoadOptions& options) {
+    for (auto& old : jobs_) old->cancel.cancel(); // superseded
+    jobs_.push_back(std::make_unique<Job>());
+    Job* job = jobs_.back().get();
+    job->ticket = ++latestTicket_;
+    main_.spawn(pipeline(job, path, options));
+    return job->ticket;
+}
+
+Task<std::unique_ptr<MeshData>> Loader::load(std::string path, LoadOptions options,
+                                             std::atomic<float>* progress, CancelToken cancel)
+{
+    co_await resume_on(globalThreadPool());
+    auto mesh = std::make_unique<MeshData>();
+    bool ok = false;
+    std::exception_ptr error;
+    if (!cancel.cancelled()) {
+        try {
+            ok = Loader::load_model(path, *mesh, progress, options);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+
+    // errors and cancellation surface on the main thread, like results
+    co_await main_.schedule();
+    cancel.check();
+    if (error) std::rethrow_exception(error);
+    if (!ok) throw LoadError(path);
+    co_return mesh;
+}
+
+Task<void> Loader::pipeline(Job* job, std::string path, LoadOptions options) {
+    LoadResult result;
+    result.ticket = job->ticket;
+    result.path = path;
+    bool cancelled = false;
+    try {
+        result.mesh = co_await load(path, options, &job->progress, job->cancel);
+        result.ok = true;
+    } catch (const TaskCancelled&) {
+        cancelled = true;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+    }
+
+    // load() always finishes on the main thread, so jobs_ is ours again
+    jobs_.erase(std::find_if(jobs_.begin(), jobs_.end(), [&](const std::unique_ptr<Job>& j) { return j.get() == job; }));
+    if (cancelled || result.ticket != latestTicket_ || !handle_) co_return;
+    handle_(result);
+}
+
+float Loader::progress() const {
+    for (const auto& job : jobs_) {
+        if (job->ticket == latestTicket_) return job->progress.load(std::memory_order_relaxed);
+    }
+    return 1.0f;
+}
+
+void Loader::prefetch(const std::string& path) {
+    globalThreadPool().post([path]() {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> buf(size_t(1) << 20);
+        while (in.read(buf.data(), (std::streamsize)buf.size()) || in.gcount() > 0) {}
+    });
+}
+
+// ---- materials ------------------------------------------------------------
+
+static std::string trim(const std::string& s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos) return std::string();
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+// texture references may carry options ("-s 1 1 1 tex.png") and windows separators
+static std::string resolve_texture_path(const std::filesystem::path& baseDir, std::string ref) {
+    ref = trim(ref);
+    size_t lastSpace = ref.find_last_of(" \t");
+    if (!ref.empty() && ref[0] == '-' && lastSpace != std::string::npos) ref = ref.substr(lastSpace + 1);
+    std::replace(ref.begin(), ref.end(), '\\', '/');
+    if (ref.empty()) return std::string();
+    std::filesystem::path p(ref);
+    if (p.is_relative()) p = baseDir / p;
+    return p.lexically_normal().string();
+}
+
+static bool parse_mtl_file(const std::string& mtlPath,
+                           std::vector<Material>& materials,
+                           std::unordered_map<std::string, unsigned int>& byName)
+{
+    std::ifstream in(mtlPath);
+    if (!in) {
+        std::cerr << "failed to open MTL: " << mtlPath << "\n";
+        return false;
+    }
+    const std::filesystem::path baseDir = std::filesystem::path(mtlPath).parent_path();
+
+    Material* cur = nullptr;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream ss(line);
+        std::string tag; ss >> tag;
+        if (tag == "newmtl") {
+            std::string name; std::getline(ss, name);
+            name = trim(name);
+            auto it = byName.find(name);
+            if (it == byName.end()) {
+                it = byName.emplace(name, (unsigned int)materials.size()).first;
+                materials.push_back(Material{});
+                materials.back().name = name;
+            }
+            cur = &materials[it->second];
+        } else if (!cur) {
+            continue;
+        } else if (tag == "Kd") {
+            ss >> cur->diffuse.x >> cur->diffuse.y >> cur->diffuse.z;
+        } else if (tag == "d") {
+            ss >> cur->opacity;
+        } else if (tag == "Tr") {
+            float tr = 0.0f; ss >> tr;
+            cur->opacity = 1.0f - tr;
+        } else if (tag == "map_Kd") {
+            std::string ref; std::getline(ss, ref);
+            cur->diffuseMap = resolve_texture_path(baseDir, ref);
+        }
+    }
+    return true;
+}
+
+// counting sort of triangles by material so every material is a single index range
+static void sort_triangles_by_material(MeshData& out, const ScratchVector<unsigned int>& triMaterial)
+{
+    const size_t triCount = out.indices.size() / 3;
+    const size_t matCount = out.materials.size();
+
+    std::vector<unsigned int> offsets(matCount + 1, 0);
+    for (size_t t = 0; t < triCount; ++t) offsets[triMaterial[t] + 1]++;
+    for (size_t m = 0; m < matCount; ++m) offsets[m + 1] += offsets[m];
+
+    out.batches.clear();
+    for (size_t m = 0; m < matCount; ++m) {
+        unsigned int n = offsets[m + 1] - offsets[m];
+        if (n == 0) continue;
+        out.batches.push_back(MaterialBatch{ (unsigned int)m, offsets[m] * 3u, n * 3u });
+    }
+    if (out.batches.size() <= 1) return;
+
+    ScratchVector<unsigned int> sorted(out.indices.size());
+    std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triCount; ++t) {
+        unsigned int dst = cursor[triMaterial[t]]++;
+        sorted[dst * 3 + 0] = out.indices[t * 3 + 0];
+        sorted[dst * 3 + 1] = out.indices[t * 3 + 1];
+        sorted[dst * 3 + 2] = out.indices[t * 3 + 2];
+    }
+    std::copy(sorted.begin(), sorted.end(), out.indices.begin());
+}
+
+// decode every distinct diffuse map on the pool (mips included) and link materials to them.
+// With a cache dir, textures come from the BC cache when present; misses are decoded as usual
+// and queued for background compression. Atlas candidates stay RGBA so they can still be packed.
+static void load_material_textures(MeshData& out, const LoadOptions& options)
+{
+    mark_stage(options, "textures");
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::string> paths;
+    std::unordered_map<std::string, int> slot;
+    for (auto& m : out.materials) {
+        m.textureIndex = -1;
+        if (m.diffuseMap.empty()) continue;
+        auto it = slot.find(m.diffuseMap);
+        if (it == slot.end()) {
+            it = slot.emplace(m.diffuseMap, (int)paths.size()).first;
+            paths.push_back(m.diffuseMap);
+        }
+        m.textureIndex = it->second;
+    }
+    if (paths.empty()) return;
+
+    std::vector<TextureImage> decoded(paths.size());
+    std::vector<char> ok(paths.size(), 0);
+    std::atomic<unsigned int> hits{0}, queued{0};
+    globalThreadPool().parallel_for(0, paths.size(), 1, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            uint64_t hash = 0;
+            bool cacheable = !options.textureCacheDir.empty();
+            if (cacheable && options.atlasSmallTextures) {
+                int w = 0, h = 0;
+                if (decode_texture_info(paths[i], w, h) && w <= options.atlasMaxTextureSize && h <= options.atlasMaxTextureSize) cacheable = false;
+            }
+            if (cacheable) cacheable = hash_file_contents(paths[i], hash);
+            if (cacheable && texture_cache_load(options.textureCacheDir, hash, decoded[i])) {
+                decoded[i].path = paths[i];
+                ok[i] = 1;
+                hits++;
+                continue;
+            }
+            ok[i] = decode_texture_rgba(paths[i], decoded[i]) ? 1 : 0;
+            if (ok[i] && cacheable) {
+                texture_cache_store_async(options.textureCacheDir, hash, decoded[i]);
+                queued++;
+            }
+        }
+    });
+    out.cacheReport.hits = hits.load();
+    out.cacheReport.queued = queued.load();
+
+    // drop failed decodes and compact the indices
+    std::vector<int> remap(paths.size(), -1);
+    out.textures.clear();
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (!ok[i]) continue;
+        remap[i] = (int)out.textures.size();
+        out.textures.push_back(std::move(decoded[i]));
+    }
+    for (auto& m : out.materials) {
+        if (m.textureIndex >= 0) m.textureIndex = remap[m.textureIndex];
+    }
+    out.timings.textureSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+unsigned int count_texture_binds(const MeshData& mesh)
+{
+    unsigned int binds = 0;
+    int bound = -1;
+    for (const MaterialBatch& b : mesh.batches) {
+        int tex = (b.materialIndex < mesh.materials.size()) ? mesh.materials[b.materialIndex].textureIndex : -1;
+        if (tex >= 0 && tex != bound) ++binds;
+        bound = tex;
+    }
+    return binds;
+}
+
+// Pack small textures into atlas pages and fold their materials into one material per page.
+// Only opaque materials whose UVs stay inside [0,1] qualify (tiling needs GL_REPEAT on the
+// original texture). Kd is baked into the atlas texels, so merged batches stay lossless.
+static void build_material_atlas(MeshData& out, const LoadOptions& options)
+{
+    AtlasReport& report = out.atlasReport;
+    report = AtlasReport{};
+    report.batchesBefore = report.batchesAfter = (unsigned int)out.batches.size();
+    report.bindsBefore = report.bindsAfter = count_texture_binds(out);
+    if (!options.atlasSmallTextures || out.textures.empty()) return;
+
+    const float uvEps = 1e-4f;
+    std::vector<int> request(out.materials.size(), -1); // material -> atlas request
+    std::vector<AtlasRequest> requests;
+    std::vector<unsigned int> requestMaterial;
+    for (const MaterialBatch& b : out.batches) {
+        const Material& m = out.materials[b.materialIndex];
+        if (m.textureIndex < 0 || m.opacity < 1.0f) continue;
+        const TextureImage& img = out.textures[m.textureIndex];
+        if (img.format != TextureFormat::RGBA8) continue;
+        if (img.width > options.atlasMaxTextureSize || img.height > options.atlasMaxTextureSize) continue;
+
+        bool inside = true;
+        for (unsigned int i = b.firstIndex; i < b.firstIndex + b.indexCount && inside; ++i) {
+            const glm::vec2& t = out.texcoords[out.indices[i]];
+            inside = t.x >= -uvEps && t.x <= 1.0f + uvEps && t.y >= -uvEps && t.y <= 1.0f + uvEps;
+        }
+        if (!inside) continue;
+
+        AtlasRequest r;
+        r.image = m.textureIndex;
+        r.tint[0] = m.diffuse.x; r.tint[1] = m.diffuse.y; r.tint[2] = m.diffuse.z;
+        request[b.materialIndex] = (int)requests.size();
+        requests.push_back(r);
+        requestMaterial.push_back(b.materialIndex);
+    }
+    if (requests.size() < 2) return; // nothing to merge
+
+    std::vector<TextureImage> pages;
+    std::vector<AtlasPlacement> placements;
+    pack_texture_atlas(out.textures, requests, options.atlasPageSize, options.atlasGutter, pages, placements);
+    if (pages.empty()) return;
+
+    // one material per page, textures appended after the existing ones
+    const unsigned int firstPageMaterial = (unsigned int)out.materials.size();
+    const int firstPageTexture = (int)out.textures.size();
+    for (size_t p = 0; p < pages.size(); ++p) {
+        Material m;
+        m.name = "atlas_" + std::to_string(p);
+        m.diffuse = glm::vec3(1.0f);
+        m.diffuseMap = pages[p].path;
+        m.textureIndex = firstPageTexture + (int)p;
+        out.materials.push_back(std::move(m));
+    }
+
+    // remap UVs. Vertices shared with another material (atlased differently or not at all) are cloned.
+    const unsigned int unowned = 0xFFFFFFFFu, shared = 0xFFFFFFFEu;
+    ScratchVector<unsigned int> owner(out.positions.size(), unowned);
+    ScratchVector<unsigned int> triMaterial(out.indices.size() / 3, 0);
+    for (const MaterialBatch& b : out.batches) {
+        int r = request[b.materialIndex];
+        bool placed = r >= 0 && placements[r].page >= 0;
+        for (unsigned int i = b.firstIndex; i < b.firstIndex + b.indexCount; ++i) {
+            triMaterial[i / 3] = placed ? firstPageMaterial + (unsigned int)placements[r].page : b.materialIndex;
+            if (!placed) owner[out.indices[i]] = shared;
+        }
+    }
+
+    struct CloneKey { unsigned int v, r; bool operator==(CloneKey const& o) const { return v == o.v && r == o.r; } };
+    struct CloneHash { size_t operator()(CloneKey const& k) const noexcept { return (size_t)k.v * 1000003u + k.r; } };
+    std::unordered_map<CloneKey, unsigned int, CloneHash> clones;
+
+    auto remapUV = [&](glm::vec2 t, const AtlasPlacement& pl, const TextureImage& page) {
+        t = glm::clamp(t, 0.0f, 1.0f);
+        return glm::vec2((pl.x + t.x * pl.width) / float(page.width),
+                         (pl.y + t.y * pl.height) / float(page.height));
+    };
+
+    for (const MaterialBatch& b : out.batches) {
+        int r = request[b.materialIndex];
+        if (r < 0 || placements[r].page < 0) continue;
+        const AtlasPlacement& pl = placements[r];
+        const TextureImage& page = pages[pl.page];
+        report.texturesPacked++;
+        for (unsigned int i = b.firstIndex; i < b.firstIndex + b.indexCount; ++i) {
+            unsigned int v = out.indices[i];
+            if (owner[v] == unowned) {
+                owner[v] = (unsigned int)r;
+                out.texcoords[v] = remapUV(out.texcoords[v], pl, page);
+            } else if (owner[v] != (unsigned int)r) {
+                auto it = clones.find(CloneKey{ v, (unsigned int)r });
+                if (it == clones.end()) {
+                    // owner[v] may already hold a remapped uv; the clone starts from the original
+                    // texcoord, which is only intact when v is shared with an unatlased material
+                    unsigned int nv = (unsigned int)out.positions.size();
+                    glm::vec2 src = out.texcoords[v];
+                    if (owner[v] != shared) {
+                        const AtlasPlacement& op = placements[owner[v]];
+                        const TextureImage& opage = pages[op.page];
+                        src = glm::vec2((src.x * opage.width - op.x) / float(op.width),
+                                        (src.y * opage.height - op.y) / float(op.height));
+                    }
+                    out.positions.push_back(out.positions[v]);
+                    out.normals.push_back(out.normals[v]);
+                    out.texcoords.push_back(remapUV(src, pl, page));
+                    owner.push_back((unsigned int)r);
+                    it = clones.emplace(CloneKey{ v, (unsigned int)r }, nv).first;
+                }
+                out.indices[i] = it->second;
+            }
+        }
+    }
+
+    for (auto& p : pages) out.textures.push_back(std::move(p));
+    report.pages = (unsigned int)pages.size();
+    sort_triangles_by_material(out, triMaterial);
+
+    // drop source textures nothing references any more
+    std::vector<char> used(out.textures.size(), 0);
+    for (const MaterialBatch& b : out.batches) {
+        int t = out.materials[b.materialIndex].textureIndex;
+        if (t >= 0) used[t] = 1;
+    }
+    std::vector<int> remap(out.textures.size(), -1);
+    std::vector<TextureImage> kept;
+    for (size_t t = 0; t < out.textures.size(); ++t) {
+        if (!used[t]) continue;
+        remap[t] = (int)kept.size();
+        kept.push_back(std::move(out.textures[t]));
+    }
+    out.textures.swap(kept);
+    for (auto& m : out.materials) {
+        if (m.textureIndex >= 0) m.textureIndex = remap[m.textureIndex];
+    }
+
+    report.built = true;
+    report.batchesAfter = (unsigned int)out.batches.size();
+    report.bindsAfter = count_texture_binds(out);
+}
+
+// True when every corner normal equals its triangle's geometric normal on the side of its winding,
+// i.e. the mesh is already faceted and the shader's winding-side face normals reproduce it exactly.
+// A normal opposite its winding lights the other side, which the derived normal cannot follow.
+static bool normals_are_per_face(const MeshData& out)
+{
+    const size_t triCount = out.indices.size() / 3;
+    std::atomic<bool> perFace{true};
+    globalThreadPool().parallel_for(0, triCount, 4096, [&](size_t b, size_t e) {
+        for (size_t t = b; t < e && perFace.load(std::memory_order_relaxed); ++t) {
+            const unsigned int i0 = out.indices[t * 3 + 0], i1 = out.indices[t * 3 + 1], i2 = out.indices[t * 3 + 2];
+            glm::vec3 fn = glm::cross(out.positions[i1] - out.positions[i0], out.positions[i2] - out.positions[i0]);
+            float len = glm::length(fn);
+            if (len < 1e-12f) continue; // degenerate, no opinion
+            fn /= len;
+            for (unsigned int v : { i0, i1, i2 }) {
+                const glm::vec3& n = out.normals[v];
+                float nl = glm::length(n);
+                if (nl < 1e-6f || glm::dot(n, fn) < 0.9995f * nl) { perFace.store(false); break; }
+            }
+        }
+    });
+    return perFace.load();
+}
+
+// re-dedup on (position, texcoord) and drop normals
+static void apply_flat_shading(MeshData& out, const LoadOptions& options)
+{
+    FlatShadingReport& report = out.flatReport;
+    report = FlatShadingReport{};
+    report.verticesBefore = report.verticesAfter = out.positions.size();
+    if (options.flatShading == FlatShading::Off || out.indices.empty()) return;
+
+    report.lossless = normals_are_per_face(out);
+    if (options.flatShading == FlatShading::Auto && !report.lossless) return;
+
+    struct Key { glm::vec3 p; glm::vec2 t; bool operator==(Key const& o) const { return p == o.p && t == o.t; } };
+    struct KeyHash { size_t operator()(Key const& k) const noexcept {
+        size_t h1 = std::hash<float>()(k.p.x) ^ (std::hash<float>()(k.p.y) << 1) ^ (std::hash<float>()(k.p.z) << 2);
+        size_t h2 = std::hash<float>()(k.t.x) ^ (std::hash<float>()(k.t.y) << 1);
+        return h1 ^ (h2 << 3);
+    } };
+    std::unordered_map<Key, unsigned int, KeyHash> map;
+    map.reserve(out.positions.size());
+
+    ScratchVector<unsigned int> remap(out.positions.size());
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> texcoords;
+    positions.reserve(out.positions.size());
+    texcoords.reserve(out.positions.size());
+    for (size_t v = 0; v < out.positions.size(); ++v) {
+        Key key{ out.positions[v], out.texcoords[v] };
+        auto it = map.find(key);
+        if (it == map.end()) {
+            it = map.emplace(key, (unsigned int)positions.size()).first;
+            positions.push_back(key.p);
+            texcoords.push_back(key.t);
+        }
+        remap[v] = it->second;
+    }
+    for (auto& i : out.indices) i = remap[i];
+
+    out.positions.swap(positions);
+    out.texcoords.swap(texcoords);
+    out.normals.clear();
+    out.normals.shrink_to_fit();
+    out.flatShaded = true;
+
+    report.applied = true;
+    report.verticesAfter = out.positions.size();
+}
+
+// Merge positions closer than options.weldTolerance, then dedup vertices again on (position, uv,
+// normal). Positions are bucketed into tolerance-sized cells; each vertex searches the 27 cells
+// around it in parallel for the lowest-numbered neighbour in range, and chains resolve to that
+// neighbour's root, so every cluster snaps to its first vertex. Normals within kWeldSmoothCos of
+// each other are averaged across a cluster that moved, so seam vertices dedup into one; harder
+// edges keep their normals.
+static const float kWeldSmoothCos = 0.8660254f; // 30 degrees
+
+static void weld_vertices(MeshData& out, const LoadOptions& options)
+{
+    WeldReport& report = out.weldReport;
+    report = WeldReport{};
+    report.verticesBefore = report.verticesAfter = out.positions.size();
+    const float tol = options.weldTolerance;
+    if (!(tol > 0.0f) || out.positions.empty()) return;
+
+    const size_t n = out.positions.size();
+    // cells count from the lower corner of the finite bounds, 64-bit. Cells grow past the tolerance
+    // where the bounds span more than 2^40 of them (mm coordinates with a tiny tolerance), so the
+    // neighbour lookups never overflow; the distance test below still uses the tolerance.
+    glm::vec3 lo(std::numeric_limits<float>::max()), hi(-std::numeric_limits<float>::max());
+    for (const glm::vec3& p : out.positions) {
+        if (!std::isfinite(p.x) || !std::isfinite(p.y) || !std::isfinite(p.z)) continue;
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+    if (lo.x > hi.x) lo = hi = glm::vec3(0.0f);
+    const double kMaxCells = double(int64_t(1) << 40);
+    const double extent = std::max({ double(hi.x) - lo.x, double(hi.y) - lo.y, double(hi.z) - lo.z });
+    const double cellSize = std::max(double(tol), extent / kMaxCells);
+    struct Cell { int64_t x, y, z; bool operator==(Cell const& o) const { return x == o.x && y == o.y && z == o.z; } };
+    struct CellHash { size_t operator()(Cell const& c) const noexcept {
+        return ((size_t)c.x * 73856093u) ^ ((size_t)c.y * 19349663u) ^ ((size_t)c.z * 83492791u);
+    } };
+    auto axisCell = [&](float v, float origin) {
+        const double c = std::floor((double(v) - origin) / cellSize);
+        return !(c >= 0.0) ? int64_t(0) : c > kMaxCells ? int64_t(kMaxCells) : int64_t(c); // NaN and inf clamp
+    };
+    auto cellOf = [&](const glm::vec3& p) {
+        return Cell{ axisCell(p.x, lo.x), axisCell(p.y, lo.y), axisCell(p.z, lo.z) };
+    };
+
+    // vertices grouped by cell: sorted order plus cell -> [begin, end)
+    std::vector<Cell> cells(n);
+    ScratchVector<unsigned int> order(n);
+    globalThreadPool().parallel_for(0, n, 16384, [&](size_t b, size_t e) {
+        for (size_t v = b; v < e; ++v) { cells[v] = cellOf(out.positions[v]); order[v] = (unsigned int)v; }
+    });
+    std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+        const Cell& ca = cells[a];
+        const Cell& cb = cells[b];
+        if (ca.x != cb.x) return ca.x < cb.x;
+        if (ca.y != cb.y) return ca.y < cb.y;
+        if (ca.z != cb.z) return ca.z < cb.z;
+        return a < b;
+    });
+    std::unordered_map<Cell, std::pair<unsigned int, unsigned int>, CellHash> grid;
+    grid.reserve(n);
+    for (size_t i = 0; i < n;) {
+        size_t j = i + 1;
+        while (j < n && cells[order[j]] == cells[order[i]]) ++j;
+        grid.emplace(cells[order[i]], std::make_pair((unsigned int)i, (unsigned int)j));
+        i = j;
+    }
+
+    // lowest vertex id within tolerance (itself when alone)
+    const float tol2 = tol * tol;
+    ScratchVector<unsigned int> rep(n);
+    globalThreadPool().parallel_for(0, n, 4096, [&](size_t b, size_t e) {
+        for (size_t v = b; v < e; ++v) {
+            const glm::vec3 p = out.positions[v];
+            const Cell c = cells[v];
+            unsigned int best = (unsigned int)v;
+            for (int dz = -1; dz <= 1; ++dz)
+            for (int dy = -1; dy <= 1; ++dy)
+            for (int dx = -1; dx <= 1; ++dx) {
+                auto it = grid.find(Cell{ c.x + dx, c.y + dy, c.z + dz });
+                if (it == grid.end()) continue;
+                // ids inside a cell are ascending, stop once they pass the current best
+                for (unsigned int k = it->second.first; k < it->second.second && order[k] < best; ++k) {
+                    glm::vec3 d = out.positions[order[k]] - p;
+                    if (glm::dot(d, d) <= tol2) best = order[k];
+                }
+            }
+            rep[v] = best;
+        }
+    });
+    std::vector<uint8_t> moved(n, 0); // per cluster root
+    for (size_t v = 0; v < n; ++v) {
+        rep[v] = rep[rep[v]]; // rep[v] <= v, already resolved
+        if (out.positions[v] != out.positions[rep[v]]) {
+            out.positions[v] = out.positions[rep[v]];
+            moved[rep[v]] = 1;
+            report.positionsMerged++;
+        }
+    }
+
+    // smooth normals across the clusters that moved: members grouped by root (ascending ids)
+    if (out.normals.size() == n && report.positionsMerged > 0) {
+        ScratchVector<unsigned int> first(n + 1);
+        std::fill(first.begin(), first.end(), 0u);
+        for (size_t v = 0; v < n; ++v) first[rep[v] + 1]++;
+        for (size_t v = 0; v < n; ++v) first[v + 1] += first[v];
+        ScratchVector<unsigned int> members(n);
+        {
+            ScratchVector<unsigned int> fill(n);
+            std::copy(first.begin(), first.begin() + n, fill.begin());
+            for (size_t v = 0; v < n; ++v) members[fill[rep[v]]++] = (unsigned int)v;
+        }
+        std::vector<glm::vec3> normals(out.normals);
+        std::atomic<size_t> smoothed{ 0 };
+        globalThreadPool().parallel_for(0, n, 4096, [&](size_t b, size_t e) {
+            size_t local = 0;
+            for (size_t r = b; r < e; ++r) {
+                if (!moved[r]) continue;
+                for (unsigned int i = first[r]; i < first[r + 1]; ++i) {
+                    const unsigned int v = members[i];
+                    const glm::vec3 nv = out.normals[v];
+                    const float lv = glm::length(nv);
+                    if (!(lv > 0.0f)) continue;
+                    glm::vec3 sum(0.0f);
+                    for (unsigned int k = first[r]; k < first[r + 1]; ++k) {
+                        const glm::vec3 nk = out.normals[members[k]];
+                        const float lk = glm::length(nk);
+                        if (lk > 0.0f && glm::dot(nv, nk) >= kWeldSmoothCos * lv * lk) sum += nk / lk;
+                    }
+                    const glm::vec3 avg = glm::normalize(sum);
+                    if (avg != nv) { normals[v] = avg; ++local; }
+                }
+            }
+            smoothed += local;
         });
+        out.normals.swap(normals);
+        report.normalsSmoothed = smoothed.load();
+    }
+
+    // exact dedup of the snapped vertices
+    struct Key { glm::vec3 p; glm::vec3 nrm; glm::vec2 t;
+        bool operator==(Key const& o) const { return p == o.p && nrm == o.nrm && t == o.t; } };
+    struct KeyHash { size_t operator()(Key const& k) const noexcept {
+        size_t h1 = std::hash<float>()(k.p.x) ^ (std::hash<float>()(k.p.y) << 1) ^ (std::hash<float>()(k.p.z) << 2);
+        size_t h2 = std::hash<float>()(k.nrm.x) ^ (std::hash<float>()(k.nrm.y) << 1) ^ (std::hash<float>()(k.nrm.z) << 2);
+        size_t h3 = std::hash<float>()(k.t.x) ^ (std::hash<float>()(k.t.y) << 1);
+        return h1 ^ (h2 << 3) ^ (h3 << 5);
+    } };
+    const bool hasNormals = out.normals.size() == n;
+    const bool hasUV = out.texcoords.size() == n;
+    std::unordered_map<Key, unsigned int, KeyHash> map;
+    map.reserve(n);
+    ScratchVector<unsigned int> remap(n);
+    std::vector<glm::vec3> positions, normals;
+    std::vector<glm::vec2> texcoords;
+    for (size_t v = 0; v < n; ++v) {
+        Key key{ out.positions[v], hasNormals ? out.normals[v] : glm::vec3(0.0f), hasUV ? out.texcoords[v] : glm::vec2(0.0f) };
+        auto it = map.find(key);
+        if (it == map.end()) {
+            it = map.emplace(key, (unsigned int)positions.size()).first;
+            positions.push_back(key.p);
+            if (hasNormals) normals.push_back(key.nrm);
+            if (hasUV) texcoords.push_back(key.t);
+        }
+        remap[v] = it->second;
+    }
+    globalThreadPool().parallel_for(0, out.indices.size(), 16384, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) out.indices[i] = remap[out.indices[i]];
+    });
+    out.positions.swap(positions);
+    out.normals.swap(normals);
+    out.texcoords.swap(texcoords);
+
+    report.applied = true;
+    report.verticesAfter = out.positions.size();
 }
 
-void Loader::requestImportAsync(const std::string& path) {
-    import_positions_ptr = std::make_shared<std::vector<glm::vec3>>();
-    import_normals_ptr = std::make_shared<std::vector<glm::vec3>>();
-    import_indices_ptr = std::make_shared<std::vector<unsigned int>>();
-    import_ready = std::make_shared<std::atomic<bool>>(false);
-    import_failed = std::make_shared<std::atomic<bool>>(false);
-    import_progress = std::make_shared<std::atomic<float>>(0.0f);
+// exclusive prefix sum of 0/1 flags on the pool: offsets[i] = flags set before i; returns the total
+static size_t scan_flags(const unsigned char* flags, size_t n, unsigned int* offsets)
+{
+    ThreadPool& pool = globalThreadPool();
+    const size_t chunks = std::max<size_t>(1, std::min<size_t>(pool.size() + 1, n / 65536));
+    std::vector<size_t> sums(chunks + 1, 0);
+    pool.parallel_for(0, chunks, 1, [&](size_t b, size_t e) {
+        for (size_t c = b; c < e; ++c) {
+            size_t sum = 0;
+            for (size_t i = n * c / chunks; i < n * (c + 1) / chunks; ++i) sum += flags[i];
+            sums[c + 1] = sum;
+        }
+    });
+    for (size_t c = 0; c < chunks; ++c) sums[c + 1] += sums[c];
+    pool.parallel_for(0, chunks, 1, [&](size_t b, size_t e) {
+        for (size_t c = b; c < e; ++c) {
+            size_t sum = sums[c];
+            for (size_t i = n * c / chunks; i < n * (c + 1) / chunks; ++i) {
+                offsets[i] = (unsigned int)sum;
+                sum += flags[i];
+            }
+        }
+    });
+    return sums[chunks];
+}
+
+// Drop degenerate triangles (repeated vertex, repeated position or zero area) and exact
+// duplicates (same corners, same winding, same material), then compact vertices no index uses.
+// Every step runs over triangle or vertex ranges on the pool, so a single-material mesh scales
+// like any other; duplicates are found by sorting canonical keys. Keeps triangle order.
+static void clean_mesh(MeshData& out)
+{
+    CleanupReport& report = out.cleanupReport; // invalidTriangles was filled by the parser
+    report.degenerateTriangles = report.duplicateTriangles = report.unusedVertices = 0;
+    if (out.indices.empty()) return;
 
-    importLoaderFuture = std::async(std::launch::async,
-        [this, path]() {
-            bool ok = Loader::load_model_simple(path, *import_positions_ptr, *import_normals_ptr, *import_indices_ptr, import_progress.get());
-            if (!ok) import_failed->store(true);
-            else import_ready->store(true);
+    ThreadPool& pool = globalThreadPool();
+    const size_t triCount = out.indices.size() / 3;
+    ScratchVector<unsigned char> keep(triCount, 1);
+    std::atomic<size_t> degenerate{0}, duplicate{0};
+
+    // key per triangle: material, then the corners rotated smallest first so the key keeps the
+    // winding; degenerate triangles all get the largest key and stay out of the duplicate scan
+    struct TriKey { uint64_t hi, lo; unsigned int tri; };
+    static const uint64_t kDegenerateKey = ~0ull;
+    ScratchVector<TriKey> keys(triCount);
+    pool.parallel_for(0, triCount, 16384, [&](size_t tb, size_t te) {
+        // batches are contiguous and in index order; bi ends up one past the batch holding t
+        size_t bi = 0, deg = 0;
+        for (size_t t = tb; t < te; ++t) {
+            while (bi < out.batches.size() && out.batches[bi].firstIndex <= t * 3) ++bi;
+            const unsigned int i0 = out.indices[t * 3 + 0], i1 = out.indices[t * 3 + 1], i2 = out.indices[t * 3 + 2];
+            const glm::vec3& p0 = out.positions[i0];
+            const glm::vec3& p1 = out.positions[i1];
+            const glm::vec3& p2 = out.positions[i2];
+            if (i0 == i1 || i1 == i2 || i0 == i2 || p0 == p1 || p1 == p2 || p0 == p2 ||
+                glm::cross(p1 - p0, p2 - p0) == glm::vec3(0.0f)) {
+                keep[t] = 0; ++deg;
+                keys[t] = TriKey{ kDegenerateKey, kDegenerateKey, (unsigned int)t };
+                continue;
+            }
+            unsigned int k0 = i0, k1 = i1, k2 = i2;
+            if (i1 < i0 && i1 < i2) { k0 = i1; k1 = i2; k2 = i0; }
+            else if (i2 < i0 && i2 < i1) { k0 = i2; k1 = i0; k2 = i1; }
+            const uint64_t material = bi > 0 ? out.batches[bi - 1].materialIndex : 0;
+            keys[t] = TriKey{ material << 32 | k0, (uint64_t)k1 << 32 | k2, (unsigned int)t };
+        }
+        degenerate += deg;
+    });
+    parallel_sort(keys, [](const TriKey& x, const TriKey& y) {
+        if (x.hi != y.hi) return x.hi < y.hi;
+        if (x.lo != y.lo) return x.lo < y.lo;
+        return x.tri < y.tri;
+    });
+    // the first triangle of each run of equal keys is the one kept
+    pool.parallel_for(1, triCount, 16384, [&](size_t b, size_t e) {
+        size_t dup = 0;
+        for (size_t i = b; i < e; ++i) {
+            const TriKey& k = keys[i];
+            if (k.hi == kDegenerateKey && k.lo == kDegenerateKey) continue;
+            if (k.hi == keys[i - 1].hi && k.lo == keys[i - 1].lo) { keep[k.tri] = 0; ++dup; }
+        }
+        duplicate += dup;
+    });
+    report.degenerateTriangles = degenerate.load();
+    report.duplicateTriangles = duplicate.load();
+
+    if (report.degenerateTriangles + report.duplicateTriangles > 0) {
+        // batches stay contiguous, so compacting only shifts their ranges
+        ScratchVector<unsigned int> dest(triCount);
+        const size_t kept = scan_flags(keep.data(), triCount, dest.data());
+        std::vector<unsigned int> indices(kept * 3);
+        pool.parallel_for(0, triCount, 16384, [&](size_t b, size_t e) {
+            for (size_t t = b; t < e; ++t) {
+                if (!keep[t]) continue;
+                for (size_t c = 0; c < 3; ++c) indices[dest[t] * 3 + c] = out.indices[t * 3 + c];
+            }
         });
+        const auto keptBefore = [&](size_t t) { return t < triCount ? (size_t)dest[t] : kept; };
+        for (MaterialBatch& batch : out.batches) {
+            const size_t tb = batch.firstIndex / 3, te = (batch.firstIndex + batch.indexCount) / 3;
+            batch.firstIndex = (unsigned int)(keptBefore(tb) * 3);
+            batch.indexCount = (unsigned int)((keptBefore(te) - keptBefore(tb)) * 3);
+        }
+        out.indices.swap(indices);
+        out.batches.erase(std::remove_if(out.batches.begin(), out.batches.end(),
+                                         [](const MaterialBatch& b) { return b.indexCount == 0; }),
+                          out.batches.end());
+    }
+
+    // compact vertices: mark, prefix sum, then scatter and rewrite indices, all in parallel
+    const size_t vertexCount = out.positions.size();
+    ScratchVector<unsigned char> used(vertexCount, 0);
+    pool.parallel_for(0, out.indices.size(), 16384, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) std::atomic_ref<unsigned char>(used[out.indices[i]]).store(1, std::memory_order_relaxed);
+    });
+    ScratchVector<unsigned int> remap(vertexCount);
+    const size_t usedCount = scan_flags(used.data(), vertexCount, remap.data());
+    report.unusedVertices = vertexCount - usedCount;
+
+    if (report.unusedVertices > 0) {
+        const bool hasNormals = out.normals.size() == vertexCount;
+        const bool hasUV = out.texcoords.size() == vertexCount;
+        std::vector<glm::vec3> positions(usedCount), normals(hasNormals ? usedCount : 0);
+        std::vector<glm::vec2> texcoords(hasUV ? usedCount : 0);
+        pool.parallel_for(0, vertexCount, 16384, [&](size_t b, size_t e) {
+            for (size_t v = b; v < e; ++v) {
+                if (!used[v]) continue;
+                const unsigned int d = remap[v];
+                positions[d] = out.positions[v];
+                if (hasNormals) normals[d] = out.normals[v];
+                if (hasUV) texcoords[d] = out.texcoords[v];
+            }
+        });
+        pool.parallel_for(0, out.indices.size(), 16384, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) out.indices[i] = remap[out.indices[i]];
+        });
+        out.positions.swap(positions);
+        out.normals.swap(normals);
+        out.texcoords.swap(texcoords);
+    }
 }
 
-bool Loader::maybeFinishImport() {
-    if (import_ready && import_ready->load()) {
-        if (import_failed && import_failed->load()) {
-            std::cerr << "Import model failed to parse\n";
-        } else {
-            positions_ptr = std::move(import_positions_ptr);
-            normals_ptr = std::move(import_normals_ptr);
-            indices_ptr = std::move(import_indices_ptr);
+// Make the winding of every connected component consistent and flag closed manifolds.
+// Closed components are turned outward (positive signed volume) and may be backface culled;
+// open ones keep the majority winding of the source. Batches are split into culled/unculled parts.
+static void orient_mesh(MeshData& out)
+{
+    OrientationReport& report = out.orientReport;
+    report = OrientationReport{};
+    const size_t triCount = out.indices.size() / 3;
+    if (triCount == 0) return;
+
+    HalfEdgeMesh he;
+    build_half_edge_mesh(out.positions, out.indices, he);
+    report.boundaryEdges = he.boundaryEdges;
+    report.nonManifoldEdges = he.nonManifoldEdges;
+
+    // triangles grouped per component
+    const size_t compCount = he.componentCount;
+    ScratchVector<unsigned int> compStart(compCount + 1, 0), compTris(triCount);
+    for (size_t t = 0; t < triCount; ++t) compStart[he.component[t] + 1]++;
+    for (size_t c = 0; c < compCount; ++c) compStart[c + 1] += compStart[c];
+    {
+        std::vector<unsigned int> cursor(compStart.begin(), compStart.end() - 1);
+        for (size_t t = 0; t < triCount; ++t) compTris[cursor[he.component[t]]++] = (unsigned int)t;
+    }
+
+    // BFS each component on the pool
+    ScratchVector<unsigned char> flip(triCount, 0), visited(triCount, 0), closedTri(triCount, 0);
+    std::atomic<size_t> closedComps{0}, nonOrientable{0}, flipped{0};
+    globalThreadPool().parallel_for(0, compCount, 16, [&](size_t cb, size_t ce) {
+        std::vector<unsigned int> queue;
+        for (size_t c = cb; c < ce; ++c) {
+            const unsigned int* tris = &compTris[compStart[c]];
+            const size_t n = compStart[c + 1] - compStart[c];
+            bool orientable = true, open = false;
+            queue.clear();
+            queue.push_back(tris[0]);
+            visited[tris[0]] = 1;
+            for (size_t q = 0; q < queue.size(); ++q) {
+                const unsigned int t = queue[q];
+                for (unsigned int h = t * 3; h < t * 3 + 3; ++h) {
+                    const unsigned int tw = he.twin[h];
+                    if (tw == HalfEdgeMesh::invalid) { open = true; continue; }
+                    const unsigned int nb = HalfEdgeMesh::face(tw);
+                    // consistent neighbours walk a shared edge in opposite directions
+                    const unsigned char want = flip[t] ^ (he.twinSameDirection(h) ? 1 : 0);
+                    if (!visited[nb]) { visited[nb] = 1; flip[nb] = want; queue.push_back(nb); }
+                    else if (flip[nb] != want) orientable = false;
+                }
+            }
 
-            modelReady.store(true);
-            modelLoadFailed.store(false);
-            loadProgress.store(import_progress ? import_progress->load() : 0.0f);
+            bool invert = false;
+            const bool closed = orientable && !open;
+            if (closed) {
+                // outward when the signed volume is positive
+                double volume = 0.0;
+                for (size_t i = 0; i < n; ++i) {
+                    const unsigned int t = tris[i];
+                    glm::vec3 p0 = out.positions[out.indices[t * 3 + 0]];
+                    glm::vec3 p1 = out.positions[out.indices[t * 3 + 1]];
+                    glm::vec3 p2 = out.positions[out.indices[t * 3 + 2]];
+                    if (flip[t]) std::swap(p1, p2);
+                    volume += glm::dot(p0, glm::cross(p1, p2));
+                }
+                invert = volume < 0.0;
+            } else {
+                size_t f = 0;
+                for (size_t i = 0; i < n; ++i) f += flip[tris[i]];
+                invert = f * 2 > n;
+            }
+
+            size_t changed = 0;
+            for (size_t i = 0; i < n; ++i) {
+                const unsigned int t = tris[i];
+                flip[t] ^= invert ? 1 : 0;
+                changed += flip[t];
+                closedTri[t] = closed ? 1 : 0;
+            }
+            flipped += changed;
+            if (closed) closedComps++;
+            if (!orientable) nonOrientable++;
         }
+    });
 
-        import_ready.reset(); import_failed.reset(); import_progress.reset();
-        if (importLoaderFuture.valid()) importLoaderFuture = std::future<void>();
-        return true;
+    globalThreadPool().parallel_for(0, triCount, 16384, [&](size_t b, size_t e) {
+        for (size_t t = b; t < e; ++t) {
+            if (flip[t]) std::swap(out.indices[t * 3 + 1], out.indices[t * 3 + 2]);
+        }
+    });
+
+    // closed triangles first inside every batch, split when a batch has both kinds
+    std::vector<MaterialBatch> batches;
+    ScratchVector<unsigned int> sorted(out.indices.size());
+    size_t w = 0;
+    for (const MaterialBatch& batch : out.batches) {
+        const size_t tb = batch.firstIndex / 3, te = (batch.firstIndex + batch.indexCount) / 3;
+        for (int pass = 1; pass >= 0; --pass) {
+            const size_t first = w;
+            for (size_t t = tb; t < te; ++t) {
+                if (closedTri[t] != pass) continue;
+                for (size_t c = 0; c < 3; ++c) sorted[w * 3 + c] = out.indices[t * 3 + c];
+                ++w;
+            }
+            if (w == first) continue;
+            MaterialBatch nb = batch;
+            nb.firstIndex = (unsigned int)(first * 3);
+            nb.indexCount = (unsigned int)((w - first) * 3);
+            nb.cullBackfaces = pass == 1;
+            if (nb.cullBackfaces) report.cullableTriangles += w - first;
+            batches.push_back(nb);
+        }
     }
-    return false;
+    std::copy(sorted.begin(), sorted.end(), out.indices.begin());
+    out.batches.swap(batches);
+
+    report.components = compCount;
+    report.closedComponents = closedComps.load();
+    report.nonOrientableComponents = nonOrientable.load();
+    report.flippedTriangles = flipped.load();
 }
 
-bool Loader::load_model_simple(const std::string& path,
-                               std::vector<glm::vec3>& out_positions,
-                               std::vector<glm::vec3>& out_normals,
-                               std::vector<unsigned int>& out_indices,
-                               std::atomic<float>* progress)
+// connectivity of the final mesh: topology numbers plus the wireframe line list, feature edges first
+static void build_topology(MeshData& out, const LoadOptions& options)
+{
+    TopologyReport& report = out.topologyReport;
+    report = TopologyReport{};
+    out.edgeLines.clear();
+    out.silhouetteEdges.clear();
+    out.featureLineCount = 0;
+    if (out.indices.empty()) return;
+
+    HalfEdgeMesh he;
+    build_half_edge_mesh(out.positions, out.indices, he);
+    out.featureLineCount = build_edge_lines(he, out.indices, options.featureAngle, out.edgeLines);
+    build_silhouette_edges(he, out.indices, out.silhouetteEdges);
+
+    report.edges = he.edgeCount;
+    report.boundaryEdges = he.boundaryEdges;
+    report.nonManifoldEdges = he.nonManifoldEdges;
+    report.components = he.componentCount;
+    report.featureEdges = out.featureLineCount / 2;
+}
+
+// stages that run on the finished, material-sorted mesh
+static void post_process_mesh(MeshData& out, const LoadOptions& options)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    mark_stage(options, "weld");
+    weld_vertices(out, options);
+    mark_stage(options, "clean");
+    clean_mesh(out);
+    mark_stage(options, "atlas");
+    build_material_atlas(out, options);
+    mark_stage(options, "orient");
+    orient_mesh(out);
+    mark_stage(options, "flat shading");
+    apply_flat_shading(out, options);
+    mark_stage(options, "topology");
+    build_topology(out, options);
+    out.timings.postSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static bool load_model_dispatch(const std::string& path, MeshData& out, std::atomic<float>* progress,
+                                const LoadOptions& options);
+
+bool Loader::load_model(const std::string& path, MeshData& out, std::atomic<float>* progress,
+                        const LoadOptions& options)
+{
+    out.clear();
+    globalScratchPool().configure(options.reuseScratch, options.hugePageScratch);
+    const uint64_t faults0 = process_page_faults();
+    auto t0 = std::chrono::steady_clock::now();
+    mark_stage(options, "parse");
+    bool ok = load_model_dispatch(path, out, progress, options);
+    mark_stage(options, nullptr);
+    LoadTimings& t = out.timings;
+    t.totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    t.parseSeconds = std::max(0.0, t.totalSeconds - t.textureSeconds - t.postSeconds);
+    t.pageFaults = process_page_faults() - faults0;
+    return ok;
+}
+
+static bool load_model_dispatch(const std::string& path, MeshData& out, std::atomic<float>* progress,
+                                const LoadOptions& options)
 {
     const std::string ext = extlower(path);
-    if (ext == ".obj") {
-        return load_obj_simple_internal(path, out_positions, out_normals, out_indices, progress);
+    if (is_point_cloud_file(path)) {
+        mark_stage(options, "points");
+        if (!load_point_cloud(path, out.points, progress)) return false;
+        out.timings.postSeconds = out.points.buildSeconds;
+        return true;
+    }
+
+    if (ext == ".obj" || ext.empty()) {
+        // Unknown extension: try OBJ fallback
+        if (!load_obj_simple_internal(path, out, progress, options)) return false;
+        post_process_mesh(out, options);
+        return true;
     }
 
 #ifdef USE_ASSIMP
@@ -136,28 +1171,50 @@ bool Loader::load_model_simple(const std::string& path,
             return false;
         }
 
-        out_positions.clear();
-        out_normals.clear();
-        out_indices.clear();
+        // materials: diffuse colour, opacity and the first diffuse texture (embedded "*N" textures are skipped)
+        const std::filesystem::path baseDir = std::filesystem::path(path).parent_path();
+        for (unsigned m = 0; m < scene->mNumMaterials; ++m) {
+            const aiMaterial* am = scene->mMaterials[m];
+            Material mat;
+            aiString name;
+            if (am->Get(AI_MATKEY_NAME, name) == AI_SUCCESS) mat.name = name.C_Str();
+            aiColor3D kd(0.8f, 0.8f, 0.8f);
+            if (am->Get(AI_MATKEY_COLOR_DIFFUSE, kd) == AI_SUCCESS) mat.diffuse = glm::vec3(kd.r, kd.g, kd.b);
+            float opacity = 1.0f;
+            if (am->Get(AI_MATKEY_OPACITY, opacity) == AI_SUCCESS) mat.opacity = opacity;
+            aiString tex;
+            if (am->GetTexture(aiTextureType_DIFFUSE, 0, &tex) == AI_SUCCESS && tex.length > 0 && tex.data[0] != '*') {
+                mat.diffuseMap = resolve_texture_path(baseDir, tex.C_Str());
+            }
+            out.materials.push_back(std::move(mat));
+        }
+        if (out.materials.empty()) {
+            out.materials.push_back(Material{});
+            out.materials.back().name = "default";
+        }
 
-        struct Key { glm::vec3 p,n; bool operator==(Key const& o) const { return p==o.p && n==o.n; } };
+        struct Key { glm::vec3 p,n; glm::vec2 t; bool operator==(Key const& o) const { return p==o.p && n==o.n && t==o.t; } };
         struct KeyHash { size_t operator()(Key const& k) const noexcept {
             size_t h1 = std::hash<float>()(k.p.x) ^ (std::hash<float>()(k.p.y) << 1) ^ (std::hash<float>()(k.p.z) << 2);
             size_t h2 = std::hash<float>()(k.n.x) ^ (std::hash<float>()(k.n.y) << 1) ^ (std::hash<float>()(k.n.z) << 2);
-            return h1 ^ (h2 << 1);
+            size_t h3 = std::hash<float>()(k.t.x) ^ (std::hash<float>()(k.t.y) << 1);
+            return h1 ^ (h2 << 1) ^ (h3 << 3);
         } };
         std::unordered_map<Key, unsigned int, KeyHash> vertMap;
         vertMap.reserve(1024);
+        ScratchVector<unsigned int> triMaterial;
 
         for (unsigned m = 0; m < scene->mNumMeshes; ++m) {
             const aiMesh* mesh = scene->mMeshes[m];
             if (progress) progress->store(float(m) / float(scene->mNumMeshes + 1));
+            const unsigned int matIndex = (mesh->mMaterialIndex < out.materials.size()) ? mesh->mMaterialIndex : 0u;
             for (unsigned i = 0; i < mesh->mNumFaces; ++i) {
                 const aiFace& f = mesh->mFaces[i];
                 if (f.mNumIndices != 3) continue;
                 for (unsigned k = 0; k < 3; ++k) {
                     unsigned int idx = f.mIndices[k];
                     glm::vec3 p(0.0f), n(0.0f);
+                    glm::vec2 t(0.0f);
                     if (mesh->HasPositions()) {
                         aiVector3D pp = mesh->mVertices[idx];
                         p = glm::vec3(pp.x, pp.y, pp.z);
@@ -168,62 +1225,85 @@ bool Loader::load_model_simple(const std::string& path,
                     } else {
                         n = glm::vec3(0.0f, 0.0f, 1.0f);
                     }
-                    Key kkey{p,n};
+                    if (mesh->HasTextureCoords(0)) {
+                        aiVector3D tt = mesh->mTextureCoords[0][idx];
+                        t = glm::vec2(tt.x, tt.y);
+                    }
+                    Key kkey{p,n,t};
                     auto it = vertMap.find(kkey);
                     if (it != vertMap.end()) {
-                        out_indices.push_back(it->second);
+                        out.indices.push_back(it->second);
                     } else {
-                        unsigned int newIndex = (unsigned int)out_positions.size();
+                        unsigned int newIndex = (unsigned int)out.positions.size();
                         vertMap.emplace(kkey, newIndex);
-                        out_positions.push_back(p);
-                        out_normals.push_back(n);
-                        out_indices.push_back(newIndex);
+                        out.positions.push_back(p);
+                        out.normals.push_back(n);
+                        out.texcoords.push_back(t);
+                        out.indices.push_back(newIndex);
                     }
                 }
+                triMaterial.push_back(matIndex);
             }
         }
 
-        if (!out_positions.empty()) {
-            glm::vec3 minP = out_positions[0];
-            glm::vec3 maxP = out_positions[0];
-            for (size_t i = 1; i < out_positions.size(); ++i) {
-                minP = glm::min(minP, out_positions[i]);
-                maxP = glm::max(maxP, out_positions[i]);
-            }
-            glm::vec3 diag = maxP - minP;
+        Bounds3 bounds;
+        if (geom_bounds(out.positions.data(), out.positions.size(), bounds)) {
+            glm::vec3 diag = bounds.max - bounds.min;
             float maxDim = glm::max(glm::max(diag.x, diag.y), diag.z);
             if (maxDim > 1e-6f) {
                 const float targetSize = 1.0f;
                 float scale = targetSize / maxDim * 10.0f;
-                for (auto &p : out_positions) p *= scale;
+                geom_scale_offset(out.positions.data(), out.positions.size(), glm::vec3(scale), glm::vec3(0.0f));
             }
         }
 
+        mark_stage(options, "sort");
+        sort_triangles_by_material(out, triMaterial);
+        load_material_textures(out, options);
+        post_process_mesh(out, options);
+
         if (progress) progress->store(1.0f);
-        return !out_indices.empty();
+        return !out.indices.empty();
     }
 #endif // USE_ASSIMP
 
-    // Unknown extension: try OBJ fallback
-    if (ext.empty()) {
-        return load_obj_simple_internal(path, out_positions, out_normals, out_indices, progress);
-    }
-
     std::cerr << "Unsupported model extension: " << ext << " for path " << path << "\n";
     if (progress) progress->store(1.0f);
     return false;
 }
 
+bool Loader::load_model_simple(const std::string& path,
+                               std::vector<glm::vec3>& out_positions,
+                               std::vector<glm::vec3>& out_normals,
+                               std::vector<unsigned int>& out_indices,
+                               std::atomic<float>* progress)
+{
+    // callers of the plain arrays expect one normal per position
+    MeshData mesh;
+    LoadOptions options;
+    options.flatShading = FlatShading::Off;
+    bool ok = Loader::load_model(path, mesh, progress, options);
+    out_positions = std::move(mesh.positions);
+    out_normals = std::move(mesh.normals);
+    out_indices = std::move(mesh.indices);
+    return ok;
+}
+
 // old OBJ parser. remains as only dedicated model parser outside of assimp
 static bool load_obj_simple_internal(const std::string& path,
-                        std::vector<glm::vec3>& out_positions,
-                        std::vector<glm::vec3>& out_normals,
-                        std::vector<unsigned int>& out_indices,
-                        std::atomic<float>* progress)
+                        MeshData& out,
+                        std::atomic<float>* progress,
+                        const LoadOptions& options)
 {
-    std::vector<glm::vec3> temp_pos;
-    std::vector<glm::vec3> temp_norm;
-    std::vector<unsigned int> pos_idx, norm_idx;
+    ScratchVector<glm::vec3> temp_pos;
+    ScratchVector<glm::vec3> temp_norm;
+    ScratchVector<glm::vec2> temp_uv;
+    ScratchVector<unsigned int> pos_idx, norm_idx, uv_idx;
+    ScratchVector<unsigned int> triMaterial;
+
+    std::unordered_map<std::string, unsigned int> materialByName;
+    int currentMaterial = -1;
+    const std::filesystem::path baseDir = std::filesystem::path(path).parent_path();
 
     std::ifstream in(path);
     if (!in) {
@@ -239,83 +1319,79 @@ static bool load_obj_simple_internal(const std::string& path,
     temp_norm.reserve(approxLines / 8);
     pos_idx.reserve(approxLines);
     norm_idx.reserve(approxLines);
+    uv_idx.reserve(approxLines);
 
     if (progress) progress->store(0.0f);
 
+    ObjFaceSink sink;
+    sink.pos_idx = &pos_idx;
+    sink.uv_idx = &uv_idx;
+    sink.norm_idx = &norm_idx;
+    sink.triMaterial = &triMaterial;
+    sink.temp_pos = &temp_pos;
+    sink.temp_uv = &temp_uv;
+    sink.temp_norm = &temp_norm;
+
     std::string line;
     size_t bytesSeen = 0;
     size_t lastProgressUpdateBytes = 0;
     const size_t PROGRESS_UPDATE_GRANULARITY = (1u << 12);
+    const bool fastAttributes = !options.streamObjAttributes;
 
     while (std::getline(in, line)) {
-        std::istringstream ss(line);
-        std::string tag; ss >> tag;
-        if (tag == "v") {
-            glm::vec3 p; ss >> p.x >> p.y >> p.z;
-            temp_pos.push_back(p);
-        } else if (tag == "vn") {
-            glm::vec3 n; ss >> n.x >> n.y >> n.z;
-            temp_norm.push_back(n);
-        } else if (tag == "f") {
-            std::vector<int> face_pos_idx;
-            std::vector<int> face_norm_idx;
-            face_pos_idx.reserve(8);
-            face_norm_idx.reserve(8);
-
-            std::string vert;
-            while (ss >> vert) {
-                int vi = 0, ni = 0;
-                const char* s = vert.c_str();
-                char* endptr = nullptr;
-                long vval = strtol(s, &endptr, 10);
-                if (endptr == s) continue;
-                vi = (int)vval;
-                if (*endptr == '/') {
-                    const char* p2 = endptr + 1;
-                    if (*p2 == '/') {
-                        const char* p3 = p2 + 1;
-                        ni = (int)strtol(p3, nullptr, 10);
-                    } else {
-                        char* endptr2 = nullptr;
-                        strtol(p2, &endptr2, 10);
-                        if (*endptr2 == '/') {
-                            ni = (int)strtol(endptr2 + 1, nullptr, 10);
-                        }
-                    }
+        const char* lp = skip_blanks(line.c_str());
+        if (lp[0] == 'f' && is_blank(lp[1])) {
+            if (currentMaterial < 0) {
+                // faces before any usemtl share an implicit default material
+                auto it = materialByName.find("default");
+                if (it == materialByName.end()) {
+                    it = materialByName.emplace("default", (unsigned int)out.materials.size()).first;
+                    out.materials.push_back(Material{});
+                    out.materials.back().name = "default";
                 }
-
-                auto convert_index = [](int idx, size_t array_size) -> int {
-                    if (idx > 0) return idx - 1;
-                    if (idx < 0) return (int)array_size + idx;
-                    return -1;
-                };
-
-                int posIndex = convert_index(vi, temp_pos.size());
-                int normIndex = convert_index(ni, temp_norm.size());
-
-                face_pos_idx.push_back(posIndex >= 0 ? posIndex : -1);
-                face_norm_idx.push_back(normIndex >= 0 ? normIndex : -1);
+                currentMaterial = (int)it->second;
             }
-
-            if (face_pos_idx.size() < 3) {
-                // skip
-            } else {
-                for (size_t i = 2; i < face_pos_idx.size(); ++i) {
-                    int p0 = face_pos_idx[0];
-                    int p1 = face_pos_idx[i-1];
-                    int p2 = face_pos_idx[i];
-                    int n0 = face_norm_idx[0];
-                    int n1 = face_norm_idx[i-1];
-                    int n2 = face_norm_idx[i];
-
-                    pos_idx.push_back((p0 >= 0) ? (unsigned int)p0 : 0u);
-                    pos_idx.push_back((p1 >= 0) ? (unsigned int)p1 : 0u);
-                    pos_idx.push_back((p2 >= 0) ? (unsigned int)p2 : 0u);
-
-                    norm_idx.push_back((n0 >= 0) ? (unsigned int)n0 : 0u);
-                    norm_idx.push_back((n1 >= 0) ? (unsigned int)n1 : 0u);
-                    norm_idx.push_back((n2 >= 0) ? (unsigned int)n2 : 0u);
+            sink.material = (unsigned int)currentMaterial;
+            parse_face(lp + 1, line.c_str() + line.size(), sink);
+        } else if (fastAttributes && lp[0] == 'v' && is_blank(lp[1])) {
+            glm::vec3 p(0.0f);
+            parse_floats(lp + 1, line.c_str() + line.size(), &p.x, 3);
+            temp_pos.push_back(p);
+        } else if (fastAttributes && lp[0] == 'v' && lp[1] == 'n' && is_blank(lp[2])) {
+            glm::vec3 n(0.0f);
+            parse_floats(lp + 2, line.c_str() + line.size(), &n.x, 3);
+            temp_norm.push_back(n);
+        } else if (fastAttributes && lp[0] == 'v' && lp[1] == 't' && is_blank(lp[2])) {
+            glm::vec2 t(0.0f);
+            parse_floats(lp + 2, line.c_str() + line.size(), &t.x, 2);
+            temp_uv.push_back(t);
+        } else {
+            std::istringstream ss(line);
+            std::string tag; ss >> tag;
+            if (tag == "v") {
+                glm::vec3 p(0.0f); ss >> p.x >> p.y >> p.z;
+                temp_pos.push_back(p);
+            } else if (tag == "vn") {
+                glm::vec3 n(0.0f); ss >> n.x >> n.y >> n.z;
+                temp_norm.push_back(n);
+            } else if (tag == "vt") {
+                glm::vec2 t(0.0f); ss >> t.x >> t.y;
+                temp_uv.push_back(t);
+            } else if (tag == "mtllib") {
+                std::string lib; std::getline(ss, lib);
+                lib = trim(lib);
+                if (!lib.empty()) parse_mtl_file((baseDir / lib).string(), out.materials, materialByName);
+            } else if (tag == "usemtl") {
+                std::string name; std::getline(ss, name);
+                name = trim(name);
+                auto it = materialByName.find(name);
+                if (it == materialByName.end()) {
+                    // referenced but not defined in any mtllib: keep the name, default surface
+                    it = materialByName.emplace(name, (unsigned int)out.materials.size()).first;
+                    out.materials.push_back(Material{});
+                    out.materials.back().name = name;
                 }
+                currentMaterial = (int)it->second;
             }
         }
 
@@ -327,34 +1403,59 @@ static bool load_obj_simple_internal(const std::string& path,
         }
     }
 
-    struct Key { int p, n; bool operator==(Key const& o) const { return p == o.p && n == o.n; } };
-    struct KeyHash { size_t operator()(Key const& k) const noexcept { return (size_t)k.p * 1000003u + (size_t)k.n; } };
+    // (position, uv, normal) -> output vertex: open addressing in one pooled array, so repeated
+    // loads don't pay a node allocation per corner
+    mark_stage(options, "dedup");
+    struct Slot { int p, t, n; unsigned int vertex; };
+    const unsigned int emptySlot = 0xFFFFFFFFu;
+    size_t tableSize = 1024;
+    while (tableSize < pos_idx.size() * 2) tableSize <<= 1;
+    ScratchVector<Slot> table(tableSize, Slot{ 0, 0, 0, emptySlot });
+    const size_t tableMask = tableSize - 1;
 
-    std::unordered_map<Key, unsigned int, KeyHash> map;
-    map.reserve(pos_idx.size() * 2);
+    out.positions.clear();
+    out.normals.clear();
+    out.texcoords.clear();
+    out.indices.clear();
+    out.positions.reserve(pos_idx.size());
+    out.normals.reserve(pos_idx.size());
+    out.texcoords.reserve(pos_idx.size());
+    out.indices.reserve(pos_idx.size());
 
-    out_positions.clear();
-    out_normals.clear();
-    out_indices.clear();
-    out_positions.reserve(pos_idx.size());
-    out_normals.reserve(pos_idx.size());
-    out_indices.reserve(pos_idx.size());
+    ScratchVector<unsigned int> keptMaterial;
+    keptMaterial.reserve(triMaterial.size());
+    for (size_t tri = 0; tri < triMaterial.size(); ++tri) {
+        bool valid = true;
+        for (size_t c = 0; c < 3; ++c) valid = valid && pos_idx[tri * 3 + c] < temp_pos.size();
+        if (!valid) { out.cleanupReport.invalidTriangles++; continue; }
+        keptMaterial.push_back(triMaterial[tri]);
 
-    for (size_t i = 0; i < pos_idx.size(); ++i) {
-        Key key{ (int)pos_idx[i], (int)norm_idx[i] };
-        auto it = map.find(key);
-        if (it != map.end()) {
-            out_indices.push_back(it->second);
-        } else {
-            unsigned int newIndex = (unsigned int)out_positions.size();
-            map[key] = newIndex;
-            out_positions.push_back((temp_pos.size() > (size_t)key.p) ? temp_pos[key.p] : glm::vec3(0.0f));
-            if (!temp_norm.empty() && (size_t)key.n < temp_norm.size()) out_normals.push_back(temp_norm[key.n]);
-            else out_normals.push_back(glm::vec3(0.0f, 0.0f, 1.0f));
-            out_indices.push_back(newIndex);
+        for (size_t i = tri * 3; i < tri * 3 + 3; ++i) {
+            const int kp = (int)pos_idx[i], kt = (int)uv_idx[i], kn = (int)norm_idx[i];
+            const uint64_t key = ((uint64_t)(uint32_t)kp * 1000003u + (uint32_t)kt) * 1000003u + (uint32_t)kn;
+            size_t h = (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & tableMask;
+            while (table[h].vertex != emptySlot && !(table[h].p == kp && table[h].t == kt && table[h].n == kn)) {
+                h = (h + 1) & tableMask;
+            }
+            if (table[h].vertex != emptySlot) {
+                out.indices.push_back(table[h].vertex);
+            } else {
+                unsigned int newIndex = (unsigned int)out.positions.size();
+                table[h] = Slot{ kp, kt, kn, newIndex };
+                out.positions.push_back(temp_pos[kp]);
+                if (!temp_norm.empty() && (size_t)kn < temp_norm.size()) out.normals.push_back(temp_norm[kn]);
+                else out.normals.push_back(glm::vec3(0.0f, 0.0f, 1.0f));
+                if (kt >= 0 && (size_t)kt < temp_uv.size()) out.texcoords.push_back(temp_uv[kt]);
+                else out.texcoords.push_back(glm::vec2(0.0f));
+                out.indices.push_back(newIndex);
+            }
         }
     }
 
+    mark_stage(options, "sort");
+    sort_triangles_by_material(out, keptMaterial);
+    load_material_textures(out, options);
+
     if (progress) progress->store(1.0f);
     return true;
 }
@@ -368,3 +1469,9 @@ bool load_model_simple(const std::string& path,
 {
     return Loader::load_model_simple(path, out_positions, out_normals, out_indices, progress);
 }
+
+bool load_model(const std::string& path, MeshData& out, std::atomic<float>* progress,
+                const LoadOptions& options)
+{
+    return Loader::load_model(path, out, progress, options);
+}
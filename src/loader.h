@@ -3,8 +3,168 @@
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
-#include <future>
+#include <stdexcept>
+#include <functional>
+#include <cstdint>
+
+#include "textures.h"
+#include "pointcloud.h"
+#include "task.h"
+
+// Surface description parsed from .mtl files or Assimp materials
+struct Material {
+    std::string name;
+    glm::vec3 diffuse = glm::vec3(0.8f);
+    float opacity = 1.0f;
+    std::string diffuseMap;   // resolved path, empty when untextured
+    int textureIndex = -1;    // into MeshData::textures, -1 when untextured
+};
+
+// Contiguous range of MeshData::indices drawn with one material
+struct MaterialBatch {
+    unsigned int materialIndex = 0;
+    unsigned int firstIndex = 0;
+    unsigned int indexCount = 0;
+    bool cullBackfaces = false; // every triangle belongs to a closed, outward-facing manifold
+};
+
+// Flat shading drops per-vertex normals: vertices dedup on position/uv only and the fragment
+// shader derives face normals from dFdx/dFdy, pointing to the side the winding faces. Auto enables
+// it when every source normal already is that face normal, so the result is identical to smooth
+// rendering; On also replaces normals that point against their triangle's winding.
+enum class FlatShading {
+    Off,
+    Auto,
+    On
+};
+
+// Loader knobs, built from UserSettings by the app
+struct LoadOptions {
+    FlatShading flatShading = FlatShading::Auto;
+    bool atlasSmallTextures = false;  // pack small material textures into shared atlas pages
+    int atlasMaxTextureSize = 256;    // textures up to this size (both dims) are atlas candidates
+    int atlasPageSize = 2048;
+    int atlasGutter = 8;              // power of two; also the number of mip-safe levels (log2)
+    float weldTolerance = 0.0f;       // merge positions closer than this (model units), 0 disables
+    float featureAngle = 30.0f;       // dihedral angle (degrees) above which an edge is a crease
+    bool reuseScratch = true;         // keep large loader temporaries pooled between loads
+    bool hugePageScratch = false;     // back pooled blocks >= 2 MiB with transparent huge pages
+    bool streamObjAttributes = false; // OBJ v/vt/vn lines through istringstream, for --bench-load
+    std::string textureCacheDir;      // BC1/BC3 cache location, empty disables the cache
+    // called on the loading thread as each stage starts ("parse", "dedup", "textures", "weld", ...)
+    // and with nullptr when the load ends, so benchmarks can attribute counters to stages
+    std::function<void(const char* stage)> onStage;
+};
+
+// What the atlas pass did; binds count texture changes in batch draw order
+struct AtlasReport {
+    bool built = false;
+    unsigned int texturesPacked = 0;
+    unsigned int pages = 0;
+    unsigned int batchesBefore = 0, batchesAfter = 0;
+    unsigned int bindsBefore = 0, bindsAfter = 0;
+};
+
+// Texture cache activity for one load; stores finish in the background after the load returns
+struct TextureCacheReport {
+    unsigned int hits = 0;
+    unsigned int queued = 0;
+};
+
+// Welding pass: positions snapped onto a neighbour within tolerance, vertex count before/after dedup
+struct WeldReport {
+    bool applied = false;
+    size_t positionsMerged = 0;
+    size_t normalsSmoothed = 0;     // averaged with close normals of their weld cluster
+    size_t verticesBefore = 0, verticesAfter = 0;
+};
+
+// What the cleanup pass removed. Invalid triangles reference vertices the file never defined.
+struct CleanupReport {
+    size_t invalidTriangles = 0;
+    size_t degenerateTriangles = 0;
+    size_t duplicateTriangles = 0;
+    size_t unusedVertices = 0;
+};
+
+// Winding pass: closed components were turned outward and their triangles may be culled
+struct OrientationReport {
+    size_t components = 0;
+    size_t closedComponents = 0;
+    size_t nonOrientableComponents = 0;
+    size_t flippedTriangles = 0;
+    size_t cullableTriangles = 0;
+    size_t boundaryEdges = 0;
+    size_t nonManifoldEdges = 0;
+};
+
+// Connectivity of the final mesh (half-edge build over welded positions)
+struct TopologyReport {
+    size_t edges = 0;
+    size_t boundaryEdges = 0;
+    size_t nonManifoldEdges = 0;
+    size_t components = 0;
+    size_t featureEdges = 0;   // creases + boundaries + non-manifold
+};
+
+struct FlatShadingReport {
+    bool lossless = false;        // every corner normal matched its face normal
+    bool applied = false;
+    size_t verticesBefore = 0, verticesAfter = 0;
+};
+
+// Wall-clock split of one load; parse is everything outside the texture and post-process stages.
+// pageFaults counts the whole process while the load ran (other threads included).
+struct LoadTimings {
+    double totalSeconds = 0.0;
+    double parseSeconds = 0.0;
+    double textureSeconds = 0.0;
+    double postSeconds = 0.0;
+    uint64_t pageFaults = 0;
+};
+
+// Everything a load produces. Indices are sorted by material so each batch is one range.
+struct MeshData {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;     // empty when flatShaded
+    std::vector<glm::vec2> texcoords;   // same length as positions (zeros when the source has none)
+    std::vector<unsigned int> indices;
+    std::vector<Material> materials;    // always at least one entry once loaded
+    std::vector<MaterialBatch> batches;
+    std::vector<TextureImage> textures;
+
+    bool flatShaded = false;
+
+    // GL_LINES pairs for the wireframe, one per edge; the first featureLineCount indices are
+    // the feature edges (boundaries, non-manifold edges and creases)
+    std::vector<unsigned int> edgeLines;
+    size_t featureLineCount = 0;
+
+    // (opposite A, v0, v1, opposite B) per edge for the GPU silhouette pass, B == A on open edges
+    std::vector<unsigned int> silhouetteEdges;
+
+    // point cloud files (.xyz, .pts, .ply without faces) fill this instead of the triangle arrays
+    PointCloud points;
+
+    AtlasReport atlasReport;
+    TextureCacheReport cacheReport;
+    FlatShadingReport flatReport;
+    WeldReport weldReport;
+    CleanupReport cleanupReport;
+    OrientationReport orientReport;
+    TopologyReport topologyReport;
+    LoadTimings timings;
+
+    void clear();
+};
+
+bool load_model(const std::string& path, MeshData& out, std::atomic<float>* progress,
+                const LoadOptions& options = LoadOptions());
+
+// number of texture binds Renderer::drawModelBatches needs for this batch order
+unsigned int count_texture_binds(const MeshData& mesh);
 
 bool load_model_simple(const std::string& path,
                        std::vector<glm::vec3>& out_positions,
@@ -12,43 +172,70 @@ bool load_model_simple(const std::string& path,
                        std::vector<unsigned int>& out_indices,
                        std::atomic<float>* progress);
 
-// Loader class declared here, defined in loader.cpp
+// One finished load as handed to the Loader handler on the render thread; mesh is null when !ok
+struct LoadResult {
+    uint64_t ticket = 0;
+    std::string path;
+    bool ok = false;
+    std::unique_ptr<MeshData> mesh;
+};
+
+// Failed parse or unreadable file, thrown out of Loader::load
+struct LoadError : std::runtime_error {
+    explicit LoadError(const std::string& path) : std::runtime_error("Load failed: " + path) {}
+};
+
+// Load service shared by the startup load and every import. Each request is a coroutine: the
+// parse runs on the thread pool, then the pipeline resumes on the main executor (drained by the
+// frame loop) and hands its LoadResult to the handler. A newer request cancels older ones still
+// in flight; their results are dropped when they get back to the main thread.
+// Everything except load()'s pool leg is render-thread only.
 struct Loader {
-    std::shared_ptr<std::vector<glm::vec3>> positions_ptr;
-    std::shared_ptr<std::vector<glm::vec3>> normals_ptr;
-    std::shared_ptr<std::vector<unsigned int>> indices_ptr;
+    explicit Loader(MainExecutor& main);
+    ~Loader(); // cancels loads in flight and waits for them
 
-    std::future<void> initialLoader;
+    // receives every result that was not superseded, on the main thread
+    void setHandler(std::function<void(LoadResult&)> handle) { handle_ = std::move(handle); }
 
-    // import state
-    std::future<void> importLoaderFuture;
-    std::shared_ptr<std::vector<glm::vec3>> import_positions_ptr;
-    std::shared_ptr<std::vector<glm::vec3>> import_normals_ptr;
-    std::shared_ptr<std::vector<unsigned int>> import_indices_ptr;
-    std::shared_ptr<std::atomic<bool>> import_ready;
-    std::shared_ptr<std::atomic<bool>> import_failed;
-    std::shared_ptr<std::atomic<float>> import_progress;
+    // start loading path in the background, returns its ticket
+    uint64_t request(const std::string& path, const LoadOptions& options);
 
-    std::atomic<bool> modelReady{false};
-    std::atomic<bool> modelLoadFailed{false};
-    std::atomic<float> loadProgress{0.0f};
+    // Awaitable load: parses on the pool and resumes on the main executor. Throws LoadError on
+    // failure and TaskCancelled if `cancel` fired in the meantime.
+    Task<std::unique_ptr<MeshData>> load(std::string path, LoadOptions options,
+                                         std::atomic<float>* progress, CancelToken cancel);
 
-    Loader();
-    ~Loader();
+    // a load is still running or its result has not reached the main thread
+    bool busy() const { return !jobs_.empty(); }
 
-    void startInitialLoad(const std::string& model_path);
-    void requestImportAsync(const std::string& path);
-    bool maybeFinishImport();
+    // progress of the latest request, 0..1
+    float progress() const;
 
-    std::shared_ptr<std::vector<glm::vec3>> positions() const { return positions_ptr; }
-    std::shared_ptr<std::vector<glm::vec3>> normals() const { return normals_ptr; }
-    std::shared_ptr<std::vector<unsigned int>> indices() const { return indices_ptr; }
+    // read path into the OS file cache on a pool worker, so a load requested shortly after
+    // parses from memory (startup issues this before the window exists)
+    static void prefetch(const std::string& path);
 
-    std::shared_ptr<std::atomic<float>> currentImportProgress() const { return import_progress; }
+    static bool load_model(const std::string& path, MeshData& out,
+                           std::atomic<float>* progress = nullptr,
+                           const LoadOptions& options = LoadOptions());
 
     static bool load_model_simple(const std::string& path,
                                   std::vector<glm::vec3>& out_positions,
                                   std::vector<glm::vec3>& out_normals,
                                   std::vector<unsigned int>& out_indices,
                                   std::atomic<float>* progress = nullptr);
+
+private:
+    struct Job {
+        uint64_t ticket = 0;
+        std::atomic<float> progress{0.0f};
+        CancelToken cancel;
+    };
+
+    Task<void> pipeline(Job* job, std::string path, LoadOptions options);
+
+    MainExecutor& main_;
+    std::function<void(LoadResult&)> handle_;
+    std::vector<std::unique_ptr<Job>> jobs_; // in flight or not back on the main thread yet
+    uint64_t latestTicket_ = 0;
 };
@@ -1,7 +1,14 @@
 // main.cpp
 #include "app.h"
+#include "bench.h"
+
+#include <cstring>
 
 int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--bench-load") == 0) return run_load_benchmark(argc, argv);
+    if (argc > 1 && std::strcmp(argv[1], "--bench-kernels") == 0) return run_kernel_benchmark(argc, argv);
+    if (argc > 1 && std::strcmp(argv[1], "--inspect") == 0) return run_library_inspection(argc, argv);
+
     App app(argc, argv);
     return app.run();
 }
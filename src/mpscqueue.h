@@ -0,0 +1,52 @@
+#pragma once
+
+// mpscqueue.h
+// Unbounded lock-free multi-producer / single-consumer queue for move-only values.
+
+#include <atomic>
+#include <utility>
+
+// Linked list with a stub node (Vyukov): producers swap themselves in as the head with one
+// atomic exchange, the single consumer walks from the tail. push never blocks; pop returns false
+// when empty, and also for the instant between a producer's exchange and its link store.
+template <class T>
+class MpscQueue {
+public:
+    MpscQueue() : head_(new Node()), tail_(head_.load(std::memory_order_relaxed)) {}
+    ~MpscQueue() {
+        T discard;
+        while (pop(discard)) {}
+        delete tail_;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // any thread
+    void push(T&& value) {
+        Node* node = new Node(std::move(value));
+        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // consumer thread only
+    bool pop(T& out) {
+        Node* next = tail_->next.load(std::memory_order_acquire);
+        if (!next) return false;
+        out = std::move(next->value);
+        delete tail_;
+        tail_ = next; // next becomes the new stub
+        return true;
+    }
+
+private:
+    struct Node {
+        Node() = default;
+        explicit Node(T&& v) : value(std::move(v)) {}
+        std::atomic<Node*> next{nullptr};
+        T value{};
+    };
+
+    std::atomic<Node*> head_;
+    Node* tail_;
+};
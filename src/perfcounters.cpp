@@ -0,0 +1,176 @@
+// perfcounters.cpp
+// Implements PerfCounters declared in perfcounters.h
+
+#include "perfcounters.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+#if defined(__linux__)
+  #include <dirent.h>
+  #include <linux/perf_event.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+const char* perf_event_name(PerfEvent e)
+{
+    switch (e) {
+    case PerfEvent::Cycles:       return "cycles";
+    case PerfEvent::Instructions: return "instructions";
+    case PerfEvent::LlcMisses:    return "LLC misses";
+    case PerfEvent::BranchMisses: return "branch misses";
+    case PerfEvent::PageFaults:   return "page faults";
+    }
+    return "?";
+}
+
+PerfValues& PerfValues::operator+=(const PerfValues& o)
+{
+    for (int i = 0; i < kPerfEventCount; ++i) count[i] += o.count[i];
+    return *this;
+}
+
+PerfValues PerfValues::operator-(const PerfValues& o) const
+{
+    PerfValues d;
+    for (int i = 0; i < kPerfEventCount; ++i) d.count[i] = count[i] > o.count[i] ? count[i] - o.count[i] : 0;
+    return d;
+}
+
+bool PerfValues::any() const
+{
+    return std::any_of(std::begin(count), std::end(count), [](uint64_t c) { return c != 0; });
+}
+
+double PerfValues::ipc() const
+{
+    const uint64_t cycles = (*this)[PerfEvent::Cycles];
+    return cycles ? double((*this)[PerfEvent::Instructions]) / double(cycles) : 0.0;
+}
+
+PerfCounters::~PerfCounters()
+{
+    close();
+}
+
+#if defined(__linux__)
+
+static int open_event(PerfEvent e, int tid)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    switch (e) {
+    case PerfEvent::Cycles:       attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+    case PerfEvent::Instructions: attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+    case PerfEvent::LlcMisses:    attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+    case PerfEvent::BranchMisses: attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+    case PerfEvent::PageFaults:   attr.type = PERF_TYPE_SOFTWARE; attr.config = PERF_COUNT_SW_PAGE_FAULTS; break;
+    }
+    // user space only: allowed at perf_event_paranoid 2, the common default
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, (pid_t)tid, -1, -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+static std::vector<int> process_thread_ids()
+{
+    std::vector<int> tids;
+    DIR* dir = opendir("/proc/self/task");
+    if (!dir) return tids;
+    while (dirent* entry = readdir(dir)) {
+        const int tid = std::atoi(entry->d_name);
+        if (tid > 0) tids.push_back(tid);
+    }
+    closedir(dir);
+    std::sort(tids.begin(), tids.end());
+    return tids;
+}
+
+bool PerfCounters::open()
+{
+    close();
+    int firstErrno = 0;
+    for (int tid : process_thread_ids()) {
+        ThreadFds t;
+        t.tid = tid;
+        bool anyOpen = false;
+        for (int e = 0; e < kPerfEventCount; ++e) {
+            t.fd[e] = open_event((PerfEvent)e, tid);
+            if (t.fd[e] >= 0) {
+                opened_[e] = anyOpen = true;
+            } else if (!firstErrno) {
+                firstErrno = errno;
+            }
+        }
+        if (anyOpen) threads_.push_back(t);
+    }
+
+    if (threads_.empty()) {
+        status_ = std::string("perf_event_open failed: ") + std::strerror(firstErrno ? firstErrno : ENOENT);
+        if (firstErrno == EACCES || firstErrno == EPERM) status_ += " (perf_event_paranoid, or seccomp in a container)";
+        return false;
+    }
+    status_ = std::to_string(threads_.size()) + " threads";
+    for (int e = 0; e < kPerfEventCount; ++e) {
+        if (!opened_[e]) status_ += std::string(", no ") + perf_event_name((PerfEvent)e);
+    }
+    return true;
+}
+
+void PerfCounters::close()
+{
+    for (ThreadFds& t : threads_) {
+        for (int& fd : t.fd) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+    }
+    threads_.clear();
+    std::fill(std::begin(opened_), std::end(opened_), false);
+}
+
+std::vector<PerfThreadValues> PerfCounters::read() const
+{
+    std::vector<PerfThreadValues> out;
+    out.reserve(threads_.size());
+    for (const ThreadFds& t : threads_) {
+        PerfThreadValues v;
+        v.tid = t.tid;
+        for (int e = 0; e < kPerfEventCount; ++e) {
+            uint64_t data[3] = {}; // value, time enabled, time running
+            if (t.fd[e] < 0 || ::read(t.fd[e], data, sizeof(data)) != (ssize_t)sizeof(data)) continue;
+            // multiplexed: scale by the share of time the event was on the PMU
+            if (data[2] > 0 && data[2] < data[1]) data[0] = uint64_t(double(data[0]) * double(data[1]) / double(data[2]));
+            v.values.count[e] = data[0];
+        }
+        out.push_back(v);
+    }
+    return out;
+}
+
+#else
+
+bool PerfCounters::open()
+{
+    status_ = "hardware counters need Linux perf_event_open";
+    return false;
+}
+
+void PerfCounters::close()
+{
+    threads_.clear();
+}
+
+std::vector<PerfThreadValues> PerfCounters::read() const
+{
+    return {};
+}
+
+#endif
@@ -0,0 +1,67 @@
+#pragma once
+
+// perfcounters.h
+// Hardware performance counters (Linux perf_event_open) per thread, for the loader benchmark.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class PerfEvent {
+    Cycles,
+    Instructions,
+    LlcMisses,      // generic cache-misses event, the last level cache on most PMUs
+    BranchMisses,
+    PageFaults      // software event, usually available even where the PMU is not
+};
+constexpr int kPerfEventCount = 5;
+
+const char* perf_event_name(PerfEvent e);
+
+// One reading or a difference of two. Counts are scaled up when the kernel multiplexed an event.
+struct PerfValues {
+    uint64_t count[kPerfEventCount] = {};
+
+    uint64_t operator[](PerfEvent e) const { return count[(int)e]; }
+    PerfValues& operator+=(const PerfValues& o);
+    PerfValues operator-(const PerfValues& o) const;  // clamps at zero
+    bool any() const;
+    double ipc() const;   // instructions per cycle, 0 without cycles
+};
+
+struct PerfThreadValues {
+    int tid = 0;
+    PerfValues values;
+};
+
+// Counts user-space events of every thread the process has when open() runs (start the thread pool
+// first); threads created later are not counted. Each event is opened on its own, so a container
+// or VM without PMU access still gets page faults, and events that failed read as zero.
+class PerfCounters {
+public:
+    PerfCounters() = default;
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // false when no event could be opened at all; status() says why
+    bool open();
+    void close();
+
+    bool available() const { return !threads_.empty(); }
+    bool has(PerfEvent e) const { return opened_[(int)e]; }
+    const std::string& status() const { return status_; }
+
+    // running totals of each counted thread, in the order they were opened
+    std::vector<PerfThreadValues> read() const;
+
+private:
+    struct ThreadFds {
+        int tid = 0;
+        int fd[kPerfEventCount] = { -1, -1, -1, -1, -1 };
+    };
+    std::vector<ThreadFds> threads_;
+    bool opened_[kPerfEventCount] = {};
+    std::string status_;
+};
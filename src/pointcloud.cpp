@@ -0,0 +1,733 @@
+// pointcloud.cpp
+// Implements the point cloud loader and octree declared in pointcloud.h
+
+#include "pointcloud.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#include "geomkernels.h"
+#include "threadpool.h"
+
+static const size_t kBlockBytes = size_t(64) << 20;   // file bytes per parse round
+static const int kCodeBits = 21;                       // per axis in the Morton code
+static const int kGridBits = 6;                        // node subsample grid, 64^3 cells
+static const int kMaxLevel = kCodeBits - kGridBits;    // deepest node, keeps whatever is left
+static const uint32_t kLeafPoints = 16384;             // nodes this small keep all their points
+static const int kBinBits = 12;                        // radix pass on the top 4 levels
+static const uint32_t kUnassigned = std::numeric_limits<uint32_t>::max();
+static const float kTargetSize = 10.0f;                // same as Assimp imports
+
+void PointCloud::clear()
+{
+    positions.clear();
+    colors.clear();
+    nodes.clear();
+    hasColor = false;
+    depth = 0;
+    skippedLines = 0;
+    buildSeconds = 0.0;
+}
+
+static std::string ext_lower(const std::string& path)
+{
+    std::string s = std::filesystem::path(path).extension().string();
+    for (char& c : s) c = (char)std::tolower((unsigned char)c);
+    return s;
+}
+
+static uint32_t pack_rgb(double r, double g, double b)
+{
+    auto c = [](double v) { return (uint32_t)std::clamp(v + 0.5, 0.0, 255.0); };
+    return c(r) | (c(g) << 8) | (c(b) << 16) | 0xff000000u;
+}
+
+// ---- PLY header ----
+
+enum class PlyType { None, I8, U8, I16, U16, I32, U32, F32, F64 };
+
+static PlyType ply_type(const std::string& s)
+{
+    if (s == "char" || s == "int8") return PlyType::I8;
+    if (s == "uchar" || s == "uint8") return PlyType::U8;
+    if (s == "short" || s == "int16") return PlyType::I16;
+    if (s == "ushort" || s == "uint16") return PlyType::U16;
+    if (s == "int" || s == "int32") return PlyType::I32;
+    if (s == "uint" || s == "uint32") return PlyType::U32;
+    if (s == "float" || s == "float32") return PlyType::F32;
+    if (s == "double" || s == "float64") return PlyType::F64;
+    return PlyType::None;
+}
+
+static size_t ply_type_size(PlyType t)
+{
+    switch (t) {
+    case PlyType::I8: case PlyType::U8: return 1;
+    case PlyType::I16: case PlyType::U16: return 2;
+    case PlyType::I32: case PlyType::U32: case PlyType::F32: return 4;
+    case PlyType::F64: return 8;
+    case PlyType::None: break;
+    }
+    return 0;
+}
+
+// x, y, z, r, g, b of a vertex: ASCII column or binary byte offset, with the binary type
+struct PointLayout {
+    int at[6] = { 0, 1, 2, -1, -1, -1 };
+    PlyType type[6] = {};
+    double colorScale = 1.0;    // 255 for 0..1 float colours
+    bool hasColor() const { return at[3] >= 0 && at[4] >= 0 && at[5] >= 0; }
+    // ASCII tokens read per line: up to the last one used, the rest of the line is ignored
+    int columns() const {
+        int n = 0;
+        for (int i = 0; i < 6; ++i) n = std::max(n, at[i] + 1);
+        return n;
+    }
+};
+
+struct PlyHeader {
+    enum Format { Ascii, BinaryLE, BinaryBE } format = Ascii;
+    size_t vertexCount = 0;
+    size_t faceCount = 0;
+    bool vertexFirst = false;
+    bool vertexHasList = false;
+    size_t dataOffset = 0;      // first byte after end_header
+    size_t stride = 0;          // binary vertex record size
+    PointLayout layout;
+};
+
+static bool read_ply_header(const std::string& path, PlyHeader& h)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::string line;
+    if (!std::getline(in, line) || line.rfind("ply", 0) != 0) return false;
+    std::string element;
+    int column = 0;
+    size_t offset = 0;
+    bool firstElement = true;
+    bool sawX = false, sawY = false, sawZ = false;
+    h.layout = PointLayout{};
+    for (int i = 0; i < 6; ++i) h.layout.at[i] = -1;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::istringstream ls(line);
+        std::string word;
+        ls >> word;
+        if (word == "end_header") {
+            h.dataOffset = (size_t)in.tellg();
+            h.stride = offset;
+            return sawX && sawY && sawZ && h.vertexFirst;
+        }
+        if (word == "format") {
+            std::string f;
+            ls >> f;
+            if (f == "ascii") h.format = PlyHeader::Ascii;
+            else if (f == "binary_little_endian") h.format = PlyHeader::BinaryLE;
+            else if (f == "binary_big_endian") h.format = PlyHeader::BinaryBE;
+            else return false;
+        } else if (word == "element") {
+            size_t count = 0;
+            ls >> element >> count;
+            if (element == "vertex") {
+                h.vertexCount = count;
+                h.vertexFirst = firstElement;
+            } else if (element == "face") {
+                h.faceCount = count;
+            }
+            firstElement = false;
+        } else if (word == "property" && element == "vertex") {
+            std::string type, name;
+            ls >> type;
+            if (type == "list") {
+                h.vertexHasList = true;
+                continue;
+            }
+            ls >> name;
+            const PlyType t = ply_type(type);
+            if (t == PlyType::None) {
+                std::cerr << "point cloud: unknown PLY property type '" << type << "' in " << path << "\n";
+                return false;
+            }
+            int slot = -1;
+            if (name == "x") { slot = 0; sawX = true; }
+            else if (name == "y") { slot = 1; sawY = true; }
+            else if (name == "z") { slot = 2; sawZ = true; }
+            else if (name == "red" || name == "r" || name == "diffuse_red") slot = 3;
+            else if (name == "green" || name == "g" || name == "diffuse_green") slot = 4;
+            else if (name == "blue" || name == "b" || name == "diffuse_blue") slot = 5;
+            if (slot >= 0) {
+                h.layout.at[slot] = h.format == PlyHeader::Ascii ? column : (int)offset;
+                h.layout.type[slot] = t;
+                if (slot >= 3 && (t == PlyType::F32 || t == PlyType::F64)) h.layout.colorScale = 255.0;
+            }
+            ++column;
+            offset += ply_type_size(t);
+        }
+    }
+    return false;
+}
+
+bool is_point_cloud_file(const std::string& path)
+{
+    const std::string ext = ext_lower(path);
+    if (ext == ".xyz" || ext == ".pts") return true;
+    if (ext != ".ply") return false;
+    PlyHeader h;
+    return read_ply_header(path, h) && h.faceCount == 0 && h.vertexCount > 0;
+}
+
+// ---- ASCII ----
+
+static inline bool is_separator(char c) { return c == ' ' || c == '\t' || c == ',' || c == ';'; }
+
+// first `count` numbers of a line; false when the line is shorter or not numeric
+static bool parse_numbers(const char* s, const char* end, int count, double* out)
+{
+    for (int i = 0; i < count; ++i) {
+        while (s < end && is_separator(*s)) ++s;
+        if (s < end && *s == '+') ++s;
+        const std::from_chars_result r = std::from_chars(s, end, out[i]);
+        if (r.ec != std::errc()) return false;
+        s = r.ptr;
+        if (s < end && !is_separator(*s) && *s != '\r') return false;
+    }
+    return true;
+}
+
+static int count_tokens(const char* s, const char* end, bool& integers)
+{
+    int n = 0;
+    integers = true;
+    while (s < end) {
+        while (s < end && (is_separator(*s) || *s == '\r')) ++s;
+        if (s >= end) break;
+        const char* t = s;
+        while (s < end && !is_separator(*s) && *s != '\r') ++s;
+        // colour columns are the 4th to 6th; their text decides between rgb and normals
+        if (n >= 3 && n < 6 && std::find_if(t, s, [](char c) { return c == '.' || c == 'e' || c == 'E' || c == '-'; }) != s) integers = false;
+        ++n;
+    }
+    return n;
+}
+
+static bool is_comment(const char* s, const char* end)
+{
+    while (s < end && is_separator(*s)) ++s;
+    return s >= end || *s == '\r' || *s == '#' || (*s == '/' && s + 1 < end && s[1] == '/');
+}
+
+// XYZ: x y z [r g b | nx ny nz | ...]; PTS: an optional count line, then x y z intensity r g b
+static bool sniff_ascii_layout(const char* s, const char* end, PointLayout& layout, const char*& dataStart)
+{
+    bool firstLine = true;
+    while (s < end) {
+        const char* eol = std::find(s, end, '\n');
+        if (!is_comment(s, eol)) {
+            bool integers = false;
+            const int n = count_tokens(s, eol, integers);
+            if (firstLine && n == 1) {  // PTS point count
+                s = eol + (eol < end);
+                firstLine = false;
+                continue;
+            }
+            if (n < 3) return false;
+            layout = PointLayout{};
+            if (n == 7) {
+                layout.at[3] = 4; layout.at[4] = 5; layout.at[5] = 6;
+            } else if (n >= 6 && integers) {
+                layout.at[3] = 3; layout.at[4] = 4; layout.at[5] = 5;
+            }
+            dataStart = s;
+            return true;
+        }
+        firstLine = false;
+        s = eol + (eol < end);
+    }
+    return false;
+}
+
+struct ParsedPart {
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> colors;
+    size_t skipped = 0;
+};
+
+static void parse_ascii_lines(const char* s, const char* end, const PointLayout& layout, const double* origin,
+                              ParsedPart& out)
+{
+    std::vector<double> v(layout.columns());
+    const int columns = (int)v.size();
+    while (s < end) {
+        const char* eol = std::find(s, end, '\n');
+        if (!is_comment(s, eol)) {
+            if (parse_numbers(s, eol, columns, v.data())) {
+                out.positions.emplace_back(float(v[layout.at[0]] - origin[0]), float(v[layout.at[1]] - origin[1]),
+                                           float(v[layout.at[2]] - origin[2]));
+                if (layout.hasColor()) {
+                    out.colors.push_back(pack_rgb(v[layout.at[3]] * layout.colorScale, v[layout.at[4]] * layout.colorScale,
+                                                  v[layout.at[5]] * layout.colorScale));
+                }
+            } else {
+                ++out.skipped;
+            }
+        }
+        s = eol + (eol < end);
+    }
+}
+
+// Reads kBlockBytes at a time; each block is cut at line ends into one part per pool chunk and
+// parsed in parallel, then appended in file order. maxPoints stops early (ASCII PLY vertex count).
+static bool parse_ascii_points(const std::string& path, size_t dataOffset, const PointLayout* plyLayout,
+                               size_t maxPoints, PointCloud& out, double* origin, std::atomic<float>* progress)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    in.seekg(0, std::ios::end);
+    const double fileSize = std::max(1.0, (double)in.tellg());
+    in.seekg((std::streamoff)dataOffset);
+
+    ThreadPool& pool = globalThreadPool();
+    PointLayout layout;
+    if (plyLayout) layout = *plyLayout;
+    bool sniffed = plyLayout != nullptr;
+    bool haveOrigin = false;
+    std::vector<char> buf;
+    size_t carry = 0;
+    size_t consumed = dataOffset;
+    bool eof = false;
+    while (!eof && out.positions.size() < maxPoints) {
+        buf.resize(carry + kBlockBytes);
+        in.read(buf.data() + carry, (std::streamsize)kBlockBytes);
+        const size_t got = carry + (size_t)in.gcount();
+        eof = !in;
+        size_t blockEnd = got;
+        if (!eof) {
+            // a line longer than a whole block is parsed cut in two, and most likely skipped
+            const char* lastNl = nullptr;
+            for (size_t i = got; i-- > 0;) if (buf[i] == '\n') { lastNl = buf.data() + i; break; }
+            if (lastNl) blockEnd = size_t(lastNl - buf.data()) + 1;
+        }
+        const char* begin = buf.data();
+        const char* end = buf.data() + blockEnd;
+        if (!sniffed) {
+            if (!sniff_ascii_layout(begin, end, layout, begin)) {
+                std::cerr << "point cloud: no x y z columns in " << path << "\n";
+                return false;
+            }
+            sniffed = true;
+        }
+        if (!haveOrigin) {
+            // first parsable point: coordinates are stored relative to it so large (georeferenced)
+            // values keep their precision in floats
+            std::vector<double> v(layout.columns());
+            for (const char* s = begin; s < end;) {
+                const char* eol = std::find(s, end, '\n');
+                if (!is_comment(s, eol) && parse_numbers(s, eol, (int)v.size(), v.data())) {
+                    origin[0] = v[layout.at[0]]; origin[1] = v[layout.at[1]]; origin[2] = v[layout.at[2]];
+                    haveOrigin = true;
+                    break;
+                }
+                s = eol + (eol < end);
+            }
+        }
+
+        if (haveOrigin) {
+            const size_t parts = std::max<size_t>(1, std::min<size_t>(size_t(pool.size()) * 4, size_t(end - begin) / 65536 + 1));
+            std::vector<const char*> cuts(parts + 1, end);
+            cuts[0] = begin;
+            for (size_t p = 1; p < parts; ++p) {
+                const char* c = begin + size_t(end - begin) * p / parts;
+                c = std::max(c, cuts[p - 1]);
+                c = std::find(c, end, '\n');
+                cuts[p] = c + (c < end);
+            }
+            std::vector<ParsedPart> parsed(parts);
+            pool.parallel_for(0, parts, 1, [&](size_t b, size_t e) {
+                for (size_t p = b; p < e; ++p) parse_ascii_lines(cuts[p], cuts[p + 1], layout, origin, parsed[p]);
+            });
+            for (ParsedPart& part : parsed) {
+                const size_t take = std::min(part.positions.size(), maxPoints - out.positions.size());
+                out.positions.insert(out.positions.end(), part.positions.begin(), part.positions.begin() + take);
+                if (layout.hasColor()) out.colors.insert(out.colors.end(), part.colors.begin(), part.colors.begin() + take);
+                out.skippedLines += part.skipped;
+            }
+        }
+
+        consumed += blockEnd - carry;
+        carry = got - blockEnd;
+        std::memmove(buf.data(), buf.data() + blockEnd, carry);
+        if (progress) progress->store(0.7f * float(double(consumed) / fileSize));
+    }
+    out.hasColor = layout.hasColor() && !out.colors.empty();
+    return !out.positions.empty();
+}
+
+// ---- binary PLY ----
+
+static double read_ply_value(const unsigned char* p, PlyType t, bool swap)
+{
+    unsigned char b[8];
+    const size_t n = ply_type_size(t);
+    if (swap) for (size_t i = 0; i < n; ++i) b[i] = p[n - 1 - i];
+    else std::memcpy(b, p, n);
+    switch (t) {
+    case PlyType::I8: { int8_t v; std::memcpy(&v, b, 1); return v; }
+    case PlyType::U8: return b[0];
+    case PlyType::I16: { int16_t v; std::memcpy(&v, b, 2); return v; }
+    case PlyType::U16: { uint16_t v; std::memcpy(&v, b, 2); return v; }
+    case PlyType::I32: { int32_t v; std::memcpy(&v, b, 4); return v; }
+    case PlyType::U32: { uint32_t v; std::memcpy(&v, b, 4); return v; }
+    case PlyType::F32: { float v; std::memcpy(&v, b, 4); return v; }
+    case PlyType::F64: { double v; std::memcpy(&v, b, 8); return v; }
+    case PlyType::None: break;
+    }
+    return 0.0;
+}
+
+static bool parse_binary_ply(const std::string& path, const PlyHeader& h, PointCloud& out, double* origin,
+                             std::atomic<float>* progress)
+{
+    const PointLayout& L = h.layout;
+    const bool swap = h.format == PlyHeader::BinaryBE;
+    if (h.vertexHasList || h.stride == 0) {
+        std::cerr << "point cloud: list properties on PLY vertices are not supported\n";
+        return false;
+    }
+    std::ifstream in(path, std::ios::binary);
+    in.seekg((std::streamoff)h.dataOffset);
+    const size_t perBlock = std::max<size_t>(1, kBlockBytes / h.stride);
+    std::vector<unsigned char> buf(std::min(perBlock, h.vertexCount) * h.stride);
+    out.positions.resize(h.vertexCount);
+    if (L.hasColor()) out.colors.resize(h.vertexCount);
+
+    size_t done = 0;
+    while (done < h.vertexCount) {
+        const size_t n = std::min(perBlock, h.vertexCount - done);
+        in.read((char*)buf.data(), (std::streamsize)(n * h.stride));
+        if ((size_t)in.gcount() != n * h.stride) {
+            std::cerr << "point cloud: " << path << " ends after " << done + (size_t)in.gcount() / h.stride << " of "
+                      << h.vertexCount << " vertices\n";
+            out.positions.resize(done + (size_t)in.gcount() / h.stride);
+            if (L.hasColor()) out.colors.resize(out.positions.size());
+            break;
+        }
+        if (done == 0) {
+            for (int a = 0; a < 3; ++a) origin[a] = read_ply_value(buf.data() + L.at[a], L.type[a], swap);
+        }
+        globalThreadPool().parallel_for(0, n, 16384, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                const unsigned char* rec = buf.data() + i * h.stride;
+                out.positions[done + i] = glm::vec3(float(read_ply_value(rec + L.at[0], L.type[0], swap) - origin[0]),
+                                                    float(read_ply_value(rec + L.at[1], L.type[1], swap) - origin[1]),
+                                                    float(read_ply_value(rec + L.at[2], L.type[2], swap) - origin[2]));
+                if (L.hasColor()) {
+                    out.colors[done + i] = pack_rgb(read_ply_value(rec + L.at[3], L.type[3], swap) * L.colorScale,
+                                                    read_ply_value(rec + L.at[4], L.type[4], swap) * L.colorScale,
+                                                    read_ply_value(rec + L.at[5], L.type[5], swap) * L.colorScale);
+                }
+            }
+        });
+        done += n;
+        if (progress) progress->store(0.7f * float(double(done) / double(h.vertexCount)));
+    }
+    out.hasColor = L.hasColor() && !out.colors.empty();
+    return !out.positions.empty();
+}
+
+// ---- after parsing ----
+
+// centre on the origin and scale the largest extent to kTargetSize
+static void normalise_points(PointCloud& cloud)
+{
+    Bounds3 b;
+    if (!geom_bounds(cloud.positions.data(), cloud.positions.size(), b)) return;
+    const glm::vec3 size = b.max - b.min;
+    const float maxDim = std::max(std::max(size.x, size.y), size.z);
+    const float scale = maxDim > 1e-12f ? kTargetSize / maxDim : 1.0f;
+    const glm::vec3 centre = (b.min + b.max) * 0.5f;
+    geom_scale_offset(cloud.positions.data(), cloud.positions.size(), glm::vec3(scale), -centre * scale);
+}
+
+// without colours: blue -> green -> red along the flattest axis, which is up for terrain scans
+static void ramp_colors(PointCloud& cloud)
+{
+    Bounds3 b;
+    if (!geom_bounds(cloud.positions.data(), cloud.positions.size(), b)) return;
+    const glm::vec3 size = b.max - b.min;
+    const int axis = size.x <= size.y && size.x <= size.z ? 0 : (size.y <= size.z ? 1 : 2);
+    const float lo = b.min[axis];
+    const float inv = size[axis] > 1e-12f ? 1.0f / size[axis] : 0.0f;
+    cloud.colors.resize(cloud.positions.size());
+    globalThreadPool().parallel_for(0, cloud.positions.size(), 65536, [&](size_t s, size_t e) {
+        for (size_t i = s; i < e; ++i) {
+            const double t = double((cloud.positions[i][axis] - lo) * inv);
+            cloud.colors[i] = pack_rgb(255.0 * std::clamp(2.0 * t - 1.0, 0.0, 1.0),
+                                       255.0 * (1.0 - std::abs(2.0 * t - 1.0)),
+                                       255.0 * std::clamp(1.0 - 2.0 * t, 0.0, 1.0));
+        }
+    });
+}
+
+bool load_point_cloud(const std::string& path, PointCloud& out, std::atomic<float>* progress)
+{
+    out.clear();
+    if (progress) progress->store(0.0f);
+    double origin[3] = { 0.0, 0.0, 0.0 };
+    bool ok = false;
+    if (ext_lower(path) == ".ply") {
+        PlyHeader h;
+        if (!read_ply_header(path, h)) {
+            std::cerr << "point cloud: unreadable PLY header (vertices must come first) in " << path << "\n";
+            return false;
+        }
+        if (h.vertexCount >= kUnassigned) {
+            std::cerr << "point cloud: " << h.vertexCount << " points is more than supported\n";
+            return false;
+        }
+        ok = h.format == PlyHeader::Ascii
+            ? parse_ascii_points(path, h.dataOffset, &h.layout, h.vertexCount, out, origin, progress)
+            : parse_binary_ply(path, h, out, origin, progress);
+    } else {
+        ok = parse_ascii_points(path, 0, nullptr, size_t(kUnassigned) - 1, out, origin, progress);
+    }
+    if (!ok) {
+        std::cerr << "point cloud: no points in " << path << "\n";
+        if (progress) progress->store(1.0f);
+        return false;
+    }
+    if (out.skippedLines) std::cerr << "point cloud: skipped " << out.skippedLines << " lines of " << path << "\n";
+
+    normalise_points(out);
+    if (!out.hasColor) ramp_colors(out);
+    build_point_octree(out, progress);
+    if (progress) progress->store(1.0f);
+    return true;
+}
+
+// ---- octree ----
+
+static inline uint64_t spread_bits(uint64_t v)
+{
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffull;
+    v = (v | v << 16) & 0x1f0000ff0000ffull;
+    v = (v | v << 8) & 0x100f00f00f00f00full;
+    v = (v | v << 4) & 0x10c30c30c30c30c3ull;
+    v = (v | v << 2) & 0x1249249249249249ull;
+    return v;
+}
+
+// Morton order (x lowest) of 21-bit cells in the root cube, so every octree node is one range
+static void morton_sort(PointCloud& cloud, const glm::vec3& lo, float size, std::vector<uint64_t>& codes)
+{
+    ThreadPool& pool = globalThreadPool();
+    const size_t n = cloud.positions.size();
+    const double cells = double(1u << kCodeBits);
+    const double toCell = cells / double(size);
+    std::vector<uint64_t> unsorted(n);
+    pool.parallel_for(0, n, 65536, [&](size_t s, size_t e) {
+        for (size_t i = s; i < e; ++i) {
+            uint64_t q[3];
+            for (int a = 0; a < 3; ++a) {
+                const double c = std::floor((double(cloud.positions[i][a]) - double(lo[a])) * toCell);
+                q[a] = (uint64_t)std::clamp(c, 0.0, cells - 1.0);
+            }
+            unsorted[i] = spread_bits(q[0]) | spread_bits(q[1]) << 1 | spread_bits(q[2]) << 2;
+        }
+    });
+
+    // counting pass on the top bits, then each bin sorted on its own (an MSD radix sort): bins
+    // are independent, which keeps the sort parallel and its temporaries small
+    const size_t bins = size_t(1) << kBinBits;
+    const int binShift = 3 * kCodeBits - kBinBits;
+    const size_t parts = std::max<size_t>(1, std::min<size_t>(size_t(pool.size()) * 4, n / 65536 + 1));
+    std::vector<size_t> counts(parts * bins, 0);
+    auto partRange = [&](size_t p) { return std::make_pair(n * p / parts, n * (p + 1) / parts); };
+    pool.parallel_for(0, parts, 1, [&](size_t pb, size_t pe) {
+        for (size_t p = pb; p < pe; ++p) {
+            const auto [s, e] = partRange(p);
+            for (size_t i = s; i < e; ++i) ++counts[p * bins + (unsorted[i] >> binShift)];
+        }
+    });
+    std::vector<size_t> binStart(bins + 1, 0);
+    {
+        size_t at = 0;
+        for (size_t b = 0; b < bins; ++b) {
+            binStart[b] = at;
+            for (size_t p = 0; p < parts; ++p) {
+                const size_t c = counts[p * bins + b];
+                counts[p * bins + b] = at;
+                at += c;
+            }
+        }
+        binStart[bins] = at;
+    }
+    std::vector<uint32_t> order(n);
+    pool.parallel_for(0, parts, 1, [&](size_t pb, size_t pe) {
+        for (size_t p = pb; p < pe; ++p) {
+            const auto [s, e] = partRange(p);
+            size_t* cursor = &counts[p * bins];
+            for (size_t i = s; i < e; ++i) order[cursor[unsorted[i] >> binShift]++] = (uint32_t)i;
+        }
+    });
+    pool.parallel_for(0, bins, 1, [&](size_t bb, size_t be) {
+        for (size_t b = bb; b < be; ++b) {
+            std::sort(order.begin() + binStart[b], order.begin() + binStart[b + 1],
+                      [&](uint32_t x, uint32_t y) { return unsorted[x] < unsorted[y] || (unsorted[x] == unsorted[y] && x < y); });
+        }
+    });
+
+    codes.resize(n);
+    std::vector<glm::vec3> positions(n);
+    std::vector<uint32_t> colors(cloud.colors.empty() ? 0 : n);
+    pool.parallel_for(0, n, 65536, [&](size_t s, size_t e) {
+        for (size_t i = s; i < e; ++i) {
+            codes[i] = unsorted[order[i]];
+            positions[i] = cloud.positions[order[i]];
+            if (!colors.empty()) colors[i] = cloud.colors[order[i]];
+        }
+    });
+    cloud.positions = std::move(positions);
+    cloud.colors = std::move(colors);
+}
+
+// Levels are built breadth-first, every node of a level in parallel. A node takes the middle point
+// of each occupied cell of its 64^3 grid that no ancestor took (a Morton run, since the points are
+// sorted); small or deepest nodes take everything left. Points then move into node order.
+void build_point_octree(PointCloud& cloud, std::atomic<float>* progress)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    ThreadPool& pool = globalThreadPool();
+    cloud.nodes.clear();
+    cloud.depth = 0;
+    const size_t n = cloud.positions.size();
+    Bounds3 b;
+    if (!geom_bounds(cloud.positions.data(), n, b)) return;
+    const glm::vec3 extent = b.max - b.min;
+    const float size = std::max(std::max(std::max(extent.x, extent.y), extent.z), 1e-6f) * 1.0001f;
+    const glm::vec3 lo = (b.min + b.max) * 0.5f - glm::vec3(size * 0.5f);
+
+    std::vector<uint64_t> codes;
+    morton_sort(cloud, lo, size, codes);
+    if (progress) progress->store(0.8f);
+
+    struct Range { size_t begin, end; };
+    std::vector<Range> ranges;          // per node, its whole cube in the sorted arrays
+    std::vector<uint32_t> assign(n, kUnassigned);
+
+    PointCloudNode root;
+    root.center = lo + glm::vec3(size * 0.5f);
+    root.halfSize = size * 0.5f;
+    cloud.nodes.push_back(root);
+    ranges.push_back({ 0, n });
+
+    struct Outcome {
+        uint32_t count = 0;
+        bool leaf = false;
+        Range child[8] = {};
+        bool hasChild[8] = {};
+    };
+    std::vector<uint32_t> level = { 0 };
+    while (!level.empty()) {
+        std::vector<Outcome> outcomes(level.size());
+        pool.parallel_for(0, level.size(), 1, [&](size_t lb, size_t le) {
+            for (size_t li = lb; li < le; ++li) {
+                const uint32_t id = level[li];
+                const int L = cloud.nodes[id].level;
+                const Range r = ranges[id];
+                Outcome& o = outcomes[li];
+                size_t left = 0;
+                for (size_t i = r.begin; i < r.end; ++i) left += assign[i] == kUnassigned;
+                if (left <= kLeafPoints || L >= kMaxLevel) {
+                    for (size_t i = r.begin; i < r.end; ++i) if (assign[i] == kUnassigned) assign[i] = id;
+                    o.count = (uint32_t)left;
+                    o.leaf = true;
+                    continue;
+                }
+                const int shift = 3 * (kCodeBits - L - kGridBits);
+                for (size_t i = r.begin; i < r.end;) {
+                    const uint64_t cell = codes[i] >> shift;
+                    size_t j = i, free = 0;
+                    for (; j < r.end && (codes[j] >> shift) == cell; ++j) free += assign[j] == kUnassigned;
+                    for (size_t k = i, seen = 0; k < j && free; ++k) {
+                        if (assign[k] != kUnassigned) continue;
+                        if (seen++ == free / 2) { assign[k] = id; ++o.count; break; }
+                    }
+                    i = j;
+                }
+                const int childShift = 3 * (kCodeBits - L - 1);
+                const uint64_t prefix = codes[r.begin] >> (childShift + 3);
+                for (int c = 0; c < 8; ++c) {
+                    const uint64_t first = ((prefix << 3) | uint64_t(c)) << childShift;
+                    const uint64_t last = first + (uint64_t(1) << childShift);
+                    const size_t cb = size_t(std::lower_bound(codes.begin() + r.begin, codes.begin() + r.end, first) - codes.begin());
+                    const size_t ce = size_t(std::lower_bound(codes.begin() + cb, codes.begin() + r.end, last) - codes.begin());
+                    o.child[c] = { cb, ce };
+                    o.hasChild[c] = std::any_of(assign.begin() + cb, assign.begin() + ce, [](uint32_t a) { return a == kUnassigned; });
+                }
+            }
+        });
+
+        // children get their indices in level order, which keeps the node array breadth-first
+        std::vector<uint32_t> next;
+        for (size_t li = 0; li < level.size(); ++li) {
+            const uint32_t id = level[li];
+            const Outcome& o = outcomes[li];
+            PointCloudNode& node = cloud.nodes[id];
+            const float cell = node.halfSize * 2.0f / float(1 << kGridBits);
+            node.count = o.count;
+            node.spacing = o.leaf ? std::min(cell, node.halfSize * 2.0f / std::sqrt(float(std::max(o.count, 1u)))) : cell;
+            cloud.depth = std::max(cloud.depth, (unsigned)node.level);
+            if (o.leaf) continue;
+            for (int c = 0; c < 8; ++c) {
+                if (!o.hasChild[c]) continue;
+                PointCloudNode child;
+                const PointCloudNode& parent = cloud.nodes[id];
+                child.halfSize = parent.halfSize * 0.5f;
+                child.center = parent.center + glm::vec3((c & 1) ? child.halfSize : -child.halfSize,
+                                                         (c & 2) ? child.halfSize : -child.halfSize,
+                                                         (c & 4) ? child.halfSize : -child.halfSize);
+                child.parent = (int32_t)id;
+                child.level = uint8_t(parent.level + 1);
+                const uint32_t childId = (uint32_t)cloud.nodes.size();
+                cloud.nodes[id].children[c] = (int32_t)childId;
+                cloud.nodes.push_back(child);
+                ranges.push_back(o.child[c]);
+                next.push_back(childId);
+            }
+        }
+        level = std::move(next);
+        if (progress) progress->store(std::min(0.95f, 0.8f + 0.01f * float(cloud.depth + 1)));
+    }
+
+    // node order: prefix sums give each node's first point, then each node gathers its own
+    uint32_t at = 0;
+    for (PointCloudNode& node : cloud.nodes) {
+        node.first = at;
+        at += node.count;
+    }
+    std::vector<glm::vec3> positions(n);
+    std::vector<uint32_t> colors(cloud.colors.empty() ? 0 : n);
+    pool.parallel_for(0, cloud.nodes.size(), 1, [&](size_t nb, size_t ne) {
+        for (size_t id = nb; id < ne; ++id) {
+            uint32_t k = cloud.nodes[id].first;
+            for (size_t i = ranges[id].begin; i < ranges[id].end; ++i) {
+                if (assign[i] != (uint32_t)id) continue;
+                positions[k] = cloud.positions[i];
+                if (!colors.empty()) colors[k] = cloud.colors[i];
+                ++k;
+            }
+        }
+    });
+    cloud.positions = std::move(positions);
+    cloud.colors = std::move(colors);
+    cloud.buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+// pointcloud.h
+// Vertex-only point clouds (ASCII XYZ/PTS, PLY without faces): block-wise parallel parsing and an
+// octree of per-node point subsets for level-of-detail rendering.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+// One octree cube. Its own points are a subsample of everything inside the cube (at most one per
+// cell of a 64^3 grid) and the rest lives in the children, so drawing a node and any subset of its
+// descendants never draws a point twice.
+struct PointCloudNode {
+    glm::vec3 center = glm::vec3(0.0f);
+    float halfSize = 0.0f;
+    float spacing = 0.0f;           // typical distance between the node's own points
+    uint32_t first = 0, count = 0;  // range of PointCloud::positions / colors
+    int32_t parent = -1;
+    int32_t children[8] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+    uint8_t level = 0;
+};
+
+// Positions are recentred and scaled to the same 10-unit size Assimp imports get. Points are grouped
+// by node, nodes are stored breadth-first (parents before children, nodes[0] the root), so a node's
+// points can be copied or streamed as one range.
+struct PointCloud {
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> colors;       // RGBA8, red in the low byte
+    std::vector<PointCloudNode> nodes;
+    bool hasColor = false;              // else colours ramp along the flattest axis (elevation for scans)
+    unsigned depth = 0;                 // levels below the root
+    size_t skippedLines = 0;            // ASCII lines that did not parse
+    double buildSeconds = 0.0;          // octree build, part of the load
+
+    bool empty() const { return positions.empty(); }
+    void clear();
+};
+
+// .xyz and .pts, or a .ply whose header declares no faces
+bool is_point_cloud_file(const std::string& path);
+
+// parse, normalise and build the octree; progress goes 0..1
+bool load_point_cloud(const std::string& path, PointCloud& out, std::atomic<float>* progress = nullptr);
+
+// (re)build nodes and reorder positions/colors; runs on the global thread pool
+void build_point_octree(PointCloud& cloud, std::atomic<float>* progress = nullptr);
@@ -0,0 +1,245 @@
+// pointsplat.cpp
+// Implements PointCloudRenderer declared in pointsplat.h
+
+#include "pointsplat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <utility>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include "renderer.h"
+#include "viewports.h"
+
+static const size_t kUploadPointsPerFrame = 2u << 20;  // 32 MB of vertex data
+
+static const char* splat_vs_src = R"GLSL(
+#version 330 core
+layout(location=0) in vec3 aPos;
+layout(location=1) in vec4 aColor;
+uniform mat4 uMVP;
+uniform float uSpacing;     // world units between points, times the size setting
+uniform float uProjScale;   // pixels per world unit at distance 1
+out vec3 vColor;
+void main(){
+    gl_Position = uMVP * vec4(aPos, 1.0);
+    gl_PointSize = clamp(uSpacing * uProjScale / max(gl_Position.w, 1e-4), 1.0, 64.0);
+    vColor = aColor.rgb;
+}
+)GLSL";
+
+static const char* splat_fs_src = R"GLSL(
+#version 330 core
+in vec3 vColor;
+out vec4 fragColor;
+void main(){
+    vec2 d = gl_PointCoord * 2.0 - 1.0;
+    if (dot(d, d) > 1.0) discard;
+    fragColor = vec4(vColor, 1.0);
+}
+)GLSL";
+
+bool PointCloudRenderer::init() {
+    GLuint vs = Renderer::compile_shader(GL_VERTEX_SHADER, splat_vs_src);
+    GLuint fs = Renderer::compile_shader(GL_FRAGMENT_SHADER, splat_fs_src);
+    if (!vs || !fs) {
+        if (vs) glDeleteShader(vs);
+        if (fs) glDeleteShader(fs);
+        return false;
+    }
+    prog_ = glCreateProgram();
+    glAttachShader(prog_, vs);
+    glAttachShader(prog_, fs);
+    glLinkProgram(prog_);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+    GLint ok = 0; glGetProgramiv(prog_, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        GLint len = 0; glGetProgramiv(prog_, GL_INFO_LOG_LENGTH, &len);
+        std::string log(len ? len : 1, '\0');
+        glGetProgramInfoLog(prog_, len, nullptr, &log[0]);
+        std::cerr << "Point splat program link error:\n" << log << "\n";
+        glDeleteProgram(prog_);
+        prog_ = 0;
+        return false;
+    }
+    mvp_loc_ = glGetUniformLocation(prog_, "uMVP");
+    spacing_loc_ = glGetUniformLocation(prog_, "uSpacing");
+    proj_scale_loc_ = glGetUniformLocation(prog_, "uProjScale");
+    return true;
+}
+
+void PointCloudRenderer::setCloud(std::shared_ptr<const PointCloud> cloud) {
+    release();
+    cloud_ = std::move(cloud);
+    if (!cloud_) return;
+    gpu_.assign(cloud_->nodes.size(), NodeGpu{});
+    drawnSlot_.assign(cloud_->nodes.size(), -1);
+    stats_.points = cloud_->positions.size();
+    stats_.nodes = cloud_->nodes.size();
+    stats_.depth = cloud_->depth;
+}
+
+void PointCloudRenderer::release() {
+    for (size_t i = 0; i < gpu_.size(); ++i) evict(i);
+    gpu_.clear();
+    drawnSlot_.clear();
+    drawList_.clear();
+    residentPoints_ = 0;
+    streamingLastFrame_ = false;
+    cloud_.reset();
+    stats_ = PointCloudStats{};
+}
+
+// interleaved position + RGBA8, 16 bytes a point
+bool PointCloudRenderer::upload(size_t node) {
+    const PointCloudNode& n = cloud_->nodes[node];
+    if (n.count == 0) return false;
+    struct SplatVertex { float x, y, z; uint32_t rgba; };
+    std::vector<SplatVertex> verts(n.count);
+    for (uint32_t i = 0; i < n.count; ++i) {
+        const glm::vec3& p = cloud_->positions[n.first + i];
+        verts[i] = { p.x, p.y, p.z, cloud_->colors.empty() ? 0xffc0c0c0u : cloud_->colors[n.first + i] };
+    }
+    NodeGpu& g = gpu_[node];
+    glGenVertexArrays(1, &g.vao);
+    glGenBuffers(1, &g.vbo);
+    glBindVertexArray(g.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, g.vbo);
+    glBufferData(GL_ARRAY_BUFFER, verts.size() * sizeof(SplatVertex), verts.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SplatVertex), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SplatVertex), (void*)(3 * sizeof(float)));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    residentPoints_ += n.count;
+    return true;
+}
+
+void PointCloudRenderer::evict(size_t node) {
+    NodeGpu& g = gpu_[node];
+    if (!g.vbo) return;
+    glDeleteBuffers(1, &g.vbo);
+    glDeleteVertexArrays(1, &g.vao);
+    g.vbo = g.vao = 0;
+    if (cloud_) residentPoints_ -= cloud_->nodes[node].count;
+}
+
+// least recently drawn first, never what the previous frame drew
+void PointCloudRenderer::beginFrame() {
+    if (cloud_ && frameBudget_ > 0 && residentPoints_ > 2 * frameBudget_) {
+        std::vector<size_t> old;
+        for (size_t i = 0; i < gpu_.size(); ++i) {
+            if (gpu_[i].vbo && gpu_[i].lastDrawn != frame_) old.push_back(i);
+        }
+        std::sort(old.begin(), old.end(), [&](size_t a, size_t b) { return gpu_[a].lastDrawn < gpu_[b].lastDrawn; });
+        for (size_t i = 0; i < old.size() && residentPoints_ > 2 * frameBudget_; ++i) evict(old[i]);
+    }
+    ++frame_;
+    streamingLastFrame_ = stats_.streaming;
+    uploadLeft_ = kUploadPointsPerFrame;
+    frameBudget_ = 0;
+    stats_.drawnNodes = 0;
+    stats_.drawnPoints = 0;
+    stats_.streaming = false;
+}
+
+void PointCloudRenderer::draw(const glm::mat4& mvp, const glm::vec3& eye, float projScale, bool orthographic,
+                              size_t pointBudget, float sizeScale) {
+    if (!prog_ || !cloud_ || cloud_->nodes.empty()) return;
+    const std::vector<PointCloudNode>& nodes = cloud_->nodes;
+    frameBudget_ += pointBudget;
+
+    const Frustum frustum = frustum_from_matrix(mvp);
+    const auto visible = [&](const PointCloudNode& n) {
+        return frustum_overlaps_box(frustum, n.center - glm::vec3(n.halfSize), n.center + glm::vec3(n.halfSize));
+    };
+    // distance from the eye to the node's bounding sphere, 0 inside it; orthographic views have
+    // the same scale everywhere
+    const auto nearDistance = [&](const PointCloudNode& n) {
+        if (orthographic) return 1.0f;
+        return std::max(glm::length(n.center - eye) - n.halfSize * 1.7320508f, 1e-3f);
+    };
+
+    for (size_t id : drawList_) drawnSlot_[id] = -1;
+    drawList_.clear();
+    size_t drawnPoints = 0;
+
+    using Entry = std::pair<float, size_t>;   // projected size, node
+    std::priority_queue<Entry> queue;
+    if (visible(nodes[0])) queue.push({ 0.0f, 0 });
+    while (!queue.empty()) {
+        const size_t id = queue.top().second;
+        queue.pop();
+        const PointCloudNode& n = nodes[id];
+        if (!drawList_.empty() && drawnPoints + n.count > pointBudget) break;
+        if (!gpu_[id].vbo && n.count) {
+            // the root always goes up, whatever its size
+            if (!drawList_.empty() && n.count > uploadLeft_) { stats_.streaming = true; continue; }
+            upload(id);
+            uploadLeft_ -= std::min<size_t>(uploadLeft_, n.count);
+        }
+        drawnSlot_[id] = (int)drawList_.size();
+        drawList_.push_back(id);
+        drawnPoints += n.count;
+        gpu_[id].lastDrawn = frame_;
+
+        // children only add detail while this node's points are more than a pixel apart
+        const float dist = nearDistance(n);
+        if (n.spacing * projScale / dist < 1.0f) continue;
+        for (int32_t c : n.children) {
+            if (c < 0 || !visible(nodes[c])) continue;
+            queue.push({ nodes[c].halfSize * projScale / nearDistance(nodes[c]), (size_t)c });
+        }
+    }
+
+    // splat spacing per drawn node: where every child is drawn as well the cube is filled at
+    // the children's density, so take the coarsest of theirs. Children come after their parent.
+    std::vector<float> spacing(drawList_.size());
+    for (size_t k = drawList_.size(); k-- > 0;) {
+        const PointCloudNode& n = nodes[drawList_[k]];
+        float s = n.spacing;
+        float childMax = 0.0f;
+        bool allDrawn = true, anyChild = false;
+        for (int32_t c : n.children) {
+            if (c < 0) continue;
+            anyChild = true;
+            if (drawnSlot_[c] < 0) { allDrawn = false; break; }
+            childMax = std::max(childMax, spacing[drawnSlot_[c]]);
+        }
+        if (anyChild && allDrawn) s = std::min(s, childMax);
+        spacing[k] = s;
+    }
+
+    glUseProgram(prog_);
+    glUniformMatrix4fv(mvp_loc_, 1, GL_FALSE, glm::value_ptr(mvp));
+    glUniform1f(proj_scale_loc_, projScale);  // gl_Position.w is 1 in orthographic views
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glEnable(GL_DEPTH_TEST);
+    for (size_t k = 0; k < drawList_.size(); ++k) {
+        const size_t id = drawList_[k];
+        if (!gpu_[id].vao) continue;
+        glUniform1f(spacing_loc_, spacing[k] * sizeScale);
+        glBindVertexArray(gpu_[id].vao);
+        glDrawArrays(GL_POINTS, 0, (GLsizei)nodes[id].count);
+    }
+    glBindVertexArray(0);
+    glDisable(GL_PROGRAM_POINT_SIZE);
+    glUseProgram(0);
+
+    stats_.drawnNodes += drawList_.size();
+    stats_.drawnPoints += drawnPoints;
+    stats_.residentNodes = 0;
+    for (const NodeGpu& g : gpu_) stats_.residentNodes += g.vbo != 0;
+    stats_.residentBytes = residentPoints_ * 16;
+}
+
+void PointCloudRenderer::shutdownCleanup() {
+    release();
+    if (prog_) { glDeleteProgram(prog_); prog_ = 0; }
+}
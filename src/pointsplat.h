@@ -0,0 +1,82 @@
+#pragma once
+
+// pointsplat.h
+// Octree LOD point cloud drawing: screen-space sized round splats under a per-frame point budget.
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "pointcloud.h"
+
+struct PointCloudStats {
+    size_t points = 0;          // in the cloud
+    size_t nodes = 0;
+    unsigned depth = 0;
+    size_t residentNodes = 0;   // uploaded
+    size_t residentBytes = 0;
+    size_t drawnNodes = 0;      // last frame, all views
+    size_t drawnPoints = 0;
+    bool streaming = false;     // wanted nodes still waiting for upload
+};
+
+// Nodes are visited largest on screen first (frustum culled) until the point budget is spent or
+// their points are closer than a pixel apart. Each drawn node is one VBO, uploaded the first time it
+// is wanted with a cap on points uploaded per frame (shared by the views drawn in it), so a large
+// cloud refines over a few frames instead of stalling one. Nodes no view drew in the previous frame
+// are dropped once more than twice the budgets of that frame are resident. Splats are sized by the
+// node's point spacing (the children's where all of them are drawn too), projected to pixels per point.
+class PointCloudRenderer {
+public:
+    PointCloudRenderer() = default;
+    ~PointCloudRenderer() = default;
+
+    bool init();
+
+    // the cloud stays shared with whoever loaded it; node VBOs are created on demand
+    void setCloud(std::shared_ptr<const PointCloud> cloud);
+    void release();
+    bool hasCloud() const { return cloud_ != nullptr; }
+
+    // once per frame before the views draw: eviction, upload cap and stats
+    void beginFrame();
+    // some view of the previous frame wanted nodes still waiting for upload (stats() are reset by
+    // beginFrame)
+    bool streamingLastFrame() const { return streamingLastFrame_; }
+
+    // projScale: pixels per world unit, at distance 1 unless orthographic (proj[1][1] * viewport
+    // height / 2). sizeScale multiplies the splat size.
+    void draw(const glm::mat4& mvp, const glm::vec3& eye, float projScale, bool orthographic,
+              size_t pointBudget, float sizeScale);
+
+    const PointCloudStats& stats() const { return stats_; }
+
+    void shutdownCleanup();
+
+private:
+    struct NodeGpu {
+        GLuint vao = 0, vbo = 0;
+        uint64_t lastDrawn = 0;     // frame
+    };
+
+    bool upload(size_t node);
+    void evict(size_t node);
+
+    GLuint prog_ = 0;
+    GLint mvp_loc_ = -1, spacing_loc_ = -1, proj_scale_loc_ = -1;
+
+    std::shared_ptr<const PointCloud> cloud_;
+    std::vector<NodeGpu> gpu_;
+    std::vector<int> drawnSlot_;     // per node, index into drawList_ or -1
+    std::vector<size_t> drawList_;
+    size_t residentPoints_ = 0;
+    uint64_t frame_ = 0;
+    size_t uploadLeft_ = 0;         // this frame
+    size_t frameBudget_ = 0;        // budgets of the views drawn this frame
+    bool streamingLastFrame_ = false;
+
+    PointCloudStats stats_;
+};
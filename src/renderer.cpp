@@ -3,21 +3,27 @@
 #include "renderer.h"
 #include <iostream>
 #include <string>
+#include <algorithm>
 #include <glm/gtc/type_ptr.hpp>
 
 const char* Renderer::vs_src_ = R"GLSL(
 #version 330 core
 layout(location=0) in vec3 aPos;
 layout(location=1) in vec3 aNormal;
+layout(location=2) in vec2 aUV;
 uniform mat4 uMVP;
 uniform mat4 uModel;
 out vec3 vNormal;
-void main(){ vNormal = mat3(transpose(inverse(uModel)))*aNormal; gl_Position = uMVP * vec4(aPos,1.0); }
+out vec3 vWorldPos;
+out vec2 vUV;
+void main(){ vNormal = mat3(transpose(inverse(uModel)))*aNormal; vWorldPos = (uModel * vec4(aPos,1.0)).xyz; vUV = aUV; gl_Position = uMVP * vec4(aPos,1.0); }
 )GLSL";
 
 const char* Renderer::fs_src_ = R"GLSL(
 #version 330 core
 in vec3 vNormal;
+in vec3 vWorldPos;
+in vec2 vUV;
 out vec4 fragColor;
 
 uniform vec3 uLightDir;
@@ -26,14 +32,32 @@ uniform vec3 uLightColor;
 uniform bool uForceWire;
 uniform vec3 uWireColor;
 uniform bool uEnableShadows;
+uniform vec3 uBaseColor;
+uniform float uOpacity;
+uniform bool uHasTexture;
+uniform sampler2D uDiffuseMap;
+uniform bool uFlatShading;
 
 void main(){
     if (uForceWire) { fragColor = vec4(uWireColor, 1.0); return; }
 
+    // flat meshes carry no normals: the face normal is the cross of the screen-space position derivatives.
+    // That always faces the camera; flipped on back faces it follows the stored winding like vNormal does.
+    vec3 N = normalize(vNormal);
+    if (uFlatShading) {
+        N = normalize(cross(dFdx(vWorldPos), dFdy(vWorldPos)));
+        if (!gl_FrontFacing) N = -N;
+    }
     vec3 L = normalize(uLightDir);
-    float NdotL = max(dot(normalize(vNormal), L), 0.0);
-
-    vec3 base = vec3(0.8);
+    float NdotL = max(dot(N, L), 0.0);
+
+    vec3 base = uBaseColor;
+    float alpha = uOpacity;
+    if (uHasTexture) {
+        vec4 texel = texture(uDiffuseMap, vUV);
+        base *= texel.rgb;
+        alpha *= texel.a;
+    }
     vec3 lit = base * (NdotL * uLightIntensity) + base * 0.15;
 
     if (uEnableShadows) {
@@ -41,7 +65,7 @@ void main(){
         lit *= shadowFactor;
     }
 
-    fragColor = vec4(lit * uLightColor, 1.0);
+    fragColor = vec4(lit * uLightColor, alpha);
 }
 )GLSL";
 
@@ -169,11 +193,19 @@ bool Renderer::createBuiltinPrograms() {
     uLightIntensity_ = glGetUniformLocation(prog_, "uLightIntensity");
     uLightColor_ = glGetUniformLocation(prog_, "uLightColor");
     uEnableShadows_ = glGetUniformLocation(prog_, "uEnableShadows");
-    if (uEnableShadows_ >= 0) {
-        glUseProgram(prog_);
-        glUniform1i(uEnableShadows_, 0);
-        glUseProgram(0);
-    }
+    uBaseColor_ = glGetUniformLocation(prog_, "uBaseColor");
+    uOpacity_ = glGetUniformLocation(prog_, "uOpacity");
+    uHasTexture_ = glGetUniformLocation(prog_, "uHasTexture");
+    uDiffuseMap_ = glGetUniformLocation(prog_, "uDiffuseMap");
+    uFlatShading_ = glGetUniformLocation(prog_, "uFlatShading");
+    glUseProgram(prog_);
+    if (uEnableShadows_ >= 0) glUniform1i(uEnableShadows_, 0);
+    if (uBaseColor_ >= 0) glUniform3f(uBaseColor_, 0.8f, 0.8f, 0.8f);
+    if (uOpacity_ >= 0) glUniform1f(uOpacity_, 1.0f);
+    if (uHasTexture_ >= 0) glUniform1i(uHasTexture_, 0);
+    if (uDiffuseMap_ >= 0) glUniform1i(uDiffuseMap_, 0);
+    if (uFlatShading_ >= 0) glUniform1i(uFlatShading_, 0);
+    glUseProgram(0);
 
     bg_prog_ = link_program(compile_shader(GL_VERTEX_SHADER, bg_vs_src_), compile_shader(GL_FRAGMENT_SHADER, bg_fs_src_));
     if (bg_prog_) { glGenVertexArrays(1, &bg_vao_); }
@@ -277,6 +309,54 @@ void Renderer::setWireColor(const glm::vec3& color) {
     }
 }
 
+void Renderer::setFlatShading(bool flat) {
+    if (prog_ && uFlatShading_ >= 0) {
+        glUseProgram(prog_);
+        glUniform1i(uFlatShading_, flat ? 1 : 0);
+        glUseProgram(0);
+    }
+}
+
+void Renderer::drawModelBatches(GLuint vao, const std::vector<DrawBatch>& batches) {
+    if (!prog_ || batches.empty()) return;
+    glUseProgram(prog_);
+    glBindVertexArray(vao);
+    glActiveTexture(GL_TEXTURE0);
+
+    GLuint boundTex = 0;
+    int hasTex = -1;
+    glm::vec3 color(-1.0f);
+    float opacity = -1.0f;
+    bool culling = false;
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glCullFace(GL_BACK);
+    glFrontFace(GL_CCW);
+
+    for (const DrawBatch& b : batches) {
+        bool wantCull = cullClosed_ && b.cullBackfaces;
+        if (wantCull != culling) {
+            if (wantCull) glEnable(GL_CULL_FACE); else glDisable(GL_CULL_FACE);
+            culling = wantCull;
+        }
+        if (b.texture != boundTex) {
+            glBindTexture(GL_TEXTURE_2D, b.texture);
+            boundTex = b.texture;
+        }
+        int wantTex = b.texture ? 1 : 0;
+        if (wantTex != hasTex && uHasTexture_ >= 0) { glUniform1i(uHasTexture_, wantTex); hasTex = wantTex; }
+        if (b.baseColor != color && uBaseColor_ >= 0) { glUniform3f(uBaseColor_, b.baseColor.r, b.baseColor.g, b.baseColor.b); color = b.baseColor; }
+        if (b.opacity != opacity && uOpacity_ >= 0) { glUniform1f(uOpacity_, b.opacity); opacity = b.opacity; }
+        glDrawElements(GL_TRIANGLES, b.indexCount, GL_UNSIGNED_INT, (void*)(b.firstIndex * sizeof(unsigned int)));
+    }
+
+    // leave defaults behind for the wireframe passes
+    if (culling) glDisable(GL_CULL_FACE);
+    if (hasTex != 0 && uHasTexture_ >= 0) glUniform1i(uHasTexture_, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
+
 // Draw helpers
 void Renderer::drawBackground() {
     if (!bg_prog_) return;
@@ -347,3 +427,62 @@ void Renderer::shutdownCleanup() {
 
     if (bg_vao_) { glDeleteVertexArrays(1, &bg_vao_); bg_vao_ = 0; }
 }
+
+// ---- SceneTarget ----------------------------------------------------------
+
+int SceneTarget::ensure(int width, int height, int samples) {
+    width = std::max(1, width);
+    height = std::max(1, height);
+    if (width == width_ && height == height_ && samples == requested_) return samples_;
+    release();
+    width_ = width; height_ = height; requested_ = samples;
+
+    GLint maxSamples = 0;
+    glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+    samples = std::min(samples, (int)maxSamples);
+    if (samples <= 1) return samples_ = 0;
+
+    glGenFramebuffers(1, &fbo_);
+    glGenRenderbuffers(1, &color_);
+    glGenRenderbuffers(1, &depth_);
+    glBindRenderbuffer(GL_RENDERBUFFER, color_);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth_);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_);
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete) {
+        std::cerr << "MSAA target with " << samples << " samples incomplete, drawing without\n";
+        const int keepRequest = requested_;
+        release();
+        width_ = width; height_ = height; requested_ = keepRequest;
+        return samples_ = 0;
+    }
+    return samples_ = samples;
+}
+
+void SceneTarget::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    glViewport(0, 0, width_, height_);
+}
+
+void SceneTarget::resolve() const {
+    if (!fbo_) return;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo_);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, width_, height_, 0, 0, width_, height_, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void SceneTarget::release() {
+    if (fbo_) { glDeleteFramebuffers(1, &fbo_); fbo_ = 0; }
+    if (color_) { glDeleteRenderbuffers(1, &color_); color_ = 0; }
+    if (depth_) { glDeleteRenderbuffers(1, &depth_); depth_ = 0; }
+    width_ = height_ = 0;
+    requested_ = -1;
+    samples_ = 0;
+}
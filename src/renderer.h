@@ -1,6 +1,20 @@
 #pragma once
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <vector>
+#include <cstddef>
+
+// One material range of the model EBO, resolved to GL objects by the app at upload time
+struct DrawBatch {
+    GLuint texture = 0;           // 0 when untextured
+    glm::vec3 baseColor = glm::vec3(0.8f);
+    float opacity = 1.0f;
+    size_t firstIndex = 0;
+    GLsizei indexCount = 0;
+    bool cullBackfaces = false;   // closed, consistently wound geometry
+    bool hasBounds = false;       // else never frustum culled
+    glm::vec3 boundsMin = glm::vec3(0.0f), boundsMax = glm::vec3(0.0f);
+};
 
 class Renderer {
 public:
@@ -22,6 +36,12 @@ public:
     void setEnableShadows(bool enable);
     void setForceWire(bool force);
     void setWireColor(const glm::vec3& color);
+    void setFlatShading(bool flat);
+    // allow GL_CULL_FACE on batches flagged cullBackfaces (no GL calls, read by drawModelBatches)
+    void setBackfaceCulling(bool enable) { cullClosed_ = enable; }
+
+    // draw the model one batch per material; texture binds and uniform writes only happen on change
+    void drawModelBatches(GLuint vao, const std::vector<DrawBatch>& batches);
 
     // grid/background/ui helpers
     void drawBackground();
@@ -42,11 +62,12 @@ public:
     // cleanup GL-owned resources (call with valid context)
     void shutdownCleanup();
 
-private:
-    // shader/program helpers (internal)
+    // shader helpers, also used by the other GL passes (logs and returns 0 on failure)
     static GLuint compile_shader(GLenum t, const char* src);
     static GLuint link_program(GLuint vs, GLuint fs);
 
+private:
+
     // shader sources (kept priv
     static const char* vs_src_;
     static const char* fs_src_;
@@ -79,4 +100,39 @@ private:
     GLint uLightIntensity_ = -1;
     GLint uLightColor_ = -1;
     GLint uEnableShadows_ = -1;
+    GLint uBaseColor_ = -1;
+    GLint uOpacity_ = -1;
+    GLint uHasTexture_ = -1;
+    GLint uDiffuseMap_ = -1;
+
+    bool cullClosed_ = true;
+    GLint uFlatShading_ = -1;
+};
+
+// Multisampled colour + depth target the scene is drawn into and then resolved to the window, so
+// the sample count can change at runtime without recreating the window. 0 samples draws straight
+// into the default framebuffer.
+class SceneTarget {
+public:
+
+    // (re)create when the size or sample count changed; the count is clamped to GL_MAX_SAMPLES and
+    // drops to 0 when the FBO can't be completed. Returns the samples in use.
+    int ensure(int width, int height, int samples);
+
+    // bind for drawing and set the viewport
+    void bind() const;
+    // blit into the default framebuffer (no-op without samples) and leave it bound
+    void resolve() const;
+
+    int samples() const { return samples_; }
+    GLuint fbo() const { return fbo_; } // 0 (the window) without samples
+    void release(); // needs the GL context, called from the app's shutdown cleanup
+
+private:
+    GLuint fbo_ = 0;
+    GLuint color_ = 0;
+    GLuint depth_ = 0;
+    int width_ = 0, height_ = 0;
+    int requested_ = -1;
+    int samples_ = 0;
 };
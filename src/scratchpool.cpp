@@ -0,0 +1,152 @@
+// scratchpool.cpp
+// Implements ScratchPool declared in scratchpool.h
+
+#include "scratchpool.h"
+
+#include <cstdlib>
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+  #include <psapi.h>
+  #include <malloc.h>
+#else
+  #include <sys/mman.h>
+  #include <sys/resource.h>
+#endif
+
+// large blocks are always aligned allocations so one free path covers both modes
+static void free_block(void* p)
+{
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+ScratchPool::~ScratchPool()
+{
+    trim();
+}
+
+size_t ScratchPool::classBytes(size_t bytes)
+{
+    size_t c = minBlock;
+    while (c < bytes) c <<= 1;
+    return c;
+}
+
+void* ScratchPool::allocateBlock(size_t bytes, bool hugePages)
+{
+    const bool huge = hugePages && bytes >= hugePageSize;
+    const size_t align = huge ? hugePageSize : 64;
+    void* p = nullptr;
+#if defined(_WIN32)
+    p = _aligned_malloc(bytes, align);
+#else
+    if (posix_memalign(&p, align, bytes) != 0) p = nullptr;
+#endif
+    if (!p) throw std::bad_alloc();
+#if defined(MADV_HUGEPAGE)
+    if (huge && madvise(p, bytes, MADV_HUGEPAGE) == 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.hugePageBytes += bytes;
+    }
+#endif
+    return p;
+}
+
+void* ScratchPool::acquire(size_t bytes)
+{
+    if (bytes < minBlock) return ::operator new(bytes);
+    const size_t cls = classBytes(bytes);
+    bool huge = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < free_.size(); ++i) {
+            if (free_[i].bytes != cls) continue;
+            void* p = free_[i].ptr;
+            free_[i] = free_.back();
+            free_.pop_back();
+            stats_.cachedBytes -= cls;
+            stats_.hits++;
+            return p;
+        }
+        stats_.misses++;
+        huge = hugePages_;
+    }
+    return allocateBlock(cls, huge);
+}
+
+void ScratchPool::release(void* p, size_t bytes)
+{
+    if (!p) return;
+    if (bytes < minBlock) { ::operator delete(p); return; }
+    const size_t cls = classBytes(bytes);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (reuse_ && stats_.cachedBytes + cls <= maxCached_) {
+            free_.push_back(FreeBlock{ p, cls });
+            stats_.cachedBytes += cls;
+            return;
+        }
+    }
+    free_block(p);
+}
+
+void ScratchPool::configure(bool reuse, bool hugePages)
+{
+    bool drop = !reuse;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        drop = drop || hugePages != hugePages_; // cached blocks were allocated for the other mode
+        reuse_ = reuse;
+        hugePages_ = hugePages;
+    }
+    if (drop) trim();
+}
+
+void ScratchPool::setMaxCachedBytes(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxCached_ = bytes;
+}
+
+void ScratchPool::trim()
+{
+    std::vector<FreeBlock> blocks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        blocks.swap(free_);
+        stats_.cachedBytes = 0;
+    }
+    for (const FreeBlock& b : blocks) free_block(b.ptr);
+}
+
+ScratchStats ScratchPool::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+ScratchPool& globalScratchPool()
+{
+    static ScratchPool pool;
+    return pool;
+}
+
+uint64_t process_page_faults()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc{};
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return pmc.PageFaultCount;
+    return 0;
+#else
+    rusage ru{};
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+    return uint64_t(ru.ru_minflt) + uint64_t(ru.ru_majflt);
+#endif
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+// scratchpool.h
+// Size-classed pool of large scratch blocks reused across loads, plus an allocator so loader
+// temporaries can live in ordinary std::vectors backed by it.
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+struct ScratchStats {
+    size_t hits = 0;            // acquires served from a cached block
+    size_t misses = 0;          // fresh allocations
+    size_t cachedBytes = 0;     // idle blocks held by the pool
+    size_t hugePageBytes = 0;   // bytes advised for transparent huge pages so far
+};
+
+// Blocks from minBlock up are rounded to a power of two and kept on a per-class free list when
+// released, so the next load reuses pages that are already faulted in instead of first-touching
+// fresh ones. Smaller requests go straight to operator new. Cached bytes are capped; beyond the cap
+// released blocks are freed. With huge pages on, blocks of 2 MiB and up are 2 MiB aligned and
+// madvise(MADV_HUGEPAGE)d where the platform has it (Linux THP); elsewhere the flag is ignored.
+class ScratchPool {
+public:
+    static constexpr size_t minBlock = 64 * 1024;
+    static constexpr size_t hugePageSize = 2 * 1024 * 1024;
+
+    ScratchPool() = default;
+    ~ScratchPool();
+
+    ScratchPool(const ScratchPool&) = delete;
+    ScratchPool& operator=(const ScratchPool&) = delete;
+
+    void* acquire(size_t bytes);
+    void release(void* p, size_t bytes); // same byte count as the acquire
+
+    // reuse off frees every block on release (the pre-pool behaviour, for comparisons).
+    // Changing either setting drops the cached blocks.
+    void configure(bool reuse, bool hugePages);
+    void setMaxCachedBytes(size_t bytes);
+
+    void trim(); // free all cached blocks
+    ScratchStats stats() const;
+
+private:
+    static size_t classBytes(size_t bytes);
+    void* allocateBlock(size_t bytes, bool hugePages);
+
+    struct FreeBlock {
+        void* ptr;
+        size_t bytes;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<FreeBlock> free_;
+    bool reuse_ = true;
+    bool hugePages_ = false;
+    size_t maxCached_ = size_t(512) * 1024 * 1024;
+    ScratchStats stats_;
+};
+
+// process-wide pool used by the loader
+ScratchPool& globalScratchPool();
+
+// minor + major page faults of the whole process so far (0 where unsupported)
+uint64_t process_page_faults();
+
+// std allocator over globalScratchPool(); large buffers are pooled, small ones use operator new
+template <class T>
+struct ScratchAllocator {
+    using value_type = T;
+
+    ScratchAllocator() noexcept = default;
+    template <class U> ScratchAllocator(const ScratchAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) { return static_cast<T*>(globalScratchPool().acquire(n * sizeof(T))); }
+    void deallocate(T* p, size_t n) noexcept { globalScratchPool().release(p, n * sizeof(T)); }
+
+    template <class U> bool operator==(const ScratchAllocator<U>&) const noexcept { return true; }
+    template <class U> bool operator!=(const ScratchAllocator<U>&) const noexcept { return false; }
+};
+
+template <class T>
+using ScratchVector = std::vector<T, ScratchAllocator<T>>;
@@ -0,0 +1,215 @@
+// silhouette.cpp
+// Implements SilhouetteRenderer declared in silhouette.h
+
+#include "silhouette.h"
+#include "renderer.h"
+
+#include <initializer_list>
+#include <iostream>
+#include <string>
+
+#include <glm/gtc/type_ptr.hpp>
+
+// shared by both paths: the compute path draws with it directly, the fallback feeds the GS
+static const char* line_vs_src = R"GLSL(
+#version 330 core
+layout(location=0) in vec3 aPos;
+uniform mat4 uMVP;
+out vec3 vPos;
+void main(){
+    vPos = aPos;
+    gl_Position = uMVP * vec4(aPos, 1.0);
+    gl_Position.z -= 0.0005 * gl_Position.w; // keep the outline in front of its own surface
+}
+)GLSL";
+
+static const char* line_fs_src = R"GLSL(
+#version 330 core
+uniform vec3 uColor;
+out vec4 fragColor;
+void main(){ fragColor = vec4(uColor, 1.0); }
+)GLSL";
+
+static const char* gs_src = R"GLSL(
+#version 330 core
+layout(lines_adjacency) in;
+layout(line_strip, max_vertices = 2) out;
+in vec3 vPos[];
+uniform vec3 uEye;
+void main(){
+    vec3 a = vPos[0], p0 = vPos[1], p1 = vPos[2], b = vPos[3];
+    vec3 m = cross(p0 - uEye, p1 - uEye);
+    if (a != b && dot(m, a - uEye) * dot(m, b - uEye) <= 0.0) return;
+    gl_Position = gl_in[1].gl_Position; EmitVertex();
+    gl_Position = gl_in[2].gl_Position; EmitVertex();
+    EndPrimitive();
+}
+)GLSL";
+
+static const char* compute_src = R"GLSL(
+#version 430 core
+layout(local_size_x = 256) in;
+layout(std430, binding = 0) readonly buffer Verts { float verts[]; };
+layout(std430, binding = 1) readonly buffer Edges { uvec4 edges[]; };
+layout(std430, binding = 2) writeonly buffer Segments { uint segments[]; };
+layout(std430, binding = 3) buffer Command { uint count; uint instanceCount; uint firstIndex; int baseVertex; uint baseInstance; };
+uniform uint uEdgeCount;
+uniform uint uStride;
+uniform vec3 uEye;
+vec3 pos(uint i){ uint o = i * uStride; return vec3(verts[o], verts[o + 1u], verts[o + 2u]); }
+void main(){
+    uint e = gl_GlobalInvocationID.x;
+    if (e >= uEdgeCount) return;
+    uvec4 q = edges[e]; // (opposite A, v0, v1, opposite B)
+    vec3 p0 = pos(q.y), p1 = pos(q.z);
+    vec3 m = cross(p0 - uEye, p1 - uEye);
+    if (q.x != q.w && dot(m, pos(q.x) - uEye) * dot(m, pos(q.w) - uEye) <= 0.0) return;
+    uint slot = atomicAdd(count, 2u);
+    segments[slot] = q.y;
+    segments[slot + 1u] = q.z;
+}
+)GLSL";
+
+static GLuint link_shaders(std::initializer_list<GLuint> shaders) {
+    for (GLuint s : shaders) if (!s) { for (GLuint d : shaders) if (d) glDeleteShader(d); return 0; }
+    GLuint p = glCreateProgram();
+    for (GLuint s : shaders) glAttachShader(p, s);
+    glLinkProgram(p);
+    for (GLuint s : shaders) glDeleteShader(s);
+    GLint ok = 0; glGetProgramiv(p, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        GLint len = 0; glGetProgramiv(p, GL_INFO_LOG_LENGTH, &len);
+        std::string log(len ? len : 1, '\0');
+        glGetProgramInfoLog(p, len, nullptr, &log[0]);
+        std::cerr << "Silhouette program link error:\n" << log << "\n";
+        glDeleteProgram(p);
+        return 0;
+    }
+    return p;
+}
+
+bool SilhouetteRenderer::init() {
+#ifdef GL_VERSION_4_3
+    if (GLAD_GL_VERSION_4_3) {
+        compute_prog_ = link_shaders({ Renderer::compile_shader(GL_COMPUTE_SHADER, compute_src) });
+        line_prog_ = link_shaders({ Renderer::compile_shader(GL_VERTEX_SHADER, line_vs_src),
+                                    Renderer::compile_shader(GL_FRAGMENT_SHADER, line_fs_src) });
+        if (compute_prog_ && line_prog_) {
+            glGenQueries(1, &timer_query_);
+            return true;
+        }
+        if (compute_prog_) { glDeleteProgram(compute_prog_); compute_prog_ = 0; }
+        if (line_prog_) { glDeleteProgram(line_prog_); line_prog_ = 0; }
+    }
+#endif
+    gs_prog_ = link_shaders({ Renderer::compile_shader(GL_VERTEX_SHADER, line_vs_src),
+                              Renderer::compile_shader(GL_GEOMETRY_SHADER, gs_src),
+                              Renderer::compile_shader(GL_FRAGMENT_SHADER, line_fs_src) });
+    return gs_prog_ != 0;
+}
+
+void SilhouetteRenderer::upload(GLuint modelVbo, size_t vertexStride, const std::vector<unsigned int>& edges) {
+    release();
+    edge_count_ = edges.size() / 4;
+    if (edge_count_ == 0) return;
+    vbo_ = modelVbo;
+    vertex_stride_ = vertexStride;
+
+    // GL_ARRAY_BUFFER target for the upload so the model VAO's element binding is left alone
+    glGenBuffers(1, &edge_buf_);
+    glBindBuffer(GL_ARRAY_BUFFER, edge_buf_);
+    glBufferData(GL_ARRAY_BUFFER, edges.size() * sizeof(unsigned int), edges.data(), GL_STATIC_DRAW);
+
+    if (usesCompute()) {
+        glGenBuffers(1, &segment_buf_);
+        glBindBuffer(GL_ARRAY_BUFFER, segment_buf_);
+        glBufferData(GL_ARRAY_BUFFER, edge_count_ * 2 * sizeof(unsigned int), nullptr, GL_DYNAMIC_DRAW);
+        glGenBuffers(1, &command_buf_);
+        glBindBuffer(GL_ARRAY_BUFFER, command_buf_);
+        glBufferData(GL_ARRAY_BUFFER, 5 * sizeof(GLuint), nullptr, GL_DYNAMIC_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void SilhouetteRenderer::release() {
+    if (edge_buf_) { glDeleteBuffers(1, &edge_buf_); edge_buf_ = 0; }
+    if (segment_buf_) { glDeleteBuffers(1, &segment_buf_); segment_buf_ = 0; }
+    if (command_buf_) { glDeleteBuffers(1, &command_buf_); command_buf_ = 0; }
+    edge_count_ = 0;
+    vbo_ = 0;
+    timer_pending_ = false;
+}
+
+void SilhouetteRenderer::draw(GLuint modelVao, GLuint modelEbo, const glm::mat4& mvp, const glm::vec3& eye, const glm::vec3& color) {
+    if (edge_count_ == 0 || !modelVao) return;
+    glEnable(GL_DEPTH_TEST);
+    glLineWidth(2.0f);
+
+#ifdef GL_VERSION_4_3
+    if (usesCompute()) {
+        // read last frame's timing only when it is ready, never stall on it
+        if (timer_pending_) {
+            GLint ready = 0;
+            glGetQueryObjectiv(timer_query_, GL_QUERY_RESULT_AVAILABLE, &ready);
+            if (ready) {
+                GLuint64 ns = 0;
+                glGetQueryObjectui64v(timer_query_, GL_QUERY_RESULT, &ns);
+                last_ms_ = double(ns) / 1.0e6;
+                timer_pending_ = false;
+            }
+        }
+
+        const GLuint reset[5] = { 0, 1, 0, 0, 0 }; // count, instanceCount, firstIndex, baseVertex, baseInstance
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command_buf_);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(reset), reset);
+
+        if (!timer_pending_) glBeginQuery(GL_TIME_ELAPSED, timer_query_);
+        glUseProgram(compute_prog_);
+        glUniform1ui(glGetUniformLocation(compute_prog_, "uEdgeCount"), (GLuint)edge_count_);
+        glUniform1ui(glGetUniformLocation(compute_prog_, "uStride"), (GLuint)vertex_stride_);
+        glUniform3fv(glGetUniformLocation(compute_prog_, "uEye"), 1, glm::value_ptr(eye));
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, vbo_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, edge_buf_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, segment_buf_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, command_buf_);
+        glDispatchCompute((GLuint)((edge_count_ + 255) / 256), 1, 1);
+        if (!timer_pending_) { glEndQuery(GL_TIME_ELAPSED); timer_pending_ = true; }
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT);
+
+        glUseProgram(line_prog_);
+        glUniformMatrix4fv(glGetUniformLocation(line_prog_, "uMVP"), 1, GL_FALSE, glm::value_ptr(mvp));
+        glUniform3fv(glGetUniformLocation(line_prog_, "uColor"), 1, glm::value_ptr(color));
+        glBindVertexArray(modelVao);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, segment_buf_);
+        glDrawElementsIndirect(GL_LINES, GL_UNSIGNED_INT, nullptr);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, modelEbo);
+        glBindVertexArray(0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        for (GLuint b = 0; b < 4; ++b) glBindBufferBase(GL_SHADER_STORAGE_BUFFER, b, 0);
+        glUseProgram(0);
+        glLineWidth(1.0f);
+        return;
+    }
+#endif
+
+    if (!gs_prog_) return;
+    glUseProgram(gs_prog_);
+    glUniformMatrix4fv(glGetUniformLocation(gs_prog_, "uMVP"), 1, GL_FALSE, glm::value_ptr(mvp));
+    glUniform3fv(glGetUniformLocation(gs_prog_, "uEye"), 1, glm::value_ptr(eye));
+    glUniform3fv(glGetUniformLocation(gs_prog_, "uColor"), 1, glm::value_ptr(color));
+    glBindVertexArray(modelVao);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, edge_buf_);
+    glDrawElements(GL_LINES_ADJACENCY, (GLsizei)(edge_count_ * 4), GL_UNSIGNED_INT, nullptr);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, modelEbo);
+    glBindVertexArray(0);
+    glUseProgram(0);
+    glLineWidth(1.0f);
+}
+
+void SilhouetteRenderer::shutdownCleanup() {
+    release();
+    if (compute_prog_) { glDeleteProgram(compute_prog_); compute_prog_ = 0; }
+    if (line_prog_) { glDeleteProgram(line_prog_); line_prog_ = 0; }
+    if (gs_prog_) { glDeleteProgram(gs_prog_); gs_prog_ = 0; }
+    if (timer_query_) { glDeleteQueries(1, &timer_query_); timer_query_ = 0; }
+}
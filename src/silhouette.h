@@ -0,0 +1,57 @@
+#pragma once
+
+// silhouette.h
+// View-dependent silhouette outlines extracted on the GPU every frame.
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstddef>
+
+// Works on the edge-adjacency list from the loader (MeshData::silhouetteEdges): one uvec4 per edge
+// holding (opposite vertex A, v0, v1, opposite vertex B), B == A on open edges.
+// An edge is on the silhouette when A and B lie on the same side of the plane through the eye and
+// the edge, which does not depend on winding. Open edges always pass.
+//
+// GL 4.3: a compute pass reads the model VBO and the edge list as SSBOs, appends passing edges as
+// index pairs and bumps the count of an indirect draw, which is then drawn with the model VAO.
+// Older contexts draw the edge list as GL_LINES_ADJACENCY and a geometry shader does the same test.
+class SilhouetteRenderer {
+public:
+    SilhouetteRenderer() = default;
+    ~SilhouetteRenderer() = default;
+
+    // compile programs for the best available path (needs a current context)
+    bool init();
+
+    // upload the adjacency list for the current model. vertexStride is in floats, position first.
+    void upload(GLuint modelVbo, size_t vertexStride, const std::vector<unsigned int>& edges);
+    void release();
+
+    // extract and draw with depth test; eye is in model space
+    void draw(GLuint modelVao, GLuint modelEbo, const glm::mat4& mvp, const glm::vec3& eye, const glm::vec3& color);
+
+    bool usesCompute() const { return compute_prog_ != 0; }
+    size_t edgeCount() const { return edge_count_; }
+
+    // GPU time of the last completed extraction in ms (compute path only), -1 when not measured yet
+    double lastExtractMs() const { return last_ms_; }
+
+    void shutdownCleanup();
+
+private:
+    GLuint compute_prog_ = 0;
+    GLuint line_prog_ = 0;     // draws extracted index pairs
+    GLuint gs_prog_ = 0;       // lines_adjacency fallback
+
+    GLuint vbo_ = 0;           // model VBO (not owned)
+    GLuint edge_buf_ = 0;      // uvec4 per edge; SSBO for compute, EBO for the fallback
+    GLuint segment_buf_ = 0;   // extracted index pairs
+    GLuint command_buf_ = 0;   // DrawElementsIndirectCommand
+    GLuint timer_query_ = 0;
+    bool timer_pending_ = false;
+
+    size_t edge_count_ = 0;
+    size_t vertex_stride_ = 0;
+    double last_ms_ = -1.0;
+};
@@ -0,0 +1,51 @@
+// task.cpp
+// Implements MainExecutor declared in task.h
+
+#include "task.h"
+
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+// Fire-and-forget wrapper: runs eagerly and frees its own frame at the end
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+Detached run_detached(Task<void> task, std::atomic<size_t>* live) {
+    try {
+        co_await task;
+    } catch (const TaskCancelled&) {
+    } catch (const std::exception& e) {
+        std::cerr << "Task failed: " << e.what() << "\n";
+    }
+    live->fetch_sub(1, std::memory_order_release);
+}
+
+} // namespace
+
+void MainExecutor::spawn(Task<void> task)
+{
+    live_.fetch_add(1, std::memory_order_relaxed);
+    run_detached(std::move(task), &live_);
+}
+
+size_t MainExecutor::run(double budgetMs)
+{
+    const auto start = std::chrono::steady_clock::now();
+    size_t resumed = 0;
+    std::coroutine_handle<> h;
+    while (ready_.pop(h)) {
+        h.resume();
+        ++resumed;
+        if (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() >= budgetMs) break;
+    }
+    return resumed;
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+// task.h
+// Awaitable coroutine tasks: Task<T>, hops between the thread pool and the main thread, a
+// main-thread executor drained by the frame loop, and cooperative cancellation.
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "mpscqueue.h"
+#include "threadpool.h"
+
+// thrown by CancelToken::check(); spawned tasks that end with it finish silently
+struct TaskCancelled : std::runtime_error {
+    TaskCancelled() : std::runtime_error("task cancelled") {}
+};
+
+// Shared flag, cheap to copy. Tasks poll it at their own checkpoints; nothing is interrupted.
+class CancelToken {
+public:
+    CancelToken() : flag_(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() { flag_->store(true, std::memory_order_relaxed); }
+    bool cancelled() const { return flag_->load(std::memory_order_relaxed); }
+    void check() const { if (cancelled()) throw TaskCancelled(); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag_;
+};
+
+template <class T> class Task;
+
+namespace task_detail {
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    // hand control straight to whoever awaited us (symmetric transfer, no stack growth)
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template <class P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+            return h.promise().continuation;
+        }
+        void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+};
+
+template <class T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object();
+    template <class U> void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+
+    T take() {
+        if (error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object();
+    void return_void() {}
+
+    void take() {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+} // namespace task_detail
+
+// Lazy: the body starts when the task is awaited (or spawned on a MainExecutor) and runs on the
+// awaiting thread until it hops elsewhere. Exceptions propagate to the awaiter. Move-only; the
+// frame is destroyed with the Task.
+template <class T = void>
+class [[nodiscard]] Task {
+public:
+    using promise_type = task_detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+    explicit Task(Handle h) : h_(h) {}
+    Task(Task&& other) noexcept : h_(std::exchange(other.h_, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (h_) h_.destroy();
+            h_ = std::exchange(other.h_, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() { if (h_) h_.destroy(); }
+
+    bool await_ready() const noexcept { return !h_ || h_.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        h_.promise().continuation = awaiting;
+        return h_;
+    }
+    T await_resume() { return h_.promise().take(); }
+
+private:
+    Handle h_;
+};
+
+namespace task_detail {
+template <class T>
+Task<T> Promise<T>::get_return_object() { return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this)); }
+inline Task<void> Promise<void>::get_return_object() { return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this)); }
+} // namespace task_detail
+
+// co_await resume_on(pool): continue on one of the pool's workers
+inline auto resume_on(ThreadPool& pool) {
+    struct Awaiter {
+        ThreadPool& pool;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { pool.post([h]() { h.resume(); }); }
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{ pool };
+}
+
+// Runs coroutines on the thread that calls run(), i.e. the frame loop. Any thread may schedule;
+// spawned tasks are owned by the executor until they finish.
+class MainExecutor {
+public:
+    MainExecutor() = default;
+    MainExecutor(const MainExecutor&) = delete;
+    MainExecutor& operator=(const MainExecutor&) = delete;
+
+    // co_await executor.schedule(): continue on the main thread at the next run()
+    auto schedule() {
+        struct Awaiter {
+            MainExecutor& executor;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { executor.ready_.push(std::move(h)); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{ *this };
+    }
+
+    // Start a task now, on the calling thread, and keep it alive until it completes. Errors other
+    // than TaskCancelled are logged.
+    void spawn(Task<void> task);
+
+    // resume scheduled coroutines until none are ready or budgetMs is spent (at least one is
+    // resumed per call). Returns the number resumed.
+    size_t run(double budgetMs);
+
+    // spawned tasks that have not finished yet
+    size_t pending() const { return live_.load(std::memory_order_acquire); }
+
+private:
+    MpscQueue<std::coroutine_handle<>> ready_;
+    std::atomic<size_t> live_{0};
+};
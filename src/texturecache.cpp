@@ -0,0 +1,186 @@
+// texturecache.cpp
+// Implements the compressed texture cache declared in texturecache.h
+
+#include "texturecache.h"
+#include "bcn.h"
+#include "threadpool.h"
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+  #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <unistd.h>
+#endif
+
+// bump when the encoder or the file layout changes, old entries are then ignored
+static const uint32_t kCacheVersion = 1;
+static const char kCacheMagic[4] = { 'S', 'P', 'T', 'C' };
+
+bool hash_file_contents(const std::string& path, uint64_t& hash)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    uint64_t h = 1469598103934665603ull;
+    char buf[1 << 16];
+    while (in) {
+        in.read(buf, sizeof(buf));
+        std::streamsize n = in.gcount();
+        for (std::streamsize i = 0; i < n; ++i) {
+            h ^= (unsigned char)buf[i];
+            h *= 1099511628211ull;
+        }
+    }
+    hash = h;
+    return true;
+}
+
+static std::string cache_file_path(const std::string& dir, uint64_t hash)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.sptc", (unsigned long long)hash);
+    return (std::filesystem::path(dir) / name).string();
+}
+
+bool texture_cache_load(const std::string& dir, uint64_t hash, TextureImage& out)
+{
+    if (dir.empty()) return false;
+    const std::string path = cache_file_path(dir, hash);
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    char magic[4] = {};
+    uint32_t header[5] = {}; // version, format, width, height, mip count
+    in.read(magic, 4);
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || std::memcmp(magic, kCacheMagic, 4) != 0 || header[0] != kCacheVersion) return false;
+    if (header[1] != (uint32_t)TextureFormat::BC1 && header[1] != (uint32_t)TextureFormat::BC3) return false;
+    if (header[4] == 0 || header[4] > 32) return false;
+
+    TextureImage img;
+    img.format = (TextureFormat)header[1];
+    img.hasAlpha = img.format == TextureFormat::BC3;
+    img.width = (int)header[2];
+    img.height = (int)header[3];
+    const size_t blockBytes = img.hasAlpha ? 16 : 8;
+    int w = img.width, h = img.height;
+    for (uint32_t level = 0; level < header[4]; ++level) {
+        const size_t expected = size_t((w + 3) / 4) * size_t((h + 3) / 4) * blockBytes;
+        uint32_t size = 0;
+        in.read(reinterpret_cast<char*>(&size), sizeof(size));
+        if (!in || size != expected) return false;
+        img.mips.emplace_back(size);
+        in.read(reinterpret_cast<char*>(img.mips.back().data()), size);
+        if (!in) return false;
+        w = std::max(1, w / 2); h = std::max(1, h / 2);
+    }
+
+    out = std::move(img);
+
+    // mark as recently used for texture_cache_trim_async
+    std::error_code ec;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    return true;
+}
+
+// hashes with a store job queued or running: a re-import while the first stores still run
+// would only compress the same texture again
+static std::mutex g_storeMutex;
+static std::unordered_set<uint64_t> g_storesInFlight;
+static std::atomic<uint64_t> g_storeSerial{ 0 };
+
+static unsigned long current_process_id()
+{
+#if defined(_WIN32)
+    return (unsigned long)GetCurrentProcessId();
+#else
+    return (unsigned long)getpid();
+#endif
+}
+
+void texture_cache_store_async(const std::string& dir, uint64_t hash, TextureImage rgba)
+{
+    if (dir.empty() || rgba.format != TextureFormat::RGBA8) return;
+    {
+        std::lock_guard<std::mutex> lock(g_storeMutex);
+        if (!g_storesInFlight.insert(hash).second) return;
+    }
+    auto src = std::make_shared<TextureImage>(std::move(rgba));
+    globalThreadPool().submit([dir, hash, src]() {
+        struct Done {
+            uint64_t hash;
+            ~Done() { std::lock_guard<std::mutex> lock(g_storeMutex); g_storesInFlight.erase(hash); }
+        } done{ hash };
+
+        TextureImage bc;
+        if (!compress_texture_bcn(*src, bc)) return;
+
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        // write to a temp name unique to this process and job, then rename, so a concurrent reader
+        // never sees a partial file and another process storing the same hash never shares the temp file
+        const std::string finalPath = cache_file_path(dir, hash);
+        const std::string tmpPath = finalPath + "." + std::to_string(current_process_id()) + "-"
+                                  + std::to_string(++g_storeSerial) + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                std::cerr << "texture cache: cannot write " << tmpPath << "\n";
+                return;
+            }
+            uint32_t header[5] = { kCacheVersion, (uint32_t)bc.format, (uint32_t)bc.width, (uint32_t)bc.height, (uint32_t)bc.mips.size() };
+            out.write(kCacheMagic, 4);
+            out.write(reinterpret_cast<const char*>(header), sizeof(header));
+            for (const auto& m : bc.mips) {
+                uint32_t size = (uint32_t)m.size();
+                out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+                out.write(reinterpret_cast<const char*>(m.data()), size);
+            }
+        }
+        std::filesystem::rename(tmpPath, finalPath, ec);
+        if (ec) std::filesystem::remove(tmpPath, ec);
+    });
+}
+
+void texture_cache_trim_async(const std::string& dir, uint64_t maxBytes)
+{
+    if (dir.empty() || maxBytes == 0) return;
+    globalThreadPool().post([dir, maxBytes]() {
+        struct Entry {
+            std::filesystem::path path;
+            uint64_t bytes;
+            std::filesystem::file_time_type time;
+        };
+        std::vector<Entry> entries;
+        uint64_t total = 0;
+        std::error_code ec;
+        for (const auto& de : std::filesystem::directory_iterator(dir, ec)) {
+            if (de.path().extension() != ".sptc") continue;
+            std::error_code fileEc;
+            Entry e{ de.path(), (uint64_t)de.file_size(fileEc), de.last_write_time(fileEc) };
+            if (fileEc) continue;
+            total += e.bytes;
+            entries.push_back(std::move(e));
+        }
+        if (total <= maxBytes) return;
+
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+        for (const Entry& e : entries) {
+            if (total <= maxBytes) break;
+            if (std::filesystem::remove(e.path, ec)) total -= e.bytes;
+        }
+    });
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+// texturecache.h
+// Persistent on-disk cache of block-compressed textures keyed by a hash of the source file bytes.
+
+#include "textures.h"
+
+#include <cstdint>
+#include <string>
+
+// FNV-1a of the file contents; false when the file can't be read
+bool hash_file_contents(const std::string& path, uint64_t& hash);
+
+// load <dir>/<hash>.sptc into out (BC1/BC3 mips). False on miss or a stale/corrupt entry.
+bool texture_cache_load(const std::string& dir, uint64_t hash, TextureImage& out);
+
+// compress rgba on the thread pool and write it to the cache without blocking the caller
+void texture_cache_store_async(const std::string& dir, uint64_t hash, TextureImage rgba);
+
+// delete the least recently used entries (hits refresh an entry's time) until the cache holds at
+// most maxBytes; runs on the thread pool. maxBytes 0 means no limit.
+void texture_cache_trim_async(const std::string& dir, uint64_t maxBytes);
@@ -0,0 +1,172 @@
+// textures.cpp
+// Implements texture decoding declared in textures.h
+
+#include "textures.h"
+
+#include <iostream>
+#include <algorithm>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+// imgui_draw.cpp compiles its own static copy, keep ours private too
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imstb_rectpack.h"
+
+size_t TextureImage::byteSize() const
+{
+    size_t n = 0;
+    for (const auto& m : mips) n += m.size();
+    return n;
+}
+
+bool decode_texture_info(const std::string& path, int& width, int& height)
+{
+    int comp = 0;
+    return stbi_info(path.c_str(), &width, &height, &comp) != 0;
+}
+
+bool decode_texture_rgba(const std::string& path, TextureImage& out)
+{
+    int w = 0, h = 0, comp = 0;
+    stbi_set_flip_vertically_on_load_thread(1); // OBJ/GL texcoords have v=0 at the bottom
+    unsigned char* pixels = stbi_load(path.c_str(), &w, &h, &comp, 4);
+    if (!pixels) {
+        std::cerr << "failed to decode texture " << path << ": " << stbi_failure_reason() << "\n";
+        return false;
+    }
+
+    out.path = path;
+    out.width = w;
+    out.height = h;
+    out.format = TextureFormat::RGBA8;
+    out.mips.clear();
+    out.mips.emplace_back(pixels, pixels + size_t(w) * size_t(h) * 4);
+    stbi_image_free(pixels);
+
+    // an alpha channel that is fully opaque can still use the opaque (BC1) path
+    out.hasAlpha = false;
+    if (comp == 2 || comp == 4) {
+        const std::vector<unsigned char>& px = out.mips[0];
+        for (size_t i = 3; i < px.size() && !out.hasAlpha; i += 4) out.hasAlpha = px[i] != 255;
+    }
+
+    generate_mips_rgba(out);
+    return true;
+}
+
+void generate_mips_rgba(TextureImage& out)
+{
+    if (out.mips.empty()) return;
+    out.mips.resize(1);
+
+    int w = out.width, h = out.height;
+    while (w > 1 || h > 1) {
+        const int nw = std::max(1, w / 2);
+        const int nh = std::max(1, h / 2);
+        const std::vector<unsigned char>& src = out.mips.back();
+        std::vector<unsigned char> dst(size_t(nw) * size_t(nh) * 4);
+
+        for (int y = 0; y < nh; ++y) {
+            const int y0 = std::min(h - 1, y * 2), y1 = std::min(h - 1, y * 2 + 1);
+            for (int x = 0; x < nw; ++x) {
+                const int x0 = std::min(w - 1, x * 2), x1 = std::min(w - 1, x * 2 + 1);
+                const unsigned char* a = &src[(size_t(y0) * w + x0) * 4];
+                const unsigned char* b = &src[(size_t(y0) * w + x1) * 4];
+                const unsigned char* c = &src[(size_t(y1) * w + x0) * 4];
+                const unsigned char* d = &src[(size_t(y1) * w + x1) * 4];
+                unsigned char* o = &dst[(size_t(y) * nw + x) * 4];
+                for (int k = 0; k < 4; ++k) o[k] = (unsigned char)((a[k] + b[k] + c[k] + d[k] + 2) / 4);
+            }
+        }
+
+        out.mips.push_back(std::move(dst));
+        w = nw; h = nh;
+    }
+}
+
+void pack_texture_atlas(const std::vector<TextureImage>& images,
+                        const std::vector<AtlasRequest>& requests,
+                        int pageSize, int gutter,
+                        std::vector<TextureImage>& pages,
+                        std::vector<AtlasPlacement>& placements)
+{
+    placements.assign(requests.size(), AtlasPlacement{});
+    if (requests.empty() || gutter <= 0 || pageSize < gutter * 4) return;
+
+    // pack in gutter-sized cells so every placement is aligned for the mip levels we keep
+    const int cells = pageSize / gutter;
+    std::vector<stbrp_rect> pending;
+    for (size_t r = 0; r < requests.size(); ++r) {
+        const TextureImage& img = images[requests[r].image];
+        const int cw = (img.width + 2 * gutter + gutter - 1) / gutter;
+        const int ch = (img.height + 2 * gutter + gutter - 1) / gutter;
+        if (cw > cells || ch > cells || img.mips.empty()) continue;
+        stbrp_rect rect = {};
+        rect.id = (int)r;
+        rect.w = cw;
+        rect.h = ch;
+        pending.push_back(rect);
+    }
+
+    int mipLevels = 1;
+    while ((1 << (mipLevels - 1)) < gutter) ++mipLevels;
+
+    std::vector<stbrp_node> nodes((size_t)cells);
+    while (!pending.empty()) {
+        stbrp_context ctx;
+        stbrp_init_target(&ctx, cells, cells, nodes.data(), (int)nodes.size());
+        stbrp_pack_rects(&ctx, pending.data(), (int)pending.size());
+
+        const int page = (int)pages.size();
+        int usedCells = 0;
+        std::vector<stbrp_rect> leftover;
+        for (const stbrp_rect& rect : pending) {
+            if (!rect.was_packed) { leftover.push_back(rect); continue; }
+            const TextureImage& img = images[requests[rect.id].image];
+            AtlasPlacement& pl = placements[rect.id];
+            pl.page = page;
+            pl.x = rect.x * gutter + gutter;
+            pl.y = rect.y * gutter + gutter;
+            pl.width = img.width;
+            pl.height = img.height;
+            usedCells = std::max(usedCells, (int)(rect.y + rect.h));
+        }
+        if (leftover.size() == pending.size()) break; // nothing fits any more
+
+        // trim the unused top of the page (keeps the height aligned)
+        TextureImage out;
+        out.path = "atlas#" + std::to_string(page);
+        out.width = pageSize;
+        out.height = std::max(gutter, usedCells * gutter);
+        out.mips.emplace_back(size_t(out.width) * size_t(out.height) * 4, (unsigned char)0);
+        std::vector<unsigned char>& dst = out.mips[0];
+
+        for (size_t r = 0; r < requests.size(); ++r) {
+            const AtlasPlacement& pl = placements[r];
+            if (pl.page != page) continue;
+            const TextureImage& img = images[requests[r].image];
+            const float* tint = requests[r].tint;
+            const std::vector<unsigned char>& src = img.mips[0];
+            out.hasAlpha = out.hasAlpha || img.hasAlpha;
+
+            // payload plus gutter, gutter texels clamp to the nearest edge texel
+            for (int y = -gutter; y < img.height + gutter; ++y) {
+                const int sy = std::min(std::max(y, 0), img.height - 1);
+                for (int x = -gutter; x < img.width + gutter; ++x) {
+                    const int sx = std::min(std::max(x, 0), img.width - 1);
+                    const unsigned char* s = &src[(size_t(sy) * img.width + sx) * 4];
+                    unsigned char* d = &dst[(size_t(pl.y + y) * out.width + (pl.x + x)) * 4];
+                    for (int k = 0; k < 3; ++k) d[k] = (unsigned char)std::min(255.0f, s[k] * tint[k] + 0.5f);
+                    d[3] = s[3];
+                }
+            }
+        }
+
+        generate_mips_rgba(out);
+        if ((int)out.mips.size() > mipLevels) out.mips.resize(mipLevels);
+        pages.push_back(std::move(out));
+        pending.swap(leftover);
+    }
+}
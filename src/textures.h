@@ -0,0 +1,61 @@
+#pragma once
+
+// textures.h
+// CPU side texture decoding (stb_image) and mip generation for material textures.
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// RGBA8 = 4 bytes/texel, BC1 = 8 bytes per 4x4 block (opaque), BC3 = 16 bytes per 4x4 block (alpha)
+enum class TextureFormat {
+    RGBA8,
+    BC1,
+    BC3
+};
+
+// Image with a full mip chain, level 0 first. Filled on loader threads, uploaded by the app.
+// mips hold raw texels for RGBA8 and 4x4 blocks for the BC formats.
+struct TextureImage {
+    std::string path;
+    int width = 0;
+    int height = 0;
+    bool hasAlpha = false;
+    TextureFormat format = TextureFormat::RGBA8;
+    std::vector<std::vector<unsigned char>> mips;
+
+    size_t byteSize() const;
+};
+
+// read only the image header
+bool decode_texture_info(const std::string& path, int& width, int& height);
+
+// decode an image file to RGBA8 and build its mip chain. Returns false (and logs) on failure.
+bool decode_texture_rgba(const std::string& path, TextureImage& out);
+
+// (re)build out.mips[1..] from out.mips[0] with a 2x2 box filter
+void generate_mips_rgba(TextureImage& out);
+
+// one image to place in an atlas; tint is multiplied into the copied texels (material Kd)
+struct AtlasRequest {
+    int image = -1;
+    float tint[3] = { 1.0f, 1.0f, 1.0f };
+};
+
+// where a request landed: payload origin/size in page texels, gutter excluded
+struct AtlasPlacement {
+    int page = -1;
+    int x = 0, y = 0;
+    int width = 0, height = 0;
+};
+
+// Pack requests into pageSize x pageSize RGBA pages (imstb_rectpack). Every image gets `gutter`
+// texels of edge extension and is aligned to the gutter (a power of two), so box-filtered mips up
+// to log2(gutter) never mix neighbours; pages carry exactly that many mip levels.
+// Requests larger than a page are left unplaced (page == -1).
+void pack_texture_atlas(const std::vector<TextureImage>& images,
+                        const std::vector<AtlasRequest>& requests,
+                        int pageSize, int gutter,
+                        std::vector<TextureImage>& pages,
+                        std::vector<AtlasPlacement>& placements);
@@ -0,0 +1,160 @@
+// threadpool.cpp
+// Implements ThreadPool declared in threadpool.h
+
+#include "threadpool.h"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+  #define NOMINMAX
+  #endif
+  #include <windows.h>
+#elif defined(__linux__)
+  #include <pthread.h>
+  #include <sched.h>
+  #include <sys/resource.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+// switch the calling thread's scheduling class
+static bool apply_thread_priority(ThreadPriority priority)
+{
+#if defined(_WIN32)
+    int level = THREAD_PRIORITY_NORMAL;
+    if (priority == ThreadPriority::Low) level = THREAD_PRIORITY_BELOW_NORMAL;
+    if (priority == ThreadPriority::Idle) level = THREAD_PRIORITY_IDLE;
+    return SetThreadPriority(GetCurrentThread(), level) != 0;
+#elif defined(__linux__)
+    // policy and nice are both per thread on Linux (setpriority takes the tid)
+    sched_param param{};
+    const int policy = (priority == ThreadPriority::Idle) ? SCHED_IDLE : SCHED_OTHER;
+    bool ok = pthread_setschedparam(pthread_self(), policy, &param) == 0;
+    const int nice = (priority == ThreadPriority::Normal) ? 0 : (priority == ThreadPriority::Low ? 10 : 19);
+    ok = setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), nice) == 0 && ok;
+    return ok;
+#else
+    return priority == ThreadPriority::Normal;
+#endif
+}
+
+ThreadPool::ThreadPool(unsigned threadCount)
+{
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    limit_.store(threadCount);
+    workers_.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers_.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : workers_) if (t.joinable()) t.join();
+}
+
+void ThreadPool::enqueue(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push(std::move(job));
+    }
+    // a single wakeup could land on a parked worker that may not take the job
+    if (concurrency() < size()) cv_.notify_all();
+    else cv_.notify_one();
+}
+
+void ThreadPool::setWorkerPriority(ThreadPriority priority)
+{
+    priority_.store((int)priority, std::memory_order_relaxed);
+    priorityApplied_.store(true, std::memory_order_relaxed);
+    prioritySerial_.fetch_add(1, std::memory_order_release);
+}
+
+void ThreadPool::setConcurrency(unsigned n)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        limit_.store(std::clamp(n, 1u, size()), std::memory_order_relaxed);
+    }
+    cv_.notify_all();
+}
+
+void ThreadPool::workerLoop(unsigned index)
+{
+    unsigned appliedSerial = 0;
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this, index]() {
+                return stopping_ || (!jobs_.empty() && index < limit_.load(std::memory_order_relaxed));
+            });
+            if (stopping_ && jobs_.empty()) return;
+            job = std::move(jobs_.front());
+            jobs_.pop();
+        }
+        const unsigned serial = prioritySerial_.load(std::memory_order_acquire);
+        if (serial != appliedSerial) {
+            appliedSerial = serial;
+            if (!apply_thread_priority(workerPriority())) priorityApplied_.store(false, std::memory_order_relaxed);
+        }
+        job();
+    }
+}
+
+void ThreadPool::parallel_for(size_t begin, size_t end, size_t grain,
+                              const std::function<void(size_t, size_t)>& fn)
+{
+    if (end <= begin) return;
+    const size_t count = end - begin;
+    if (grain == 0) grain = 1;
+    size_t chunks = std::min<size_t>((count + grain - 1) / grain, size_t(size()) * 4);
+    if (chunks <= 1) { fn(begin, end); return; }
+
+    struct Shared {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex m;
+        std::condition_variable cv;
+    };
+    auto shared = std::make_shared<Shared>();
+    const size_t chunkSize = (count + chunks - 1) / chunks;
+    const std::function<void(size_t, size_t)>* body = &fn;
+
+    // helpers and the caller pull chunks from the shared counter. The caller only waits on
+    // finished chunks (not on helper jobs), so a parallel_for issued from inside a busy
+    // worker can never deadlock on helpers that are still queued.
+    auto runChunks = [shared, chunks, chunkSize, begin, end, body]() {
+        for (;;) {
+            size_t c = shared->next.fetch_add(1);
+            if (c >= chunks) return;
+            size_t b = begin + c * chunkSize;
+            size_t e = std::min(end, b + chunkSize);
+            if (b < e) (*body)(b, e);
+            if (shared->done.fetch_add(1) + 1 == chunks) {
+                std::lock_guard<std::mutex> lock(shared->m);
+                shared->cv.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min<size_t>(concurrency(), chunks - 1);
+    for (size_t i = 0; i < helpers; ++i) enqueue(runChunks);
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(shared->m);
+    shared->cv.wait(lock, [&]() { return shared->done.load() == chunks; });
+}
+
+ThreadPool& globalThreadPool()
+{
+    static ThreadPool pool;
+    return pool;
+}
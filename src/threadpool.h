@@ -0,0 +1,110 @@
+#pragma once
+
+// threadpool.h
+// Small fixed-size worker pool shared by the loader and its post-processing stages.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Scheduling class of the pool's workers. Low is nice 10 (below normal on Windows); Idle is
+// SCHED_IDLE (idle priority on Windows): workers only get CPU time nothing else wants.
+enum class ThreadPriority {
+    Normal = 0,
+    Low = 1,
+    Idle = 2
+};
+
+class ThreadPool {
+public:
+    // threadCount == 0 picks hardware_concurrency (at least 1)
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return (unsigned)workers_.size(); }
+
+    // Each worker switches before its next job. Going back up may need privileges on Linux
+    // (RLIMIT_NICE); workerPriorityApplied() turns false when the OS refused any switch.
+    void setWorkerPriority(ThreadPriority priority);
+    ThreadPriority workerPriority() const { return (ThreadPriority)priority_.load(std::memory_order_relaxed); }
+    bool workerPriorityApplied() const { return priorityApplied_.load(std::memory_order_relaxed); }
+
+    // at most n workers (clamped to 1..size()) pick up jobs, the others park until it is raised
+    void setConcurrency(unsigned n);
+    unsigned concurrency() const { return limit_.load(std::memory_order_relaxed); }
+
+    // queue a task, returns a future for its result
+    template <class F>
+    auto submit(F&& fn) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+        std::future<R> fut = task->get_future();
+        enqueue([task]() { (*task)(); });
+        return fut;
+    }
+
+    // queue a task with no result (coroutine resumptions)
+    void post(std::function<void()> job) { enqueue(std::move(job)); }
+
+    // split [begin, end) into chunks of at least `grain` items and run fn(chunkBegin, chunkEnd)
+    // on the workers. The calling thread takes a share of the chunks and blocks until all are done.
+    void parallel_for(size_t begin, size_t end, size_t grain,
+                      const std::function<void(size_t, size_t)>& fn);
+
+private:
+    void enqueue(std::function<void()> job);
+    void workerLoop(unsigned index);
+
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> jobs_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::atomic<unsigned> limit_{0};           // written under mutex_
+    std::atomic<int> priority_{0};
+    std::atomic<unsigned> prioritySerial_{0};  // bumped per setWorkerPriority
+    std::atomic<bool> priorityApplied_{true};
+};
+
+// process-wide pool used by loader stages (created on first use)
+ThreadPool& globalThreadPool();
+
+// std::sort on the global pool: chunks sorted in parallel, then merged pairwise (each merge level
+// runs in parallel too). Not stable.
+template <class Vec, class Less>
+void parallel_sort(Vec& v, Less less)
+{
+    ThreadPool& pool = globalThreadPool();
+    const size_t chunks = std::min<size_t>(pool.size() + 1, v.size() / 65536);
+    if (chunks <= 1) { std::sort(v.begin(), v.end(), less); return; }
+
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t c = 0; c <= chunks; ++c) bounds[c] = v.size() * c / chunks;
+    pool.parallel_for(0, chunks, 1, [&](size_t b, size_t e) {
+        for (size_t c = b; c < e; ++c) std::sort(v.begin() + bounds[c], v.begin() + bounds[c + 1], less);
+    });
+    for (size_t width = 1; width < chunks; width *= 2) {
+        const size_t pairs = (chunks + 2 * width - 1) / (2 * width);
+        pool.parallel_for(0, pairs, 1, [&](size_t b, size_t e) {
+            for (size_t p = b; p < e; ++p) {
+                const size_t lo = p * 2 * width;
+                const size_t mid = std::min(chunks, lo + width);
+                const size_t hi = std::min(chunks, lo + 2 * width);
+                if (mid == hi) continue;
+                std::inplace_merge(v.begin() + bounds[lo], v.begin() + bounds[mid], v.begin() + bounds[hi], less);
+            }
+        });
+    }
+}
@@ -3,6 +3,7 @@
 
 #include "ui.h"
 #include "usersettings.h"
+#include "loader.h"
 
 #include "imgui.h"
 #include "backends/imgui_impl_glfw.h"
@@ -19,6 +20,10 @@
 #include <filesystem>
 #include <fstream>
 #include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <iterator>
 
 #if defined(_WIN32)
   #define WIN32_LEAN_AND_MEAN
@@ -26,26 +31,15 @@
   #include <commdlg.h>
 #endif
 
-// Forward declaration of the loader function used by async tasks.
-extern bool load_model_simple(const std::string& path,
-                              std::vector<glm::vec3>& out_positions,
-                              std::vector<glm::vec3>& out_normals,
-                              std::vector<unsigned int>& out_indices,
-                              std::atomic<float>* progress);
-
 static bool g_uiInitialized = false;
 static GLFWwindow* g_window = nullptr;
+static bool g_showInspector = false;
+static bool g_replaying = false;
+static float g_fixedDeltaTime = 0.0f;
 
-bool Ui_Init(GLFWwindow* window, const char* glsl_version)
+std::vector<unsigned char> Ui_ReadFontFile()
 {
-    if (g_uiInitialized) return true;
-    IMGUI_CHECKVERSION();
-    ImGui::CreateContext();
-
-    ImGuiIO& io = ImGui::GetIO();
-    io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
-
-    // Try to load custom font from assets/fonts/Inter_18pt-Regular.ttf relative to exe
+    // assets/fonts/Inter_18pt-Regular.ttf relative to exe
     std::string exeDir;
 #if defined(_WIN32)
     char exePathBuf[MAX_PATH] = {0};
@@ -57,11 +51,27 @@ bool Ui_Init(GLFWwindow* window, const char* glsl_version)
 #endif
 
     std::filesystem::path fontPath = std::filesystem::path(exeDir) / "assets" / "fonts" / "Inter_18pt-Regular.ttf";
-    const std::string customFontPath = fontPath.string();
-    const float customFontSize = 16.0f;
+    std::ifstream in(fontPath, std::ios::binary);
+    if (!in) return {};
+    return std::vector<unsigned char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
 
-    if (std::ifstream(customFontPath).good()) {
-        ImFont* f = io.Fonts->AddFontFromFileTTF(customFontPath.c_str(), customFontSize);
+bool Ui_Init(GLFWwindow* window, const char* glsl_version, std::vector<unsigned char> fontData)
+{
+    if (g_uiInitialized) return true;
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+
+    ImGuiIO& io = ImGui::GetIO();
+    io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
+
+    // ImGui 1.92 bakes glyphs on demand into a dynamic atlas, so adding the font only parses
+    // its tables; the atlas owns (and IM_FREEs) the copy
+    const float customFontSize = 16.0f;
+    if (!fontData.empty()) {
+        void* ttf = IM_ALLOC(fontData.size());
+        std::memcpy(ttf, fontData.data(), fontData.size());
+        ImFont* f = io.Fonts->AddFontFromMemoryTTF(ttf, (int)fontData.size(), customFontSize);
         if (f) io.FontDefault = f;
     }
 
@@ -88,9 +98,16 @@ void Ui_NewFrame()
 {
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
+    if (g_fixedDeltaTime > 0.0f) ImGui::GetIO().DeltaTime = g_fixedDeltaTime;
     ImGui::NewFrame();
 }
 
+void Ui_SetReplayMode(bool replaying, float fixedDeltaTime)
+{
+    g_replaying = replaying;
+    g_fixedDeltaTime = replaying ? fixedDeltaTime : 0.0f;
+}
+
 void Ui_Render()
 {
     ImGui::Render();
@@ -102,9 +119,150 @@ bool Ui_WantsCaptureKeyboard() { return ImGui::GetIO().WantCaptureKeyboard; }
 
 // Internal helpers ----------------------------------------------------------
 
+// Preferences window tabs
+static void draw_general_preferences(UserSettings& userSettings)
+{
+    ImGui::TextUnformatted("Control scheme");
+    int cs = (userSettings.control == ControlScheme::Blender) ? 1 : 0;
+    ImGui::RadioButton("Industry", &cs, 0);
+    ImGui::SameLine();
+    ImGui::RadioButton("Blender", &cs, 1);
+    if (cs == 0) userSettings.control = ControlScheme::Industry;
+    else userSettings.control = ControlScheme::Blender;
+
+    ImGui::Dummy(ImVec2(0.0f, 6.0f));
+    ImGui::TextUnformatted("Rendering");
+    ImGui::Separator();
+    ImGui::Checkbox("Cull back faces of closed meshes", &userSettings.backfaceCulling);
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Only parts the importer found to be closed, consistently wound manifolds are culled.\nOpen surfaces stay two-sided.");
+    }
+}
+
+// applies to the next import
+static void draw_import_preferences(UserSettings& userSettings)
+{
+    int flat = (int)userSettings.flatShading;
+    const char* flatModes[] = { "Off", "Auto (when lossless)", "Always" };
+    ImGui::SetNextItemWidth(200.0f);
+    if (ImGui::Combo("Flat shading", &flat, flatModes, 3)) userSettings.flatShading = (FlatShading)flat;
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Faceted meshes drop per-vertex normals and shade from screen-space derivatives.\nAuto only does this when the file's normals are already per-face.");
+    }
+    ImGui::SetNextItemWidth(200.0f);
+    if (ImGui::InputFloat("Weld tolerance", &userSettings.weldTolerance, 0.0f, 0.0f, "%g")) {
+        userSettings.weldTolerance = std::max(0.0f, userSettings.weldTolerance);
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Merge vertices closer than this distance (model units) on import.\nFixes float noise and patch seams in scans and CAD exports; 0 disables.\nNormals within 30 degrees are averaged across merged vertices, sharper edges stay.");
+    }
+    ImGui::SetNextItemWidth(200.0f);
+    ImGui::SliderFloat("Feature angle", &userSettings.featureAngle, 1.0f, 90.0f, "%.0f deg");
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Edges whose faces meet at a sharper angle count as creases\nfor the feature-edge wireframe; applies to the next import.");
+    }
+    ImGui::Checkbox("Pack small textures into atlases", &userSettings.atlasSmallTextures);
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Merges materials with small textures into shared atlas pages.\nFewer draw calls and binds; applies to the next import.");
+    }
+}
+
+// applied while running (see App::Impl::applyPerformanceSettings)
+static void draw_performance_preferences(UserSettings& userSettings)
+{
+    ImGui::TextUnformatted("Loading");
+    ImGui::Separator();
+    ImGui::Checkbox("Huge pages for loader scratch memory", &userSettings.hugePageScratch);
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Backs large pooled import buffers with transparent huge pages (Linux),\nfewer page faults on big models. No effect on other platforms.");
+    }
+    int priority = (int)userSettings.loaderPriority;
+    const char* priorityModes[] = { "Normal", "Low", "Idle" };
+    ImGui::SetNextItemWidth(200.0f);
+    if (ImGui::Combo("Loader thread priority", &priority, priorityModes, 3)) userSettings.loaderPriority = (ThreadPriority)priority;
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Scheduling class of the import workers. Idle only uses CPU time nothing else wants.\nRaising it again may be refused without privileges on Linux.");
+    }
+    ImGui::Checkbox("Reserve a core for rendering", &userSettings.reserveRenderCore);
+    ImGui::Checkbox("Throttle imports when frames run long", &userSettings.throttleLoads);
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Parks import workers one at a time while the UI thread exceeds the frame budget,\nand brings them back once frames are well under it.");
+    }
+    ImGui::SetNextItemWidth(200.0f);
+    if (ImGui::InputFloat("Frame budget", &userSettings.frameBudgetMs, 0.0f, 0.0f, "%.1f ms")) {
+        userSettings.frameBudgetMs = std::max(1.0f, userSettings.frameBudgetMs);
+    }
+    ImGui::SetNextItemWidth(200.0f);
+    if (ImGui::InputInt("Worker threads", &userSettings.workerThreads)) {
+        userSettings.workerThreads = std::max(0, userSettings.workerThreads);
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Most import workers allowed to run at once, 0 = one per hardware thread.");
+    }
+
+    ImGui::Dummy(ImVec2(0.0f, 6.0f));
+    ImGui::TextUnformatted("Texture cache");
+    ImGui::Separator();
+    char cacheDir[1024];
+    std::snprintf(cacheDir, sizeof(cacheDir), "%s", userSettings.textureCacheOverride.c_str());
+    ImGui::SetNextItemWidth(400.0f);
+    if (ImGui::InputTextWithHint("Cache directory", "cache/textures next to the executable", cacheDir, sizeof(cacheDir))) {
+        userSettings.textureCacheOverride = cacheDir;
+    }
+    ImGui::SetNextItemWidth(200.0f);
+    if (ImGui::InputInt("Cache size limit (MB)", &userSettings.textureCacheMaxMB, 64, 256)) {
+        userSettings.textureCacheMaxMB = std::max(0, userSettings.textureCacheMaxMB);
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Least recently used compressed textures are deleted beyond this, 0 = no limit.");
+    }
+
+    ImGui::Dummy(ImVec2(0.0f, 6.0f));
+    ImGui::TextUnformatted("Rendering");
+    ImGui::Separator();
+    ImGui::SetNextItemWidth(200.0f);
+    if (ImGui::InputInt("VRAM budget for textures (MB)", &userSettings.vramBudgetMB, 64, 256)) {
+        userSettings.vramBudgetMB = std::max(0, userSettings.vramBudgetMB);
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Model textures drop their largest mip levels until they fit, 0 = no limit.");
+    }
+    const int msaaValues[] = { 0, 2, 4, 8, 16 };
+    const char* msaaNames[] = { "Off", "2x", "4x", "8x", "16x" };
+    int msaa = 0;
+    for (int i = 0; i < 5; ++i) if (userSettings.msaaSamples >= msaaValues[i]) msaa = i;
+    ImGui::SetNextItemWidth(200.0f);
+    if (ImGui::Combo("Anti-aliasing (MSAA)", &msaa, msaaNames, 5)) userSettings.msaaSamples = msaaValues[msaa];
+    ImGui::SetNextItemWidth(200.0f);
+    ImGui::SliderFloat("Texture LOD bias", &userSettings.textureLodBias, -4.0f, 4.0f, "%.1f");
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Negative values sharpen model textures, positive values blur them (less texture bandwidth).");
+    }
+    ImGui::SetNextItemWidth(200.0f);
+    ImGui::SliderFloat("Point budget (millions)", &userSettings.pointBudgetM, 0.1f, 100.0f, "%.1f", ImGuiSliderFlags_Logarithmic);
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Point clouds draw at most this many points a frame, coarser levels further away.");
+    }
+    ImGui::SetNextItemWidth(200.0f);
+    ImGui::SliderFloat("Point size", &userSettings.pointSize, 0.25f, 4.0f, "%.2f");
+    ImGui::Checkbox("Vsync", &userSettings.vsync);
+    int latency = (int)userSettings.latencyMode;
+    const char* latencyModes[] = { "Normal", "Low" };
+    ImGui::SetNextItemWidth(200.0f);
+    if (ImGui::Combo("Latency", &latency, latencyModes, 2)) userSettings.latencyMode = (LatencyMode)latency;
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Low waits for the GPU to finish each frame before reading input:\nless input lag, slightly lower frame rate.");
+    }
+    ImGui::Checkbox("Render on demand", &userSettings.renderOnDemand);
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Stops redrawing while there is no input and no import running.\nSaves power; the view still refreshes a few times per second.");
+    }
+}
+
 static void draw_main_menu_bar(std::atomic<bool>& isLoading,
-                              ImportStateRefs& importRefs,
+                              const std::function<void(const std::string&)>& importModel,
                               bool* showWireframe,
+                              DebugView& debugView,
                               UserSettings& userSettings)
 {
     if (!ImGui::BeginMainMenuBar()) return;
@@ -116,6 +274,7 @@ static void draw_main_menu_bar(std::atomic<bool>& isLoading,
 #if defined(_WIN32)
         if (ImGui::BeginMenu("Import")) {
             auto do_open_and_start = [&](const char* filter) {
+                if (g_replaying) return; // the recording replays the import itself
                 char szFile[MAX_PATH] = {};
                 OPENFILENAMEA ofn = {};
                 ofn.lStructSize = sizeof(ofn);
@@ -126,31 +285,7 @@ static void draw_main_menu_bar(std::atomic<bool>& isLoading,
                 ofn.nFilterIndex = 1;
                 ofn.Flags = OFN_FILEMUSTEXIST | OFN_PATHMUSTEXIST | OFN_NOCHANGEDIR;
                 if (GetOpenFileNameA(&ofn)) {
-                    const std::string chosenPath = std::string(ofn.lpstrFile);
-
-                    auto new_positions = std::make_shared<std::vector<glm::vec3>>();
-                    auto new_normals   = std::make_shared<std::vector<glm::vec3>>();
-                    auto new_indices   = std::make_shared<std::vector<unsigned int>>();
-                    auto newModelReady = std::make_shared<std::atomic<bool>>(false);
-                    auto newModelFailed= std::make_shared<std::atomic<bool>>(false);
-                    auto newProgress   = std::make_shared<std::atomic<float>>(0.0f);
-
-                    isLoading.store(true);
-
-                    std::future<void> fut = std::async(std::launch::async,
-                        [chosenPath, new_positions, new_normals, new_indices, newModelReady, newModelFailed, newProgress]() {
-                            bool ok = load_model_simple(chosenPath, *new_positions, *new_normals, *new_indices, newProgress.get());
-                            if (!ok) newModelFailed->store(true);
-                            else newModelReady->store(true);
-                        });
-
-                    if (importRefs.importLoaderFuture) *(importRefs.importLoaderFuture) = std::move(fut);
-                    if (importRefs.import_positions_ptr) *(importRefs.import_positions_ptr) = new_positions;
-                    if (importRefs.import_normals_ptr)   *(importRefs.import_normals_ptr)   = new_normals;
-                    if (importRefs.import_indices_ptr)   *(importRefs.import_indices_ptr)   = new_indices;
-                    if (importRefs.import_ready)         *(importRefs.import_ready)         = newModelReady;
-                    if (importRefs.import_failed)        *(importRefs.import_failed)        = newModelFailed;
-                    if (importRefs.import_progress)      *(importRefs.import_progress)      = newProgress;
+                    importModel(std::string(ofn.lpstrFile));
                 }
             };
 
@@ -172,10 +307,14 @@ static void draw_main_menu_bar(std::atomic<bool>& isLoading,
             if (ImGui::MenuItem("STL...")) {
                 do_open_and_start("STL (Binary/ASCII) (*.stl)\0*.stl;*.STL\0All files\0*.*\0");
             }
+            if (ImGui::MenuItem("Point cloud...")) {
+                do_open_and_start("Point clouds (*.xyz;*.pts;*.ply)\0*.xyz;*.pts;*.ply\0All files\0*.*\0");
+            }
 
             ImGui::EndMenu();
         }
 #else
+        (void)importModel; // no native dialog here; imports come from argv or App::requestImport
         if (ImGui::MenuItem("Import")) {
             ImGui::OpenPopup("Import Not Implemented");
         }
@@ -197,12 +336,32 @@ static void draw_main_menu_bar(std::atomic<bool>& isLoading,
             if (ImGui::MenuItem("Wireframe", "E", &current)) {
                 *showWireframe = current;
             }
+            ImGui::MenuItem("Feature edges only", nullptr, &userSettings.wireframeFeatureEdges);
+            ImGui::MenuItem("Silhouettes", nullptr, &userSettings.showSilhouettes);
+            if (ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("Wireframe draws only boundaries, non-manifold edges and creases\nsharper than the feature angle (Preferences > Import).");
+            }
         } else {
             // If no pointer provided, still show disabled item for parity
             ImGui::BeginDisabled();
             ImGui::MenuItem("Wireframe", "E", false, false);
             ImGui::EndDisabled();
         }
+        if (ImGui::BeginMenu("Debug view")) {
+            const char* names[] = { "Off", "Overdraw", "Triangle size", "Wireframe density" };
+            for (int i = 0; i < 4; ++i) {
+                if (ImGui::MenuItem(names[i], nullptr, (int)debugView == i)) debugView = (DebugView)i;
+            }
+            ImGui::EndMenu();
+        }
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Overdraw: fragments per pixel, blue = 1 up to red = 9+.\nTriangle size: red below a pixel, blue at 4096 px and up.\nWireframe density: edges per pixel, red = 17+.");
+        }
+        ImGui::MenuItem("Quad view", nullptr, &userSettings.quadView);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Top, front, side and perspective views. The view under the cursor\nwhen dragging or zooming is active; the others redraw only when they change.\nDebug views use the single view.");
+        }
+        ImGui::MenuItem("Mesh inspector", nullptr, &g_showInspector);
         ImGui::EndMenu();
     }
     // Edit ->  Preferences
@@ -218,15 +377,21 @@ static void draw_main_menu_bar(std::atomic<bool>& isLoading,
     if (showPrefsWindow) {
         ImGui::SetNextWindowSize(ImVec2(840,840), ImGuiCond_Appearing);
         if (ImGui::Begin("Preferences", &showPrefsWindow, ImGuiWindowFlags_AlwaysAutoResize)) {
-            ImGui::TextUnformatted("General");
-            ImGui::Separator();
-            ImGui::TextUnformatted("Control scheme");
-            int cs = (userSettings.control == ControlScheme::Blender) ? 1 : 0;
-            ImGui::RadioButton("Industry", &cs, 0);
-            ImGui::SameLine();
-            ImGui::RadioButton("Blender", &cs, 1);
-            if (cs == 0) userSettings.control = ControlScheme::Industry;
-            else userSettings.control = ControlScheme::Blender;
+            if (ImGui::BeginTabBar("PreferencesTabs")) {
+                if (ImGui::BeginTabItem("General")) {
+                    draw_general_preferences(userSettings);
+                    ImGui::EndTabItem();
+                }
+                if (ImGui::BeginTabItem("Import")) {
+                    draw_import_preferences(userSettings);
+                    ImGui::EndTabItem();
+                }
+                if (ImGui::BeginTabItem("Performance")) {
+                    draw_performance_preferences(userSettings);
+                    ImGui::EndTabItem();
+                }
+                ImGui::EndTabBar();
+            }
 
             ImGui::Dummy(ImVec2(0.0f, 6.0f));
             if (ImGui::Button("Save")) {
@@ -250,8 +415,7 @@ static void draw_view_controls_panel(glm::vec3& lightDir,
                                      float& lightIntensity,
                                      glm::vec3& lightColor,
                                      bool& staticShadows,
-                                     size_t vertexCount,
-                                     size_t triCount)
+                                     const ModelStats& stats)
 {
     const ImVec2 panelSize(340.0f, 300.0f);
     const ImVec2 margin(18.0f, 8.0f);
@@ -281,8 +445,107 @@ static void draw_view_controls_panel(glm::vec3& lightDir,
     ImGui::SetWindowFontScale(1.0f);
     ImGui::Separator();
 
-    ImGui::Text("Vertices: %zu", vertexCount);
-    ImGui::SameLine(); ImGui::Text("Triangles: %zu", triCount);
+    ImGui::Text("Vertices: %zu", stats.vertexCount);
+    ImGui::SameLine(); ImGui::Text("Triangles: %zu", stats.triCount);
+    const ViewLayoutStats& vs = stats.views;
+    if (vs.views > 1) {
+        ImGui::TextDisabled("Views: %u, %u redrawn; batches %zu -> %zu visible -> %zu/%zu/%zu/%zu",
+                            vs.views, vs.redrawn, vs.batches, vs.sharedBatches,
+                            vs.viewBatches[0], vs.viewBatches[1], vs.viewBatches[2], vs.viewBatches[3]);
+    }
+    const PointCloudStats& pc = stats.points;
+    if (pc.points > 0) {
+        ImGui::Text("Points: %zu", pc.points);
+        ImGui::SameLine(); ImGui::Text("Octree: %zu nodes, %u levels", pc.nodes, pc.depth + 1);
+        ImGui::TextDisabled("Drawn: %zu points in %zu nodes%s", pc.drawnPoints, pc.drawnNodes, pc.streaming ? ", streaming" : "");
+        ImGui::TextDisabled("Resident: %zu nodes, %.1f MB", pc.residentNodes, pc.residentBytes / (1024.0 * 1024.0));
+    }
+    if (stats.weld.applied) {
+        ImGui::TextDisabled("Welded: %zu positions moved, %zu normals smoothed, %zu -> %zu vertices",
+                            stats.weld.positionsMerged, stats.weld.normalsSmoothed,
+                            stats.weld.verticesBefore, stats.weld.verticesAfter);
+    }
+    const CleanupReport& cr = stats.cleanup;
+    if (cr.invalidTriangles + cr.degenerateTriangles + cr.duplicateTriangles + cr.unusedVertices > 0) {
+        ImGui::TextDisabled("Cleanup: -%zu invalid, -%zu degenerate, -%zu duplicate tris, -%zu unused verts",
+                            cr.invalidTriangles, cr.degenerateTriangles, cr.duplicateTriangles, cr.unusedVertices);
+    }
+    if (stats.orient.components > 0) {
+        ImGui::TextDisabled("Closed: %zu/%zu parts, %zu/%zu tris cullable%s",
+                            stats.orient.closedComponents, stats.orient.components,
+                            stats.orient.cullableTriangles, stats.triCount,
+                            stats.orient.flippedTriangles ? " (winding fixed)" : "");
+    }
+    if (stats.topology.edges > 0) {
+        ImGui::TextDisabled("Edges: %zu (%zu feature, %zu boundary, %zu non-manifold), %zu parts",
+                            stats.topology.edges, stats.topology.featureEdges, stats.topology.boundaryEdges,
+                            stats.topology.nonManifoldEdges, stats.topology.components);
+    }
+    if (stats.silhouetteEdges > 0) {
+        if (stats.silhouetteMs >= 0.0) {
+            ImGui::TextDisabled("Silhouette: %s, %zu edges, %.3f ms GPU", stats.silhouetteCompute ? "compute" : "geometry shader",
+                                stats.silhouetteEdges, stats.silhouetteMs);
+        } else {
+            ImGui::TextDisabled("Silhouette: %s, %zu edges", stats.silhouetteCompute ? "compute" : "geometry shader",
+                                stats.silhouetteEdges);
+        }
+    }
+    if (stats.flat.applied) {
+        ImGui::TextDisabled("Flat shading%s: %zu -> %zu vertices (VBO %.1f MB)",
+                            stats.flat.lossless ? " (lossless)" : "",
+                            stats.flat.verticesBefore, stats.flat.verticesAfter,
+                            stats.vertexBytes / (1024.0 * 1024.0));
+    }
+    ImGui::Text("Draw batches: %zu", stats.batchCount);
+    ImGui::SameLine(); ImGui::Text("Textures: %zu (%.1f MB)", stats.textureCount, stats.textureBytes / (1024.0 * 1024.0));
+    if (stats.textureMipsSkipped > 0) {
+        ImGui::TextDisabled("VRAM budget: top %zu mips skipped, %.1f MB on the GPU",
+                            stats.textureMipsSkipped, stats.textureGpuBytes / (1024.0 * 1024.0));
+    }
+    if (stats.textureCache.hits || stats.textureCache.queued) {
+        ImGui::TextDisabled("Texture cache: %u compressed hits, %u queued", stats.textureCache.hits, stats.textureCache.queued);
+    }
+    if (stats.atlas.built) {
+        ImGui::TextDisabled("Atlas: %u pages, draws %u -> %u, binds %u -> %u",
+                            stats.atlas.pages, stats.atlas.batchesBefore, stats.atlas.batchesAfter,
+                            stats.atlas.bindsBefore, stats.atlas.bindsAfter);
+    }
+    if (stats.timings.totalSeconds > 0.0) {
+        ImGui::TextDisabled("Load: %.0f ms (parse %.0f, textures %.0f, post %.0f), %llu page faults",
+                            stats.timings.totalSeconds * 1000.0, stats.timings.parseSeconds * 1000.0,
+                            stats.timings.textureSeconds * 1000.0, stats.timings.postSeconds * 1000.0,
+                            (unsigned long long)stats.timings.pageFaults);
+    }
+    if (!stats.startup.empty()) ImGui::TextDisabled("Startup: %s", stats.startup.c_str());
+    const LoaderQosStats& qos = stats.loaderQos;
+    if (qos.workers > 0) {
+        const char* priorityNames[] = { "normal", "low", "idle" };
+        ImGui::TextDisabled("Loader: %u/%u workers, %s priority%s%s, frame %.1f ms",
+                            qos.activeWorkers, qos.workers, priorityNames[(int)qos.priority],
+                            qos.priorityApplied ? "" : " (refused)", qos.throttled ? ", throttled" : "",
+                            qos.frameMs);
+    }
+    ImGui::TextDisabled("MSAA: %s", stats.msaaSamples ? (std::to_string(stats.msaaSamples) + "x").c_str() : "off");
+    const DebugViewMetrics& dv = stats.debugView;
+    if (dv.mode != DebugView::Off) {
+        if (!dv.supported) {
+            ImGui::TextDisabled("Debug view: no GPU counters (needs GL 4.3)");
+        } else if (!dv.measured) {
+            ImGui::TextDisabled("Debug view: counting...");
+        } else if (dv.mode == DebugView::TriangleSize) {
+            const double n = dv.trianglesInView ? (double)dv.trianglesInView : 1.0;
+            ImGui::TextDisabled("Triangles in view: %llu, %.1f%% sub-pixel, %.1f%% under 4 px, %.1f%% under 16 px",
+                                (unsigned long long)dv.trianglesInView, 100.0 * dv.sizeBuckets[0] / n,
+                                100.0 * (dv.sizeBuckets[0] + dv.sizeBuckets[1]) / n,
+                                100.0 * (dv.sizeBuckets[0] + dv.sizeBuckets[1] + dv.sizeBuckets[2]) / n);
+        } else {
+            const double covered = dv.coveredPixels ? (double)dv.coveredPixels : 1.0;
+            ImGui::TextDisabled("%s: %.2f avg over %.1f%% of the view, %.1f%% of it at 4+",
+                                dv.mode == DebugView::Overdraw ? "Overdraw" : "Edges per pixel",
+                                dv.fragments / covered, dv.pixels ? 100.0 * dv.coveredPixels / dv.pixels : 0.0,
+                                100.0 * dv.hotPixels / covered);
+        }
+    }
 
     ImGui::Dummy(ImVec2(0.0f, 6.0f));
     ImGui::Separator();
@@ -343,8 +606,7 @@ static void draw_view_controls_panel(glm::vec3& lightDir,
 
 static void draw_loading_modal(GLFWwindow* win,
                                const std::atomic<bool>& isLoading,
-                               const std::shared_ptr<std::atomic<float>>& import_progress_ptr,
-                               const std::atomic<float>& loadProgress)
+                               const Loader& loader)
 {
     if (!isLoading.load()) return;
 
@@ -369,10 +631,7 @@ static void draw_loading_modal(GLFWwindow* win,
     ImGui::TextColored(ImVec4(0.9f,0.9f,0.9f,1.0f), "Loading model...");
     ImGui::Dummy(ImVec2(0.0f, 6.0f));
 
-    float frac = 0.0f;
-    if (import_progress_ptr) frac = import_progress_ptr->load();
-    else frac = loadProgress.load();
-    frac = glm::clamp(frac, 0.0f, 1.0f);
+    float frac = glm::clamp(loader.progress(), 0.0f, 1.0f);
 
     ImGui::ProgressBar(frac, ImVec2((float)boxW - 24.0f, 18.0f));
     ImGui::Dummy(ImVec2(0.0f, 6.0f));
@@ -383,18 +642,72 @@ static void draw_loading_modal(GLFWwindow* win,
 
 // Public composite frame draw ------------------------------------------------
 
+// Efficiency metrics of the loaded mesh (inspector.h); the same numbers as the --inspect report
+static void draw_inspector_window(const ModelStats& stats)
+{
+    if (!g_showInspector) return;
+    ImGui::SetNextWindowSize(ImVec2(420, 0), ImGuiCond_Appearing);
+    if (!ImGui::Begin("Mesh inspector", &g_showInspector, ImGuiWindowFlags_AlwaysAutoResize)) {
+        ImGui::End();
+        return;
+    }
+    if (!stats.inspected) {
+        ImGui::TextDisabled(stats.inspecting ? "Inspecting..." : "Import a model to inspect it (the built-in model has no source mesh).");
+        ImGui::End();
+        return;
+    }
+    const MeshInspection& r = stats.inspection;
+    ImGui::Text("%zu vertices, %zu triangles", r.vertices, r.triangles);
+    ImGui::Text("Unique positions: %zu (%.2f vertices each)", r.uniquePositions, r.splitRatio);
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Vertices split along normal and UV seams. Close to 1 is best;\nflat shading or per-face UVs push it to 3 and up.");
+    }
+
+    ImGui::SeparatorText("Vertex cache (FIFO)");
+    if (ImGui::BeginTable("inspect_cache", 3, ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("Entries");
+        ImGui::TableSetupColumn("ACMR");
+        ImGui::TableSetupColumn("ATVR");
+        ImGui::TableHeadersRow();
+        for (int i = 0; i < 3; ++i) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::Text("%u", kInspectCacheSizes[i]);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", r.acmr[i]);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", r.atvr[i]);
+        }
+        ImGui::EndTable();
+    }
+    ImGui::TextDisabled("ACMR: misses per triangle (0.5-0.7 is well ordered, 3 is no reuse)");
+    ImGui::Text("Overdraw: %.2f fragments per pixel (axis views)", r.overdraw);
+
+    ImGui::SeparatorText("Topology");
+    ImGui::Text("%s, %s", r.manifold() ? "Manifold" : "Non-manifold", r.closed() ? "closed" : "open");
+    ImGui::Text("Components: %zu (%zu closed)", r.components, r.closedComponents);
+    ImGui::Text("Boundary edges: %zu, non-manifold edges: %zu", r.boundaryEdges, r.nonManifoldEdges);
+    ImGui::Text("Degenerate triangles: %zu removed, %zu zero-area left", r.degenerateRemoved, r.zeroAreaTriangles);
+
+    ImGui::SeparatorText("Geometry");
+    ImGui::Text("Bounds: (%.3g, %.3g, %.3g) - (%.3g, %.3g, %.3g)",
+                r.boundsMin.x, r.boundsMin.y, r.boundsMin.z, r.boundsMax.x, r.boundsMax.y, r.boundsMax.z);
+    ImGui::Text("Surface area: %.4g", r.surfaceArea);
+    if (r.closed()) ImGui::Text("Volume: %.4g", r.volume);
+    else ImGui::TextDisabled("Volume: n/a (open mesh)");
+    if (r.seconds > 0.0) ImGui::TextDisabled("Inspected in %.1f ms", r.seconds * 1000.0);
+    else ImGui::TextDisabled("Cached result");
+    ImGui::End();
+}
+
 void Ui_FrameDraw(GLFWwindow* win,
-                  const std::atomic<float>& loadProgress,
-                  const std::shared_ptr<std::atomic<float>>& import_progress_ptr,
-                  ImportStateRefs& importRefs,
+                  Loader& loader,
+                  const std::function<void(const std::string&)>& importModel,
                   glm::vec3& lightDir,
                   float& lightIntensity,
                   glm::vec3& lightColor,
                   bool& staticShadows,
                   bool* showWireframe,
+                  DebugView& debugView,
                   UserSettings& userSettings,
-                  size_t vertexCount,
-                  size_t triCount)
+                  const ModelStats& stats)
 {
     if (!g_uiInitialized) return;
 
@@ -421,14 +734,15 @@ void Ui_FrameDraw(GLFWwindow* win,
     style.WindowRounding = 6.0f;
     style.ItemSpacing = ImVec2(8,6);
 
-    // Main menu bar this may start background imports via importRefs
-    draw_main_menu_bar(isLoading, importRefs, showWireframe, userSettings);
+    // Main menu bar, may start background imports on the loader
+    draw_main_menu_bar(isLoading, importModel, showWireframe, debugView, userSettings);
 
     // Draw the view controls panel with app-supplied state so it appears and can mutate app state
-    draw_view_controls_panel(lightDir, lightIntensity, lightColor, staticShadows, vertexCount, triCount);
+    draw_view_controls_panel(lightDir, lightIntensity, lightColor, staticShadows, stats);
+    draw_inspector_window(stats);
 
-    // Loading modal: uses import_progress_ptr when available, otherwise uses loadProgress
-    draw_loading_modal(win, isLoading, import_progress_ptr, loadProgress);
+    // Loading modal with the latest request's progress
+    draw_loading_modal(win, isLoading, loader);
 
     Ui_Render();
 }
@@ -12,36 +12,82 @@
 
 #include "globals.h"
 #include "usersettings.h"
+#include "loader.h"
+#include "debugview.h"
+#include "pointsplat.h"
+#include "viewports.h"
+#include "inspector.h"
 
-bool Ui_Init(GLFWwindow* window, const char* glsl_version = "#version 330");
+// Bytes of the UI font file (assets/fonts/Inter_18pt-Regular.ttf next to the exe), empty when it
+// is missing. No ImGui calls, so startup reads it on a worker while the window comes up.
+std::vector<unsigned char> Ui_ReadFontFile();
+
+// fontData: result of Ui_ReadFontFile; the default ImGui font is used when empty
+bool Ui_Init(GLFWwindow* window, const char* glsl_version = "#version 330",
+             std::vector<unsigned char> fontData = {});
 void Ui_Shutdown();
 void Ui_NewFrame();
 void Ui_Render();
 
-// Import state references used by UI to hand imported buffers back to the app
-struct ImportStateRefs {
-    std::future<void>* importLoaderFuture = nullptr;
-    std::shared_ptr<std::vector<glm::vec3>>* import_positions_ptr = nullptr;
-    std::shared_ptr<std::vector<glm::vec3>>* import_normals_ptr = nullptr;
-    std::shared_ptr<std::vector<unsigned int>>* import_indices_ptr = nullptr;
-    std::shared_ptr<std::atomic<bool>>* import_ready = nullptr;
-    std::shared_ptr<std::atomic<bool>>* import_failed = nullptr;
-    std::shared_ptr<std::atomic<float>>* import_progress = nullptr;
+// Replaying recorded input: File > Import skips the native dialog (the recording carries the
+// chosen path), and a fixedDeltaTime > 0 replaces ImGui's wall-clock frame delta.
+void Ui_SetReplayMode(bool replaying, float fixedDeltaTime);
+
+// Loader QoS as applied on the latest frame
+struct LoaderQosStats {
+    unsigned workers = 0;          // pool size
+    unsigned activeWorkers = 0;    // workers allowed to take jobs
+    ThreadPriority priority = ThreadPriority::Normal;
+    bool priorityApplied = true;
+    bool throttled = false;        // fewer active workers than the cap because frames ran long
+    double frameMs = 0.0;          // smoothed main-thread time per frame, swap excluded
+};
+
+// Numbers about the uploaded model shown in the view controls panel
+struct ModelStats {
+    size_t vertexCount = 0;
+    size_t triCount = 0;
+    size_t batchCount = 0;
+    size_t textureCount = 0;
+    size_t textureBytes = 0;
+    size_t textureGpuBytes = 0;     // after mips skipped for the VRAM budget
+    size_t textureMipsSkipped = 0;
+    size_t vertexBytes = 0;
+    AtlasReport atlas;
+    FlatShadingReport flat;
+    WeldReport weld;
+    CleanupReport cleanup;
+    OrientationReport orient;
+    TopologyReport topology;
+    size_t silhouetteEdges = 0;
+    bool silhouetteCompute = false; // else geometry shader fallback
+    double silhouetteMs = -1.0;     // GPU time of the compute pass, -1 when not measured
+    TextureCacheReport textureCache;
+    LoadTimings timings;
+    LoaderQosStats loaderQos;       // refreshed every frame, not per model
+    int msaaSamples = 0;            // in use, refreshed every frame
+    DebugViewMetrics debugView;     // counters of the active debug view
+    PointCloudStats points;         // point cloud LOD, refreshed every frame
+    ViewLayoutStats views;          // quad view culling and caching, refreshed every frame
+    MeshInspection inspection;      // filled in by a pool job shortly after the load
+    std::string startup;            // time to first frame by step, set once per run
+    bool inspecting = false;        // job still running
+    bool inspected = false;
 };
 
-// Ui_FrameDraw: draw all UI elements for the frame, mutating app view state via references
+// Ui_FrameDraw: draw all UI elements for the frame, mutating app view state via references.
+// File > Import hands the chosen path to importModel; the loading modal shows `loader` progress.
 void Ui_FrameDraw(GLFWwindow* win,
-                  const std::atomic<float>& loadProgress,
-                  const std::shared_ptr<std::atomic<float>>& import_progress_ptr,
-                  ImportStateRefs& importRefs,
+                  Loader& loader,
+                  const std::function<void(const std::string&)>& importModel,
                   glm::vec3& lightDir,
                   float& lightIntensity,
                   glm::vec3& lightColor,
                   bool& staticShadows,
                   bool* showWireframe,
+                  DebugView& debugView,
                   UserSettings& userSettings,
-                  size_t vertexCount,
-                  size_t triCount);
+                  const ModelStats& stats);
 
 bool Ui_WantsCaptureMouse();
 bool Ui_WantsCaptureKeyboard();
@@ -5,6 +5,12 @@
 #include <algorithm>
 #include <filesystem>
 #include <cctype>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <map>
+#include <iostream>
+#include <initializer_list>
 
 std::string UserSettings::controlSchemeToString(ControlScheme s) {
     switch (s) {
@@ -21,44 +27,344 @@ ControlScheme UserSettings::controlSchemeFromString(const std::string& s) {
     return ControlScheme::Industry;
 }
 
+std::string UserSettings::flatShadingToString(FlatShading f) {
+    switch (f) {
+    case FlatShading::Off: return "off";
+    case FlatShading::On: return "on";
+    case FlatShading::Auto:
+    default: return "auto";
+    }
+}
+
+FlatShading UserSettings::flatShadingFromString(const std::string& s) {
+    if (s == "off") return FlatShading::Off;
+    if (s == "on") return FlatShading::On;
+    return FlatShading::Auto;
+}
+
+std::string UserSettings::threadPriorityToString(ThreadPriority p) {
+    switch (p) {
+    case ThreadPriority::Normal: return "normal";
+    case ThreadPriority::Idle: return "idle";
+    case ThreadPriority::Low:
+    default: return "low";
+    }
+}
+
+ThreadPriority UserSettings::threadPriorityFromString(const std::string& s) {
+    if (s == "normal") return ThreadPriority::Normal;
+    if (s == "idle") return ThreadPriority::Idle;
+    return ThreadPriority::Low;
+}
+
+std::string UserSettings::latencyModeToString(LatencyMode m) {
+    return m == LatencyMode::Low ? "low" : "normal";
+}
+
+LatencyMode UserSettings::latencyModeFromString(const std::string& s) {
+    return s == "low" ? LatencyMode::Low : LatencyMode::Normal;
+}
+
 static std::string defaultSettingsPath() {
     std::filesystem::path p = std::filesystem::current_path();
     p /= "usersettings.json";
     return p.string();
 }
 
+// ---- settings JSON --------------------------------------------------------------------------
+
+// Scalars of a parsed settings document, keyed by path ("performance.vsync"). Arrays are parsed
+// and skipped; nothing in the schema uses them.
+struct JsonScalar {
+    enum Kind { Null, Bool, Number, String } kind = Null;
+    bool b = false;
+    double n = 0.0;
+    std::string s;
+};
+using JsonMap = std::map<std::string, JsonScalar>;
+
+// small recursive-descent reader; fails on anything that is not JSON
+struct JsonReader {
+    const std::string& text;
+    size_t pos = 0;
+    JsonMap& out;
+
+    void skipSpace() { while (pos < text.size() && std::isspace((unsigned char)text[pos])) ++pos; }
+    bool eat(char c) { skipSpace(); if (pos < text.size() && text[pos] == c) { ++pos; return true; } return false; }
+
+    static void appendUtf8(std::string& s, uint32_t cp) {
+        if (cp < 0x80) { s += (char)cp; }
+        else if (cp < 0x800) { s += (char)(0xC0 | (cp >> 6)); s += (char)(0x80 | (cp & 0x3F)); }
+        else if (cp < 0x10000) { s += (char)(0xE0 | (cp >> 12)); s += (char)(0x80 | ((cp >> 6) & 0x3F)); s += (char)(0x80 | (cp & 0x3F)); }
+        else { s += (char)(0xF0 | (cp >> 18)); s += (char)(0x80 | ((cp >> 12) & 0x3F)); s += (char)(0x80 | ((cp >> 6) & 0x3F)); s += (char)(0x80 | (cp & 0x3F)); }
+    }
+
+    bool hex4(uint32_t& cp) {
+        if (pos + 4 > text.size()) return false;
+        cp = 0;
+        for (int i = 0; i < 4; ++i) {
+            const char c = text[pos++];
+            cp <<= 4;
+            if (c >= '0' && c <= '9') cp |= uint32_t(c - '0');
+            else if (c >= 'a' && c <= 'f') cp |= uint32_t(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') cp |= uint32_t(c - 'A' + 10);
+            else return false;
+        }
+        return true;
+    }
+
+    bool string(std::string& s) {
+        if (!eat('"')) return false;
+        while (pos < text.size()) {
+            const char c = text[pos++];
+            if (c == '"') return true;
+            if ((unsigned char)c < 0x20) return false;
+            if (c != '\\') { s += c; continue; }
+            if (pos >= text.size()) return false;
+            const char e = text[pos++];
+            switch (e) {
+            case '"': s += '"'; break;
+            case '\\': s += '\\'; break;
+            case '/': s += '/'; break;
+            case 'b': s += '\b'; break;
+            case 'f': s += '\f'; break;
+            case 'n': s += '\n'; break;
+            case 'r': s += '\r'; break;
+            case 't': s += '\t'; break;
+            case 'u': {
+                uint32_t cp = 0;
+                if (!hex4(cp)) return false;
+                if (cp >= 0xD800 && cp < 0xDC00 && text.compare(pos, 2, "\\u") == 0) {
+                    pos += 2;
+                    uint32_t lo = 0;
+                    if (!hex4(lo) || lo < 0xDC00 || lo >= 0xE000) return false;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                }
+                appendUtf8(s, cp);
+                break;
+            }
+            default: return false;
+            }
+        }
+        return false;
+    }
+
+    bool value(const std::string& path) {
+        skipSpace();
+        if (pos >= text.size()) return false;
+        const char c = text[pos];
+        JsonScalar v;
+        if (c == '{') return object(path);
+        if (c == '[') {
+            ++pos;
+            if (eat(']')) return true;
+            do { if (!value(path + "[]")) return false; } while (eat(','));
+            return eat(']');
+        }
+        if (c == '"') {
+            v.kind = JsonScalar::String;
+            if (!string(v.s)) return false;
+        } else if (text.compare(pos, 4, "true") == 0) {
+            v.kind = JsonScalar::Bool; v.b = true; pos += 4;
+        } else if (text.compare(pos, 5, "false") == 0) {
+            v.kind = JsonScalar::Bool; v.b = false; pos += 5;
+        } else if (text.compare(pos, 4, "null") == 0) {
+            pos += 4;
+        } else {
+            const char* begin = text.c_str() + pos;
+            char* end = nullptr;
+            v.kind = JsonScalar::Number;
+            v.n = std::strtod(begin, &end);
+            if (end == begin) return false;
+            pos += size_t(end - begin);
+        }
+        if (path.find("[]") == std::string::npos) out[path] = v;
+        return true;
+    }
+
+    bool object(const std::string& path) {
+        if (!eat('{')) return false;
+        if (eat('}')) return true;
+        do {
+            std::string key;
+            skipSpace();
+            if (!string(key) || !eat(':')) return false;
+            if (!value(path.empty() ? key : path + "." + key)) return false;
+        } while (eat(','));
+        return eat('}');
+    }
+
+    bool document() {
+        if (!object(std::string())) return false;
+        skipSpace();
+        return pos == text.size();
+    }
+};
+
+// first of the given keys present in the document (new location first, then older ones)
+static const JsonScalar* findKey(const JsonMap& doc, std::initializer_list<const char*> keys, JsonScalar::Kind kind) {
+    for (const char* k : keys) {
+        auto it = doc.find(k);
+        if (it != doc.end() && it->second.kind == kind) return &it->second;
+    }
+    return nullptr;
+}
+
+static void readBool(const JsonMap& doc, std::initializer_list<const char*> keys, bool& out) {
+    if (const JsonScalar* v = findKey(doc, keys, JsonScalar::Bool)) out = v->b;
+}
+
+static void readFloat(const JsonMap& doc, std::initializer_list<const char*> keys, float& out) {
+    if (const JsonScalar* v = findKey(doc, keys, JsonScalar::Number)) out = (float)v->n;
+}
+
+static void readInt(const JsonMap& doc, std::initializer_list<const char*> keys, int& out) {
+    if (const JsonScalar* v = findKey(doc, keys, JsonScalar::Number)) out = (int)std::lround(v->n);
+}
+
+static bool readString(const JsonMap& doc, std::initializer_list<const char*> keys, std::string& out) {
+    const JsonScalar* v = findKey(doc, keys, JsonScalar::String);
+    if (v) out = v->s;
+    return v != nullptr;
+}
+
+static std::string jsonString(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if ((unsigned char)c < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", (unsigned)(unsigned char)c);
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+    }
+    return out + "\"";
+}
+
+static const char* jsonBool(bool b) { return b ? "true" : "false"; }
+
+LoadOptions UserSettings::loadOptions() const {
+    LoadOptions o;
+    o.atlasSmallTextures = atlasSmallTextures;
+    o.flatShading = flatShading;
+    o.weldTolerance = std::max(0.0f, weldTolerance);
+    o.featureAngle = featureAngle;
+    o.hugePageScratch = hugePageScratch;
+    o.textureCacheDir = textureCacheDir;
+    return o;
+}
+
 bool UserSettings::load() {
     if (filePath.empty()) filePath = defaultSettingsPath();
     std::ifstream in(filePath);
     if (!in) return false;
     std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
-    size_t pos = content.find("control_scheme");
-    if (pos != std::string::npos) {
-        size_t colon = content.find(':', pos);
-        if (colon != std::string::npos) {
-            size_t quote = content.find('"', colon);
-            if (quote != std::string::npos) {
-                size_t quote2 = content.find('"', quote + 1);
-                if (quote2 != std::string::npos && quote2 > quote) {
-                    std::string val = content.substr(quote + 1, quote2 - (quote + 1));
-                    control = controlSchemeFromString(val);
-                    return true;
-                }
-            }
-        }
+
+    JsonMap doc;
+    JsonReader reader{ content, 0, doc };
+    if (!reader.document()) {
+        std::cerr << "usersettings: " << filePath << " is not valid JSON (offset " << reader.pos << "), keeping defaults\n";
+        return false;
     }
-    if (content.find("blender") != std::string::npos) {
-        control = ControlScheme::Blender;
-        return true;
+    int version = 1;
+    readInt(doc, { "schema_version" }, version);
+    if (version > schemaVersion) {
+        std::cerr << "usersettings: " << filePath << " is schema " << version << ", newer than " << schemaVersion << "; reading known keys\n";
     }
-    return false;
+
+    std::string text;
+    if (readString(doc, { "control_scheme" }, text)) control = controlSchemeFromString(text);
+    readBool(doc, { "atlas_small_textures" }, atlasSmallTextures);
+    if (readString(doc, { "flat_shading" }, text)) flatShading = flatShadingFromString(text);
+    readBool(doc, { "backface_culling" }, backfaceCulling);
+    readFloat(doc, { "weld_tolerance" }, weldTolerance);
+    readFloat(doc, { "feature_angle" }, featureAngle);
+    readBool(doc, { "wireframe_feature_edges" }, wireframeFeatureEdges);
+    readBool(doc, { "show_silhouettes" }, showSilhouettes);
+    readBool(doc, { "quad_view" }, quadView);
+
+    // version 1 kept these at the top level
+    readBool(doc, { "performance.huge_page_scratch", "huge_page_scratch" }, hugePageScratch);
+    if (readString(doc, { "performance.loader_priority", "loader_priority" }, text)) loaderPriority = threadPriorityFromString(text);
+    readBool(doc, { "performance.reserve_render_core", "reserve_render_core" }, reserveRenderCore);
+    readBool(doc, { "performance.throttle_loads", "throttle_loads" }, throttleLoads);
+    readFloat(doc, { "performance.frame_budget_ms", "frame_budget_ms" }, frameBudgetMs);
+    readInt(doc, { "performance.worker_threads" }, workerThreads);
+    readString(doc, { "performance.texture_cache_dir" }, textureCacheOverride);
+    readInt(doc, { "performance.texture_cache_max_mb" }, textureCacheMaxMB);
+    readInt(doc, { "performance.vram_budget_mb" }, vramBudgetMB);
+    readInt(doc, { "performance.msaa_samples" }, msaaSamples);
+    readBool(doc, { "performance.vsync" }, vsync);
+    if (readString(doc, { "performance.latency_mode" }, text)) latencyMode = latencyModeFromString(text);
+    readBool(doc, { "performance.render_on_demand" }, renderOnDemand);
+    readFloat(doc, { "performance.texture_lod_bias" }, textureLodBias);
+    readFloat(doc, { "performance.point_budget_m" }, pointBudgetM);
+    readFloat(doc, { "performance.point_size" }, pointSize);
+
+    workerThreads = std::max(0, workerThreads);
+    textureCacheMaxMB = std::max(0, textureCacheMaxMB);
+    vramBudgetMB = std::max(0, vramBudgetMB);
+    msaaSamples = std::clamp(msaaSamples, 0, 32);
+    frameBudgetMs = std::max(1.0f, frameBudgetMs);
+    textureLodBias = std::clamp(textureLodBias, -4.0f, 4.0f);
+    pointBudgetM = std::clamp(pointBudgetM, 0.1f, 100.0f);
+    pointSize = std::clamp(pointSize, 0.25f, 4.0f);
+    return true;
 }
 
 bool UserSettings::save() {
     if (filePath.empty()) filePath = defaultSettingsPath();
-    std::ofstream out(filePath, std::ios::trunc);
-    if (!out) return false;
-    out << "{\n  \"control_scheme\": \"" << controlSchemeToString(control) << "\"\n}\n";
-    out.close();
+    // write a temp file and rename, so a crash mid-write never leaves a truncated settings file
+    const std::string tmpPath = filePath + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::trunc);
+        if (!out) return false;
+        out << "{\n"
+            << "  \"schema_version\": " << schemaVersion << ",\n"
+            << "  \"control_scheme\": " << jsonString(controlSchemeToString(control)) << ",\n"
+            << "  \"atlas_small_textures\": " << jsonBool(atlasSmallTextures) << ",\n"
+            << "  \"flat_shading\": " << jsonString(flatShadingToString(flatShading)) << ",\n"
+            << "  \"backface_culling\": " << jsonBool(backfaceCulling) << ",\n"
+            << "  \"weld_tolerance\": " << weldTolerance << ",\n"
+            << "  \"feature_angle\": " << featureAngle << ",\n"
+            << "  \"wireframe_feature_edges\": " << jsonBool(wireframeFeatureEdges) << ",\n"
+            << "  \"show_silhouettes\": " << jsonBool(showSilhouettes) << ",\n"
+            << "  \"quad_view\": " << jsonBool(quadView) << ",\n"
+            << "  \"performance\": {\n"
+            << "    \"huge_page_scratch\": " << jsonBool(hugePageScratch) << ",\n"
+            << "    \"loader_priority\": " << jsonString(threadPriorityToString(loaderPriority)) << ",\n"
+            << "    \"reserve_render_core\": " << jsonBool(reserveRenderCore) << ",\n"
+            << "    \"throttle_loads\": " << jsonBool(throttleLoads) << ",\n"
+            << "    \"frame_budget_ms\": " << frameBudgetMs << ",\n"
+            << "    \"worker_threads\": " << workerThreads << ",\n"
+            << "    \"texture_cache_dir\": " << jsonString(textureCacheOverride) << ",\n"
+            << "    \"texture_cache_max_mb\": " << textureCacheMaxMB << ",\n"
+            << "    \"vram_budget_mb\": " << vramBudgetMB << ",\n"
+            << "    \"msaa_samples\": " << msaaSamples << ",\n"
+            << "    \"vsync\": " << jsonBool(vsync) << ",\n"
+            << "    \"latency_mode\": " << jsonString(latencyModeToString(latencyMode)) << ",\n"
+            << "    \"render_on_demand\": " << jsonBool(renderOnDemand) << ",\n"
+            << "    \"texture_lod_bias\": " << textureLodBias << ",\n"
+            << "    \"point_budget_m\": " << pointBudgetM << ",\n"
+            << "    \"point_size\": " << pointSize << "\n"
+            << "  }\n"
+            << "}\n";
+        if (!out) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, filePath, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
     return true;
 }
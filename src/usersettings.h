@@ -1,18 +1,71 @@
 #pragma once
 #include <string>
 
+#include "loader.h"
+#include "threadpool.h"
+
 enum class ControlScheme {
     Industry,
     Blender
 };
 
+// Low waits for the GPU to finish the previous frame before reading input (one frame in flight)
+enum class LatencyMode {
+    Normal,
+    Low
+};
+
 struct UserSettings {
     ControlScheme control = ControlScheme::Industry;
+    bool atlasSmallTextures = false;
+    FlatShading flatShading = FlatShading::Auto;
+    bool backfaceCulling = true;
+    float weldTolerance = 0.0f; // model units, 0 = exact dedup only
+    float featureAngle = 30.0f; // crease threshold in degrees
+    bool wireframeFeatureEdges = false;
+    bool showSilhouettes = false;
+    bool quadView = false;      // top / front / side / perspective layout
+
+    // performance, written under "performance" and applied while running
+    bool hugePageScratch = false;
+    ThreadPriority loaderPriority = ThreadPriority::Low;
+    bool reserveRenderCore = true;  // one pool worker stays parked so rendering keeps a core
+    bool throttleLoads = true;      // park more workers while frames run over budget
+    float frameBudgetMs = 16.7f;
+    int workerThreads = 0;          // loader workers allowed at most, 0 = one per hardware thread
+    std::string textureCacheOverride; // compressed texture cache location, empty = next to the exe
+    int textureCacheMaxMB = 1024;   // oldest cache entries are evicted beyond this, 0 = unlimited
+    int vramBudgetMB = 0;           // model textures skip top mips to fit, 0 = unlimited
+    int msaaSamples = 16;           // 0 = off, clamped to what the GL supports
+    bool vsync = true;
+    LatencyMode latencyMode = LatencyMode::Normal;
+    bool renderOnDemand = false;    // sleep until input while nothing changes
+    float textureLodBias = 0.0f;    // added to the mip level model textures sample
+    float pointBudgetM = 3.0f;      // point clouds: millions of points drawn per frame
+    float pointSize = 1.0f;         // point clouds: splat size relative to the point spacing
+
     std::string filePath;
 
+    // runtime only: set by the app, empty when the GL can't sample BC1/BC3
+    std::string textureCacheDir;
+
+    // Settings file format version written by save(). Version 1 was a flat object; version 2
+    // moves the performance keys into a "performance" object (flat keys are still read).
+    static constexpr int schemaVersion = 2;
+
+    // false when the file is missing or not valid JSON (fields then keep their values)
     bool load();
     bool save();
 
+    // loader knobs derived from the current settings
+    LoadOptions loadOptions() const;
+
     static std::string controlSchemeToString(ControlScheme s);
     static ControlScheme controlSchemeFromString(const std::string& s);
+    static std::string flatShadingToString(FlatShading f);
+    static FlatShading flatShadingFromString(const std::string& s);
+    static std::string threadPriorityToString(ThreadPriority p);
+    static ThreadPriority threadPriorityFromString(const std::string& s);
+    static std::string latencyModeToString(LatencyMode m);
+    static LatencyMode latencyModeFromString(const std::string& s);
 };
@@ -0,0 +1,222 @@
+// viewports.cpp
+// Implements the view layout, frustum helpers and batch bounds declared in viewports.h
+
+#include "viewports.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "threadpool.h"
+
+const char* view_kind_name(ViewKind kind) {
+    switch (kind) {
+    case ViewKind::Top: return "Top";
+    case ViewKind::Front: return "Front";
+    case ViewKind::Side: return "Side";
+    case ViewKind::Perspective: return "Perspective";
+    }
+    return "?";
+}
+
+Frustum frustum_from_matrix(const glm::mat4& m) {
+    const glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    const glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    const glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    const glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+    Frustum f;
+    f.planes[0] = row3 + row0; f.planes[1] = row3 - row0;
+    f.planes[2] = row3 + row1; f.planes[3] = row3 - row1;
+    f.planes[4] = row3 + row2; f.planes[5] = row3 - row2;
+    return f;
+}
+
+bool frustum_overlaps_box(const Frustum& frustum, const glm::vec3& lo, const glm::vec3& hi) {
+    const glm::vec3 c = (lo + hi) * 0.5f;
+    const glm::vec3 h = (hi - lo) * 0.5f;
+    for (const glm::vec4& p : frustum.planes) {
+        const float d = p.x * c.x + p.y * c.y + p.z * c.z + p.w;
+        const float r = h.x * std::abs(p.x) + h.y * std::abs(p.y) + h.z * std::abs(p.z);
+        if (d < -r) return false;
+    }
+    return true;
+}
+
+void compute_batch_bounds(const float* verts, size_t stride, const unsigned int* indices, std::vector<DrawBatch>& batches) {
+    globalThreadPool().parallel_for(0, batches.size(), 1, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            DrawBatch& db = batches[i];
+            glm::vec3 lo(std::numeric_limits<float>::max()), hi(-std::numeric_limits<float>::max());
+            for (size_t k = db.firstIndex; k < db.firstIndex + (size_t)db.indexCount; ++k) {
+                const float* p = verts + size_t(indices[k]) * stride;
+                lo = glm::min(lo, glm::vec3(p[0], p[1], p[2]));
+                hi = glm::max(hi, glm::vec3(p[0], p[1], p[2]));
+            }
+            db.hasBounds = db.indexCount > 0;
+            db.boundsMin = lo;
+            db.boundsMax = hi;
+        }
+    });
+}
+
+uint64_t view_key_mix(uint64_t key, const void* data, size_t bytes) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < bytes; ++i) {
+        key ^= p[i];
+        key *= 1099511628211ull;
+    }
+    return key;
+}
+
+void ViewLayout::update(bool quad, int fbWidth, int fbHeight, const OrbitView& orbit) {
+    if (quad != quad_ || fbWidth != fbWidth_ || fbHeight != fbHeight_) {
+        for (Cache& cache : caches_) cache.valid = false;
+    }
+    quad_ = quad;
+    count_ = quad ? 4 : 1;
+    stats_.redrawn = 0;
+    fbWidth_ = fbWidth;
+    fbHeight_ = fbHeight;
+
+    // orthographic views show what the perspective view shows at the target's depth
+    const float distance = std::max(glm::length(orbit.eye - orbit.target), 1e-3f);
+    const auto place = [&](ViewCamera& c, ViewKind kind, int x, int y, int w, int h) {
+        c.kind = kind;
+        c.x = x; c.y = y; c.width = std::max(1, w); c.height = std::max(1, h);
+        const float aspect = float(c.width) / float(c.height);
+        if (kind == ViewKind::Perspective) {
+            c.orthographic = false;
+            c.halfHeight = 0.0f;
+            c.eye = orbit.eye;
+            c.view = glm::lookAt(orbit.eye, orbit.target, glm::vec3(0, 1, 0));
+            c.proj = glm::perspective(orbit.fovY, aspect, orbit.nearPlane, orbit.farPlane);
+        } else {
+            glm::vec3 axis(0, 1, 0), up(0, 0, -1);  // top: looking down, -z up the screen
+            if (kind == ViewKind::Front) { axis = glm::vec3(0, 0, 1); up = glm::vec3(0, 1, 0); }
+            if (kind == ViewKind::Side) { axis = glm::vec3(1, 0, 0); up = glm::vec3(0, 1, 0); }
+            c.orthographic = true;
+            c.halfHeight = distance * std::tan(orbit.fovY * 0.5f);
+            c.eye = orbit.target + axis * (orbit.farPlane * 0.5f);
+            c.view = glm::lookAt(c.eye, orbit.target, up);
+            c.proj = glm::ortho(-c.halfHeight * aspect, c.halfHeight * aspect, -c.halfHeight, c.halfHeight,
+                                orbit.nearPlane, orbit.farPlane);
+        }
+        c.viewProj = c.proj * c.view;
+        c.pixelsPerUnit = c.proj[1][1] * float(c.height) * 0.5f;
+        c.frustum = frustum_from_matrix(c.viewProj);
+    };
+    if (!quad) {
+        place(cameras_[0], ViewKind::Perspective, 0, 0, fbWidth, fbHeight);
+        return;
+    }
+    const int halfW = fbWidth / 2, halfH = fbHeight / 2;
+    place(cameras_[0], ViewKind::Top, 0, halfH, halfW, fbHeight - halfH);
+    place(cameras_[1], ViewKind::Front, halfW, halfH, fbWidth - halfW, fbHeight - halfH);
+    place(cameras_[2], ViewKind::Side, 0, 0, halfW, halfH);
+    place(cameras_[3], ViewKind::Perspective, halfW, 0, fbWidth - halfW, halfH);
+}
+
+int ViewLayout::viewAt(double x, double y) const {
+    if (!quad_) return -1;
+    const double glY = double(fbHeight_) - y;
+    for (size_t v = 0; v < count_; ++v) {
+        const ViewCamera& c = cameras_[v];
+        if (x >= c.x && x < c.x + c.width && glY >= c.y && glY < c.y + c.height) return (int)v;
+    }
+    return -1;
+}
+
+// one pass over the batches tests each against every view's frustum and keeps a bit per view,
+// batches in parallel; the per-view lists are then filled in batch order
+void ViewLayout::cull(const std::vector<DrawBatch>& batches) {
+    stats_.views = (unsigned)count_;
+    stats_.batches = batches.size();
+    masks_.resize(batches.size());
+    globalThreadPool().parallel_for(0, batches.size(), 256, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            const DrawBatch& db = batches[i];
+            uint8_t mask = 0;
+            for (size_t v = 0; v < count_; ++v) {
+                if (!db.hasBounds || frustum_overlaps_box(cameras_[v].frustum, db.boundsMin, db.boundsMax)) mask |= uint8_t(1u << v);
+            }
+            masks_[i] = mask;
+        }
+    });
+    for (size_t v = 0; v < count_; ++v) visible_[v].clear();
+    stats_.sharedBatches = 0;
+    for (size_t i = 0; i < batches.size(); ++i) {
+        const uint8_t mask = masks_[i];
+        if (!mask) continue;
+        ++stats_.sharedBatches;
+        for (size_t v = 0; v < count_; ++v) {
+            if (mask & (1u << v)) visible_[v].push_back(batches[i]);
+        }
+    }
+    for (size_t v = 0; v < count_; ++v) stats_.viewBatches[v] = visible_[v].size();
+}
+
+bool ViewLayout::beginView(size_t view, uint64_t sceneKey) {
+    const ViewCamera& c = cameras_[view];
+    Cache& cache = caches_[view];
+    uint64_t key = view_key_mix(sceneKey, &c.viewProj, sizeof(c.viewProj));
+    const int rect[4] = { c.x, c.y, c.width, c.height };
+    key = view_key_mix(key, rect, sizeof(rect));
+    cache.drawn = !quad_ || view == active_ || !cache.valid || cache.key != key;
+    cache.key = key;
+    if (!cache.drawn) return false;
+    ++stats_.redrawn;
+    glViewport(c.x, c.y, c.width, c.height);
+    if (quad_) {
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(c.x, c.y, c.width, c.height);
+    }
+    return true;
+}
+
+void ViewLayout::endViews() {
+    if (quad_) glDisable(GL_SCISSOR_TEST);
+    glViewport(0, 0, fbWidth_, fbHeight_);
+}
+
+// drawn views are copied out of the window framebuffer, the others copied back into it
+void ViewLayout::finishFrame() {
+    if (!quad_) return;
+    for (size_t v = 0; v < count_; ++v) {
+        const ViewCamera& c = cameras_[v];
+        Cache& cache = caches_[v];
+        if (cache.drawn) {
+            if (!cache.fbo || cache.width != c.width || cache.height != c.height) {
+                if (!cache.tex) glGenTextures(1, &cache.tex);
+                glBindTexture(GL_TEXTURE_2D, cache.tex);
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, c.width, c.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                glBindTexture(GL_TEXTURE_2D, 0);
+                if (!cache.fbo) glGenFramebuffers(1, &cache.fbo);
+                glBindFramebuffer(GL_FRAMEBUFFER, cache.fbo);
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, cache.tex, 0);
+                cache.width = c.width;
+                cache.height = c.height;
+            }
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, cache.fbo);
+            glBlitFramebuffer(c.x, c.y, c.x + c.width, c.y + c.height, 0, 0, c.width, c.height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            cache.valid = true;
+        } else {
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, cache.fbo);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+            glBlitFramebuffer(0, 0, c.width, c.height, c.x, c.y, c.x + c.width, c.y + c.height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void ViewLayout::release() {
+    for (Cache& cache : caches_) {
+        if (cache.fbo) glDeleteFramebuffers(1, &cache.fbo);
+        if (cache.tex) glDeleteTextures(1, &cache.tex);
+        cache = Cache{};
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+// viewports.h
+// Single or quad (top / front / side / perspective) layout of the scene, batch culling shared by
+// the views, and cached copies of views that did not change since they were last drawn.
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "renderer.h"
+
+enum class ViewKind { Top, Front, Side, Perspective };
+
+const char* view_kind_name(ViewKind kind);
+
+// Planes from the rows of a view-projection matrix, unnormalised: inside where dot(plane, p) >= 0
+struct Frustum {
+    glm::vec4 planes[6];
+};
+
+Frustum frustum_from_matrix(const glm::mat4& viewProj);
+bool frustum_overlaps_box(const Frustum& frustum, const glm::vec3& lo, const glm::vec3& hi);
+
+// bounds of each batch's triangles (boundsMin/boundsMax), batches in parallel on the global pool;
+// verts has `stride` floats per vertex, position first
+void compute_batch_bounds(const float* verts, size_t stride, const unsigned int* indices, std::vector<DrawBatch>& batches);
+
+// FNV-1a over raw bytes, for the keys deciding whether a cached view is still current
+uint64_t view_key_mix(uint64_t key, const void* data, size_t bytes);
+static const uint64_t kViewKeySeed = 1469598103934665603ull;
+
+// The orbit camera of the perspective view; the orthographic views share its target and zoom
+struct OrbitView {
+    glm::vec3 eye = glm::vec3(0.0f);
+    glm::vec3 target = glm::vec3(0.0f);
+    float fovY = 0.0f;          // radians
+    float nearPlane = 0.01f, farPlane = 1000.0f;
+};
+
+struct ViewCamera {
+    ViewKind kind = ViewKind::Perspective;
+    int x = 0, y = 0, width = 0, height = 0;   // framebuffer pixels, origin bottom left
+    glm::mat4 view = glm::mat4(1.0f), proj = glm::mat4(1.0f), viewProj = glm::mat4(1.0f);
+    glm::vec3 eye = glm::vec3(0.0f);           // orthographic: far out along the view axis
+    bool orthographic = false;
+    float halfHeight = 0.0f;    // orthographic: world units from the centre to the top edge
+    float pixelsPerUnit = 0.0f; // proj[1][1] * height / 2: at distance 1 (perspective) or anywhere
+    Frustum frustum;
+};
+
+struct ViewLayoutStats {
+    unsigned views = 1;
+    unsigned redrawn = 1;       // views drawn this frame, the others were copied from their cache
+    size_t batches = 0;         // model batches
+    size_t sharedBatches = 0;   // visible in at least one view
+    size_t viewBatches[4] = {}; // drawn per view
+};
+
+// Per frame: update() places the cameras, cull() tests the model batches against every view's
+// frustum in a single pass and splits them into per-view lists, and beginView() tells which
+// views to draw. The active view (the one last dragged or zoomed in) draws every frame; the others
+// only when the scene key or their camera changed, otherwise finishFrame() copies their last image
+// back after the resolve. Main thread, GL context current.
+class ViewLayout {
+public:
+    ViewLayout() = default;
+    ~ViewLayout() = default;
+    ViewLayout(const ViewLayout&) = delete;
+    ViewLayout& operator=(const ViewLayout&) = delete;
+
+    void update(bool quad, int fbWidth, int fbHeight, const OrbitView& orbit);
+
+    bool quad() const { return quad_; }
+    size_t count() const { return count_; }
+    const ViewCamera& camera(size_t view) const { return cameras_[view]; }
+
+    // framebuffer position, y down like the cursor; -1 when the layout is a single view
+    int viewAt(double x, double y) const;
+    size_t active() const { return active_; }
+    void setActive(size_t view) { active_ = view < 4 ? view : 3; }
+
+    void cull(const std::vector<DrawBatch>& batches);
+    const std::vector<DrawBatch>& batches(size_t view) const { return visible_[view]; }
+
+    // true: draw the view now (viewport and scissor are set); sceneKey covers everything but the camera
+    bool beginView(size_t view, uint64_t sceneKey);
+    // full viewport again, scissor off
+    void endViews();
+    // after SceneTarget::resolve, window framebuffer bound
+    void finishFrame();
+
+    const ViewLayoutStats& stats() const { return stats_; }
+
+    void release();
+
+private:
+    struct Cache {
+        GLuint fbo = 0, tex = 0;
+        int width = 0, height = 0;
+        uint64_t key = 0;
+        bool valid = false;
+        bool drawn = false;     // this frame
+    };
+
+    bool quad_ = false;
+    size_t count_ = 1;
+    int fbWidth_ = 0, fbHeight_ = 0;
+    size_t active_ = 3;         // perspective
+    ViewCamera cameras_[4];
+    std::vector<DrawBatch> visible_[4];
+    std::vector<uint8_t> masks_;   // per batch, bit v: visible in view v
+    Cache caches_[4];
+    ViewLayoutStats stats_;
+};